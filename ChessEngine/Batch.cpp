@@ -0,0 +1,231 @@
+#include "Batch.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include "Epd.h"
+#include "MappedFile.h"
+#include "Position.h"
+#include "TranspositionTable.h"
+#include "Uci.h"
+
+// Batch.cpp - Analysis of the positions of an EPD or FEN file on all cores
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// and pointer arithmetic warnings (26481). Thread and line
+// indices are below their vector sizes by construction
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+#pragma warning(disable: 26481)
+
+namespace chess::batch {
+
+	namespace {
+		// Consecutive lines dealt to a thread at a time; results in input order wait for at most
+		// about one chunk per thread
+		constexpr size_t CHUNK_LINES = 16;
+
+		struct Line {
+			size_t number;          // 1-based line number in the file
+			std::string_view text;  // Points into the mapping
+		};
+
+		// Position lines of the mapped file, without line ends
+		std::vector<Line> splitLines(const MappedFile& file) {
+			std::vector<Line> lines;
+			const std::string_view data(reinterpret_cast<const char*>(file.data()), file.size());
+			size_t number = 0;
+			for (size_t start = 0; start < data.size();) {
+				const size_t end = std::min(data.find('\n', start), data.size());
+				std::string_view text = data.substr(start, end - start);
+				start = end + 1;
+				++number;
+				while (!text.empty() && (text.back() == '\r' || text.back() == ' ' || text.back() == '\t'))
+					text.remove_suffix(1);
+				const size_t first = text.find_first_not_of(" \t");
+				if (first != std::string_view::npos && text[first] != '#')
+					lines.push_back({ number, text.substr(first) });
+			}
+			return lines;
+		}
+
+		// Line indices of one thread: the owner takes from the front, idle threads steal from the back,
+		// so a thief takes the work its owner would reach last
+		class WorkQueue {
+		public:
+			void append(const size_t begin, const size_t end) {
+				for (size_t i = begin; i < end; ++i)
+					m_items.push_back(i);
+			}
+
+			bool pop(size_t& index) {
+				const std::scoped_lock lock(m_mutex);
+				if (m_items.empty())
+					return false;
+				index = m_items.front();
+				m_items.pop_front();
+				return true;
+			}
+
+			bool steal(size_t& index) {
+				const std::scoped_lock lock(m_mutex);
+				if (m_items.empty())
+					return false;
+				index = m_items.back();
+				m_items.pop_back();
+				return true;
+			}
+
+		private:
+			std::mutex m_mutex;
+			std::deque<size_t> m_items;
+		};
+
+		// Writes results in input order, holding back those that finish early, or at once when tagged
+		class ResultWriter {
+		public:
+			ResultWriter(std::ostream& out, const size_t count, const bool tagged)
+				: m_out(out), m_tagged(tagged), m_results(tagged ? 0 : count), m_ready(tagged ? 0 : count) {}
+
+			void submit(const size_t index, std::string result) {
+				const std::scoped_lock lock(m_mutex);
+				if (m_tagged) {
+					m_out << result << '\n';
+					return;
+				}
+				m_results[index] = std::move(result);
+				m_ready[index] = true;
+				for (; m_next < m_results.size() && m_ready[m_next]; ++m_next) {
+					m_out << m_results[m_next] << '\n';
+					std::string().swap(m_results[m_next]);
+				}
+			}
+
+		private:
+			std::ostream& m_out;
+			const bool m_tagged;
+			std::mutex m_mutex;
+			std::vector<std::string> m_results;
+			std::vector<bool> m_ready;
+			size_t m_next = 0;
+		};
+
+		std::string analyse(search::Searcher& searcher, const Line& line, const search::Limits& limits, ThreadStats& stats, bool& valid) {
+			epd::Record record;
+			valid = epd::parse(line.text, record);
+			if (!valid)
+				return std::string(line.text) + ";error invalid position";
+
+			Position pos;
+			pos.set(record.fen);
+			const auto start = std::chrono::steady_clock::now();
+			const search::Result result = searcher.think(pos, limits);
+			const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			stats.busySeconds += seconds;
+			stats.nodes += result.nodes;
+			++stats.positions;
+
+			char buffer[16];
+			std::string text = record.fen + ";bestmove ";
+			if (result.bestMove)
+				result.bestMove.format(buffer);
+			text += result.bestMove ? buffer : "(none)";
+			uci::formatScore(result.score, buffer);
+			text.append(";score ").append(buffer)
+				.append(";depth ").append(std::to_string(result.depth))
+				.append(";nodes ").append(std::to_string(result.nodes))
+				.append(";time ").append(std::to_string(static_cast<int64_t>(seconds * 1000.0)))
+				.append(";pv");
+			if (result.bestMove)
+				for (const Move m : searcher.rootMoves()[0].pv) {
+					m.format(buffer);
+					text.append(" ").append(buffer);
+				}
+			if (const std::string* id = record.operation("id"))
+				text.append(";id ").append(*id);
+			return text;
+		}
+	}
+
+	bool run(const std::string& inputPath, std::ostream& out, const Options& options, Summary& summary) {
+		MappedFile file;
+		if (!file.open(inputPath))
+			return false;
+		file.adviseSequential();
+		const std::vector<Line> lines = splitLines(file);
+
+		// Chunks of consecutive lines dealt round the threads, so a thread's transposition table sees
+		// related positions while all threads work near the next line to write
+		const size_t threadCount = static_cast<size_t>(std::max(options.threads, 1));
+		std::vector<WorkQueue> queues(threadCount);
+		for (size_t begin = 0; begin < lines.size(); begin += CHUNK_LINES)
+			queues[begin / CHUNK_LINES % threadCount].append(begin, std::min(begin + CHUNK_LINES, lines.size()));
+
+		ResultWriter writer(out, lines.size(), options.tagged);
+		summary = Summary{};
+		summary.threads.resize(threadCount);
+		std::vector<size_t> invalid(threadCount, 0);
+
+		const auto start = std::chrono::steady_clock::now();
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < threadCount; ++t)
+			threads.emplace_back([&, t] {
+				TranspositionTable tt;
+				tt.resize(options.hashMb);
+				const auto searcher = std::make_unique<search::Searcher>(tt);
+				searcher->setSilent(true);
+				ThreadStats& stats = summary.threads[t];
+
+				size_t index = 0;
+				while (true) {
+					// Nothing is queued after the start, so once every queue is empty the work is done
+					if (!queues[t].pop(index)) {
+						bool stolen = false;
+						for (size_t k = 1; k < threadCount && !stolen; ++k)
+							stolen = queues[(t + k) % threadCount].steal(index);
+						if (!stolen)
+							break;
+						++stats.steals;
+					}
+					const Line& line = lines[index];
+					bool valid = true;
+					std::string result = analyse(*searcher, line, options.limits, stats, valid);
+					invalid[t] += !valid;
+					if (options.tagged)
+						result = std::to_string(line.number) + ';' + result;
+					writer.submit(index, std::move(result));
+				}
+			});
+		for (std::thread& thread : threads)
+			thread.join();
+		out.flush();
+
+		summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		for (size_t t = 0; t < threadCount; ++t) {
+			summary.positions += summary.threads[t].positions;
+			summary.nodes += summary.threads[t].nodes;
+			summary.invalid += invalid[t];
+		}
+		return true;
+	}
+
+	void printSummary(const Summary& summary, std::ostream& out) {
+		const double seconds = std::max(summary.seconds, 1e-9);
+		out << summary.positions << " positions (" << summary.invalid << " invalid lines) in " << std::fixed
+			<< std::setprecision(2) << summary.seconds << " s: " << std::setprecision(1) << summary.positionsPerSecond()
+			<< " positions/s, " << static_cast<uint64_t>(static_cast<double>(summary.nodes) / seconds) << " nodes/s\n"
+			<< "thread  positions     steals  utilisation\n";
+		for (size_t t = 0; t < summary.threads.size(); ++t) {
+			const ThreadStats& stats = summary.threads[t];
+			out << std::setw(6) << t << std::setw(11) << stats.positions << std::setw(11) << stats.steals
+				<< std::setw(12) << std::setprecision(1) << 100.0 * stats.busySeconds / seconds << "%\n";
+		}
+	}
+}
+#pragma warning(pop)
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Search.h"
+
+// Batch.h - Analysis of the positions of an EPD or FEN file on all cores
+
+namespace chess::batch {
+
+	struct Options {
+		search::Limits limits;  // Budget of every position, one of depth, nodes or moveTime must be set
+		int threads = 1;
+		size_t hashMb = 16;     // Transposition table of each thread, kept from one position to the next
+		bool tagged = false;    // Results as they finish, led by the line number, instead of in input order
+	};
+
+	struct ThreadStats {
+		uint64_t positions = 0;
+		uint64_t steals = 0;    // Positions taken from the queues of other threads
+		uint64_t nodes = 0;
+		double busySeconds = 0.0;
+	};
+
+	struct Summary {
+		size_t positions = 0;   // Positions analysed
+		size_t invalid = 0;     // Lines without a valid position, reported as errors
+		uint64_t nodes = 0;
+		double seconds = 0.0;
+		std::vector<ThreadStats> threads;
+
+		[[nodiscard]] double positionsPerSecond() const {
+			return seconds > 0.0 ? static_cast<double>(positions) / seconds : 0.0;
+		}
+	};
+
+	// Maps the file and analyses every position line (blank lines and '#' comments are skipped) on a
+	// work-stealing pool: chunks of consecutive lines are dealt round the threads' queues, and a thread
+	// steals from the back of the others once its own runs dry. One line per position is written to out:
+	// "<fen>;bestmove <move>;score cp|mate <x>;depth <d>;nodes <n>;time <ms>;pv <moves>[;id <id>]",
+	// or "<line>;error invalid position". False if the file cannot be mapped
+	bool run(const std::string& inputPath, std::ostream& out, const Options& options, Summary& summary);
+
+	// Prints positions and nodes per second and the share of the time each thread spent searching
+	void printSummary(const Summary& summary, std::ostream& out);
+}
@@ -0,0 +1,632 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include "Binpack.h"
+#include "Evaluate.h"
+#include "MoveGen.h"
+#include "MoveList.h"
+#include "Nnue.h"
+#include "Position.h"
+#include "Tablebases.h"
+#include "ThreadPool.h"
+#include "TranspositionTable.h"
+#include "UciEngine.h"
+
+// Benchmark.cpp - Micro benchmarks for performance sensitive components
+
+namespace chess::benchmark {
+
+	const std::vector<std::string> BENCH_FENS = {
+		"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11",
+		"4rrk1/pp1n3p/3q2pQ/2p1pb2/2PP4/2P3N1/P2B2PP/4RRK1 b - - 7 19",
+		"rq3rk1/ppp2ppp/1bnpb3/3N2B1/3NP3/7P/PPPQ1PP1/2KR3R w - - 7 14",
+		"r1bq1r1k/1pp1n1pp/1p1p4/4p2Q/4Pp2/1BNP4/PPP2PPP/3R1RK1 w - - 2 14",
+		"r3r1k1/2p2ppp/p1p1bn2/8/1q2P3/2NPQN2/PPP3PP/R4RK1 b - - 2 15",
+		"r1bbk1nr/pp3p1p/2n5/1N4p1/2Np1B2/8/PPP2PPP/2KR1B1R w kq - 0 13",
+		"r1bq1rk1/ppp1nppp/4n3/3p3Q/3P4/1BP1B3/PP1N2PP/R4RK1 w - - 1 16",
+		"4r1k1/r1q2ppp/ppp2n2/4P3/5Rb1/1N1BQ3/PPP3PP/R5K1 w - - 1 17",
+		"2rqkb1r/ppp2p2/2npb1p1/1N1Nn2p/2P1PP2/8/PP2B1PP/R1BQK2R b KQ - 0 11",
+		"r1bq1r1k/b1p1npp1/p2p3p/1p6/3PP3/1B2NN2/PP3PPP/R2Q1RK1 w - - 1 16",
+		"3r1rk1/p5pp/bpp1pp2/8/q1PP1P2/b3P3/P2NQRPP/1R2B1K1 b - - 6 22",
+		"r1q2rk1/2p1bppp/2Pp4/p6b/Q1PNp3/4B3/PP1R1PPP/2K4R w - - 2 18",
+		"8/8/2k5/p1p5/P1P1K3/8/8/8 w - - 0 1",
+		"6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/8 b - - 3 54"
+	};
+
+	const std::vector<std::string> SIGNATURE_FENS = {
+		// Openings and middlegames
+		"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+		"4rrk1/pp1n3p/3q2pQ/2p1pb2/2PP4/2P3N1/P2B2PP/4RRK1 b - - 7 19",
+		"rq3rk1/ppp2ppp/1bnpb3/3N2B1/3NP3/7P/PPPQ1PP1/2KR3R w - - 7 14",
+		"r1bq1r1k/1pp1n1pp/1p1p4/4p2Q/4Pp2/1BNP4/PPP2PPP/3R1RK1 w - - 2 14",
+		"r3r1k1/2p2ppp/p1p1bn2/8/1q2P3/2NPQN2/PPP3PP/R4RK1 b - - 2 15",
+		"r1bbk1nr/pp3p1p/2n5/1N4p1/2Np1B2/8/PPP2PPP/2KR1B1R w kq - 0 13",
+		"r1bq1rk1/ppp1nppp/4n3/3p3Q/3P4/1BP1B3/PP1N2PP/R4RK1 w - - 1 16",
+		"4r1k1/r1q2ppp/ppp2n2/4P3/5Rb1/1N1BQ3/PPP3PP/R5K1 w - - 1 17",
+		"2rqkb1r/ppp2p2/2npb1p1/1N1Nn2p/2P1PP2/8/PP2B1PP/R1BQK2R b KQ - 0 11",
+		"r1bq1r1k/b1p1npp1/p2p3p/1p6/3PP3/1B2NN2/PP3PPP/R2Q1RK1 w - - 1 16",
+		"3r1rk1/p5pp/bpp1pp2/8/q1PP1P2/b3P3/P2NQRPP/1R2B1K1 b - - 6 22",
+		"r1q2rk1/2p1bppp/2Pp4/p6b/Q1PNp3/4B3/PP1R1PPP/2K4R w - - 2 18",
+		"4k2r/1pb2ppp/1p2p3/1R1p4/3P4/2r1PN2/P4PPP/1R4K1 b - - 3 22",
+		"3q2k1/pb3p1p/4pbp1/2r5/PpN2N2/1P2P2P/5PP1/Q2R2K1 b - - 4 26",
+		"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+		"r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+		"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+		"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+		"rnbqkb1r/pp1p1ppp/2p5/4P3/2B5/8/PPP1NnPP/RNBQK2R w KQkq - 0 6",
+		"6k1/3b3r/1p1p4/p1n2p2/1PPNpP1q/P3Q1p1/1R1RB1P1/5K2 b - - 0 1",
+		"r2r1n2/pp2bk2/2p1p2p/3q4/3PN1QP/2P3R1/P4PP1/5RK1 w - - 0 1",
+		"r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1",
+		"r3k2r/8/3Q4/8/8/5q2/8/R3K2R b KQkq - 0 1",
+		// Endgames
+		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11",
+		"8/8/2k5/p1p5/P1P1K3/8/8/8 w - - 0 1",
+		"6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/8 b - - 3 54",
+		"8/8/8/8/5kp1/P7/8/1K1N4 w - - 0 1",
+		"8/8/8/5N2/8/p7/8/2NK3k w - - 0 1",
+		"8/3k4/8/8/8/4B3/4KB2/2B5 w - - 0 1",
+		"8/8/1P6/5pr1/8/4R3/7k/2K5 w - - 0 1",
+		"8/2p4P/8/kr6/6R1/8/8/1K6 w - - 0 1",
+		"8/8/3P3k/8/1p6/8/1P6/1K3n2 b - - 0 1",
+		"8/R7/2q5/8/6k1/8/1P5p/K6R w - - 0 124",
+		"8/8/8/8/8/6k1/6p1/6K1 w - - 0 1",
+		"7k/7P/6K1/8/3B4/8/8/8 b - - 0 1",
+		"8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1",
+		"8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1",
+		"5k2/8/8/8/8/8/8/4K2R w K - 0 1",
+		"3k4/8/8/8/8/8/8/R3K3 w Q - 0 1",
+		"2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1",
+		"8/8/1P2K3/8/2n5/1q6/8/5k2 b - - 0 1",
+		"4k3/1P6/8/8/8/8/K7/8 w - - 0 1",
+		"8/P1k5/K7/8/8/8/8/8 w - - 0 1",
+		"K1k5/8/P7/8/8/8/8/8 w - - 0 1",
+		"8/k1P5/8/1K6/8/8/8/8 w - - 0 1",
+		"8/8/2k5/5q2/5n2/8/5K2/8 b - - 0 1",
+		"8/5k2/8/5N2/5Q2/2K5/8/8 w - - 0 1",
+		"1k6/1b6/8/8/7R/8/8/4K2R b K - 0 1",
+		"6k1/5p2/6p1/8/7p/8/6PP/6K1 b - - 0 1"
+	};
+
+	namespace {
+
+		// Deterministic stand-in for history scores, spread over the whole score range
+		int pseudoScore(const Move m) {
+			uint32_t h = m.raw() * 2654435761u;
+			h ^= h >> 15;
+			return static_cast<int>(h % 20001) - 10000;
+		}
+
+		// Collects move lists from the benchmark positions and all their children
+		std::vector<MoveList> collectMoveLists() {
+			std::vector<MoveList> lists;
+			for (const std::string& fen : BENCH_FENS) {
+				Position pos;
+				pos.set(fen);
+				MoveList root;
+				generate<LEGAL>(pos, root);
+				lists.push_back(root);
+				for (const ScoredMove& sm : root) {
+					StateInfo st;
+					pos.doMove(sm.move(), st);
+					MoveList child;
+					generate<LEGAL>(pos, child);
+					if (!child.empty())
+						lists.push_back(child);
+					pos.undoMove(sm.move());
+				}
+			}
+			for (MoveList& list : lists)
+				list.score(0, pseudoScore);
+			return lists;
+		}
+
+		// Runs fn over all lists for the given iterations and returns nanoseconds per list
+		template<typename Fn>
+		double timePerList(const std::vector<MoveList>& lists, const int iterations, Fn&& fn) {
+			const auto start = std::chrono::steady_clock::now();
+			for (int it = 0; it < iterations; ++it)
+				for (const MoveList& list : lists)
+					fn(list);
+			const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+			return elapsed.count() / (static_cast<double>(iterations) * static_cast<double>(lists.size()));
+		}
+
+		// Plays one game from fen and returns white's score (1, 0.5 or 0).
+		// Games are adjudicated as drawn after MAX_GAME_LENGTH plies
+		double playGame(search::ThreadPool& white, search::ThreadPool& black, const std::string& fen, const int64_t moveTime) {
+			Position pos;
+			pos.set(fen);
+			std::deque<StateInfo> states;
+			search::Limits limits;
+			limits.moveTime = moveTime;
+
+			for (int ply = 0; ply < MAX_GAME_LENGTH; ++ply) {
+				MoveList moves;
+				generate<LEGAL>(pos, moves);
+				if (moves.empty())
+					return pos.checkers() ? (pos.sideToMove() == WHITE ? 0.0 : 1.0) : 0.5;
+				if (pos.isDraw(0))
+					return 0.5;
+
+				search::ThreadPool& player = pos.sideToMove() == WHITE ? white : black;
+				const Move m = player.think(pos, limits).bestMove;
+				pos.doMove(m, states.emplace_back());
+			}
+			return 0.5;
+		}
+
+		// Elo difference for a score fraction, clamped for scores of 0 or 1
+		double eloFromScore(const double score) {
+			const double s = std::clamp(score, 0.01, 0.99);
+			return -400.0 * std::log10(1.0 / s - 1.0);
+		}
+	}
+
+	void moveListSorting(const int iterations) {
+		const std::vector<MoveList> lists = collectMoveLists();
+		int totalMoves = 0;
+		for (const MoveList& list : lists)
+			totalMoves += list.size();
+
+		std::cout << "Move lists: " << lists.size() << ", average length: "
+			<< static_cast<double>(totalMoves) / static_cast<double>(lists.size()) << "\n";
+
+		// Accumulate the chosen moves so the work cannot be optimized away
+		uint64_t sink = 0;
+		constexpr int TRIED = 3;  // Most nodes cut off within the first few moves
+
+		const double sortTried = timePerList(lists, iterations, [&](const MoveList& list) {
+			std::vector<std::pair<int, Move>> moves;
+			moves.reserve(static_cast<size_t>(list.size()));
+			for (const ScoredMove& sm : list)
+				moves.emplace_back(sm.score(), sm.move());
+			std::sort(moves.begin(), moves.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+			for (int i = 0; i < std::min(TRIED, list.size()); ++i)
+				sink += moves[static_cast<size_t>(i)].second.raw();
+			});
+
+		const double pickTried = timePerList(lists, iterations, [&](const MoveList& list) {
+			MoveList copy = list;
+			for (int i = 0; i < std::min(TRIED, copy.size()); ++i)
+				sink += copy.pickBest(i).raw();
+			});
+
+		const double pickAll = timePerList(lists, iterations, [&](const MoveList& list) {
+			MoveList copy = list;
+			for (int i = 0; i < copy.size(); ++i)
+				sink += copy.pickBest(i).raw();
+			});
+
+		const double partialSort = timePerList(lists, iterations, [&](const MoveList& list) {
+			MoveList copy = list;
+			copy.partialInsertionSort(0, 0);
+			for (int i = 0; i < std::min(TRIED, copy.size()); ++i)
+				sink += copy[i].raw();
+			});
+
+		std::cout << "std::sort on std::vector, first " << TRIED << " moves: " << sortTried << " ns/list\n"
+			<< "MoveList pickBest, first " << TRIED << " moves:        " << pickTried << " ns/list\n"
+			<< "MoveList pickBest, all moves:             " << pickAll << " ns/list\n"
+			<< "MoveList partialInsertionSort (score>=0): " << partialSort << " ns/list\n"
+			<< "(checksum " << sink << ")\n";
+	}
+
+	void searchPruning(const int depth) {
+		const search::Params all;
+		search::Params none = all;
+		none.nullMove = none.lateMoveReductions = none.reverseFutility = none.lateMovePruning = false;
+
+		std::vector<std::pair<std::string, search::Params>> configs = { { "all on", all } };
+		configs.emplace_back("no null move", all);
+		configs.back().second.nullMove = false;
+		configs.emplace_back("no late move reductions", all);
+		configs.back().second.lateMoveReductions = false;
+		configs.emplace_back("no reverse futility", all);
+		configs.back().second.reverseFutility = false;
+		configs.emplace_back("no late move pruning", all);
+		configs.back().second.lateMovePruning = false;
+		configs.emplace_back("all off", none);
+
+		std::cout << "Depth " << depth << " on " << BENCH_FENS.size() << " positions\n"
+			<< "configuration                     nodes   vs all on      time ms\n";
+		TranspositionTable tt;
+		tt.resize(16);
+		const auto searcher = std::make_unique<search::Searcher>(tt);
+		searcher->setSilent(true);
+		uint64_t baseNodes = 0;
+		for (const auto& [name, params] : configs) {
+			searcher->setParams(params);
+			search::Limits limits;
+			limits.depth = depth;
+			uint64_t nodes = 0;
+			const auto start = std::chrono::steady_clock::now();
+			for (const std::string& fen : BENCH_FENS) {
+				Position pos;
+				pos.set(fen);
+				tt.clear();
+				nodes += searcher->think(pos, limits).nodes;
+			}
+			const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (!baseNodes)
+				baseNodes = nodes;
+
+			std::cout << std::left << std::setw(25) << name << std::right << std::setw(14) << nodes
+				<< std::setw(11) << std::fixed << std::setprecision(2) << static_cast<double>(nodes) / static_cast<double>(baseNodes)
+				<< std::setw(13) << std::setprecision(0) << ms << "\n";
+		}
+	}
+
+	void multiPV(const int depth, const int lines) {
+		std::cout << "Depth " << depth << " on " << BENCH_FENS.size() << " positions, fresh hash for each\n"
+			<< "MultiPV          nodes   vs MultiPV 1      time ms   same best move\n";
+		TranspositionTable tt;
+		tt.resize(16);
+		const auto searcher = std::make_unique<search::Searcher>(tt);
+		searcher->setSilent(true);
+		uint64_t baseNodes = 0;
+		std::vector<Move> baseMoves;
+		for (const int multiPV : { 1, lines }) {
+			search::Limits limits;
+			limits.depth = depth;
+			limits.multiPV = multiPV;
+			uint64_t nodes = 0;
+			size_t sameMoves = 0;
+			const auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < BENCH_FENS.size(); ++i) {
+				Position pos;
+				pos.set(BENCH_FENS[i]);
+				tt.clear();
+				searcher->clearHistory();
+				const search::Result result = searcher->think(pos, limits);
+				nodes += result.nodes;
+				if (multiPV == 1)
+					baseMoves.push_back(result.bestMove);
+				sameMoves += result.bestMove == baseMoves[i];
+			}
+			const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (!baseNodes)
+				baseNodes = nodes;
+
+			std::cout << std::setw(7) << multiPV << std::setw(15) << nodes
+				<< std::setw(14) << std::fixed << std::setprecision(2) << static_cast<double>(nodes) / static_cast<double>(baseNodes)
+				<< std::setw(13) << std::setprecision(0) << ms
+				<< std::setw(12) << sameMoves << "/" << BENCH_FENS.size() << "\n";
+		}
+	}
+
+	void searchStatistics(const int depth, const int threads) {
+#ifdef SEARCH_STATS
+		TranspositionTable tt;
+		tt.resize(16);
+		search::ThreadPool pool(tt);
+		pool.setThreadCount(threads);
+		pool.setSilent(true);
+		search::Limits limits;
+		limits.depth = depth;
+		for (const std::string& fen : BENCH_FENS) {
+			Position pos;
+			pos.set(fen);
+			tt.clear();
+			pool.clearHistory();
+			pool.think(pos, limits);
+			std::cout << "{\"fen\":\"" << fen << "\",\"stats\":";
+			pool.stats().writeJson(std::cout);
+			std::cout << "}\n";
+		}
+#else
+		(void)depth;
+		(void)threads;
+		std::cout << "Search statistics are not compiled in, build with SEARCH_STATS defined\n";
+#endif
+	}
+
+	void evalCaches(const int depth) {
+		TranspositionTable tt;
+		tt.resize(16);
+		EvalCache evalCache;
+		evalCache.resize(16);
+		const auto searcher = std::make_unique<search::Searcher>(tt);
+		searcher->setSilent(true);
+		searcher->setEvalCache(&evalCache);
+		search::Limits limits;
+		limits.depth = depth;
+		uint64_t nodes = 0;
+		for (const std::string& fen : BENCH_FENS) {
+			Position pos;
+			pos.set(fen);
+			tt.clear();
+			evalCache.clear();
+			nodes += searcher->think(pos, limits).nodes;
+		}
+
+		std::cout << "Depth " << depth << " on " << BENCH_FENS.size() << " positions, " << nodes << " nodes\n"
+			<< "table              probes        hits   hit rate\n";
+		const auto printTable = [](const std::string& name, const auto& table) {
+			std::cout << std::left << std::setw(12) << name << std::right << std::setw(13) << table.probes()
+				<< std::setw(12) << table.hits() << std::setw(10) << std::fixed << std::setprecision(1)
+				<< 100.0 * table.hitRate() << "%\n";
+			};
+		printTable("pawns", searcher->evalCaches().pawns);
+		printTable("material", searcher->evalCaches().material);
+		printTable("evaluation", searcher->evalCaches().evalCacheCounters);
+	}
+
+	void nnueSpeed(const std::string& path, const int rounds) {
+		if (path.empty())
+			nnue::randomize(1);
+		else if (!nnue::load(path)) {
+			std::cout << "Cannot load network " << path << "\n";
+			return;
+		}
+
+		// One random game of up to 32 plies from every benchmark position, replayed for each evaluator
+		std::mt19937 rng(1);
+		std::vector<std::vector<Move>> games;
+		for (const std::string& fen : BENCH_FENS) {
+			Position pos;
+			pos.set(fen);
+			std::vector<StateInfo> states(32);
+			games.emplace_back();
+			for (StateInfo& st : states) {
+				MoveList moves;
+				generate<LEGAL>(pos, moves);
+				if (moves.size() == 0)
+					break;
+				games.back().push_back(moves[static_cast<int>(rng() % moves.size())]);
+				pos.doMove(games.back().back(), st);
+			}
+		}
+
+		eval::Caches caches;
+		const auto measure = [&](const std::string& name, const auto& evaluate) {
+			uint64_t evals = 0;
+			int64_t checksum = 0;
+			const auto start = std::chrono::steady_clock::now();
+			for (int r = 0; r < rounds; ++r)
+				for (size_t g = 0; g < games.size(); ++g) {
+					Position pos;
+					pos.set(BENCH_FENS[g]);
+					std::vector<StateInfo> states(games[g].size());
+					checksum += evaluate(pos);
+					for (size_t i = 0; i < games[g].size(); ++i) {
+						pos.doMove(games[g][i], states[i]);
+						checksum += evaluate(pos);
+					}
+					evals += games[g].size() + 1;
+				}
+			const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			std::cout << std::left << std::setw(14) << name << std::right << std::setw(12) << evals
+				<< std::setw(14) << static_cast<uint64_t>(evals / seconds) << std::setw(16) << checksum << "\n";
+		};
+
+		std::cout << "Network evaluation, " << nnue::simdName() << " build\n"
+			<< "evaluator            evals     evals/sec        checksum\n";
+		measure("incremental", [](const Position& pos) { return nnue::evaluate(pos); });
+		measure("full scalar", [](const Position& pos) { return nnue::evaluateScalar(pos); });
+		nnue::unload();
+		measure("hand-crafted", [&caches](const Position& pos) { return eval::evaluate(pos, caches); });
+	}
+
+	void syzygy(const std::string& path, const int depth) {
+		tablebases::init(path);
+		if (!tablebases::maxCardinality()) {
+			std::cout << "No tablebases found in " << path << "\n";
+			return;
+		}
+
+		// Endgames from three to six pieces, with and without pawns
+		const std::vector<std::string> fens = {
+			"8/8/8/8/4k3/8/8/4K2R w - - 0 1",
+			"8/8/4k3/8/8/3B4/3N4/4K3 w - - 0 1",
+			"8/8/8/3k4/8/8/3PK3/8 w - - 0 1",
+			"8/8/1k6/8/2r5/8/3KP3/3R4 w - - 0 1",
+			"8/5k2/8/8/7q/8/1K6/3Q3R b - - 0 1",
+			"8/3k4/8/1p6/1P2b3/8/3K1N2/4R3 w - - 0 1"
+		};
+
+		TranspositionTable tt;
+		tt.resize(16);
+		const auto searcher = std::make_unique<search::Searcher>(tt);
+		searcher->setSilent(true);
+		search::Limits limits;
+		limits.depth = depth;
+
+		std::cout << "Tablebases up to " << tablebases::maxCardinality() << " pieces, depth " << depth << "\n"
+			<< "position                                  roots   tbhits       nodes  best   score\n";
+		tablebases::clearStats();
+		for (const std::string& fen : fens) {
+			Position pos;
+			pos.set(fen);
+			tt.clear();
+			MoveList legalMoves;
+			generate<LEGAL>(pos, legalMoves);
+			const search::Result result = searcher->think(pos, limits);
+			char moveBuffer[Move::MAX_STRING_LENGTH];
+			result.bestMove.format(moveBuffer);
+			std::cout << std::left << std::setw(40) << fen << std::right << std::setw(4) << searcher->rootMoves().size()
+				<< "/" << std::left << std::setw(3) << legalMoves.size() << std::right << std::setw(7) << result.tbHits
+				<< std::setw(12) << result.nodes << std::setw(6) << moveBuffer << std::setw(8) << result.score << "\n";
+		}
+
+		const tablebases::ProbeStats stats = tablebases::stats();
+		std::cout << "WDL probes " << stats.wdlProbes << ", DTZ probes " << stats.dtzProbes << ", failed " << stats.failures
+			<< ", average " << std::fixed << std::setprecision(2) << stats.averageMicroseconds() << " us per probe\n";
+	}
+
+	void binpackRead(const std::string& path) {
+		binpack::Reader reader;
+		if (!reader.open(path)) {
+			std::cout << "Cannot open " << path << "\n";
+			return;
+		}
+		uint64_t positions = 0;
+		int64_t scoreSum = 0;
+		binpack::Entry entry;
+		const auto start = std::chrono::steady_clock::now();
+		while (reader.next(entry)) {
+			++positions;
+			scoreSum += entry.score + entry.result;
+		}
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << positions << " positions in " << std::fixed << std::setprecision(3) << seconds << " s: "
+			<< std::setprecision(1) << static_cast<double>(positions) / std::max(seconds, 1e-9) / 1e6 << " M positions/s, "
+			<< static_cast<double>(std::filesystem::file_size(path)) / static_cast<double>(std::max<uint64_t>(positions, 1))
+			<< " bytes per position (score checksum " << scoreSum << ")" << (reader.corrupt() ? ", stopped at corrupt data" : "") << "\n";
+	}
+
+	void stopLatency(const int searches, const int threads) {
+		std::ostringstream out;
+		uci::Engine engine(out);
+		engine.pool().setSilent(true);
+		engine.command("setoption name Threads value " + std::to_string(threads));
+
+		std::mt19937 rng(1);
+		for (int i = 0; i < searches; ++i) {
+			engine.command("position fen " + BENCH_FENS[i % BENCH_FENS.size()]);
+			engine.command("go infinite");
+			std::this_thread::sleep_for(std::chrono::milliseconds(10 + rng() % 41));
+			engine.command("stop");
+			engine.waitForSearch();
+		}
+
+		const uci::StopLatency latency = engine.stopLatency();
+		std::cout << "Stop to bestmove over " << latency.count << " searches with " << threads << " threads: average "
+			<< std::fixed << std::setprecision(1) << latency.averageMicroseconds() << " us, max " << latency.maxMicroseconds << " us\n";
+	}
+
+	void smpScaling(const int maxThreads, const int depth, const int games, const int64_t moveTime) {
+		std::vector<int> threadCounts;
+		for (int t = 1; t < maxThreads; t *= 2)
+			threadCounts.push_back(t);
+		threadCounts.push_back(maxThreads);
+
+		// Time to depth, every position starts from an empty table
+		std::cout << "Time to depth " << depth << " on " << BENCH_FENS.size() << " positions\n"
+			<< "threads      time ms     speedup        nodes          nps\n";
+		double baseTime = 0.0;
+		for (const int threads : threadCounts) {
+			TranspositionTable tt;
+			tt.resize(64);
+			search::ThreadPool pool(tt);
+			pool.setThreadCount(threads);
+			pool.setSilent(true);
+
+			search::Limits limits;
+			limits.depth = depth;
+			uint64_t nodes = 0;
+			const auto start = std::chrono::steady_clock::now();
+			for (const std::string& fen : BENCH_FENS) {
+				Position pos;
+				pos.set(fen);
+				tt.clear();
+				nodes += pool.think(pos, limits).nodes;
+			}
+			const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (threads == 1)
+				baseTime = ms;
+
+			std::cout << std::setw(7) << threads << std::setw(13) << std::fixed << std::setprecision(0) << ms
+				<< std::setw(12) << std::setprecision(2) << baseTime / ms << std::setw(13) << nodes
+				<< std::setw(13) << static_cast<uint64_t>(static_cast<double>(nodes) * 1000.0 / std::max(ms, 1.0)) << "\n";
+		}
+
+		if (games <= 0)
+			return;
+
+		// Elo against a single thread, each opening is played with both colors
+		std::cout << "\nElo against 1 thread, " << games << " games at " << moveTime << " ms per move\n"
+			<< "threads       score         elo\n";
+		for (const int threads : threadCounts) {
+			if (threads == 1)
+				continue;
+			TranspositionTable ttMany, ttOne;
+			ttMany.resize(16);
+			ttOne.resize(16);
+			search::ThreadPool many(ttMany), one(ttOne);
+			many.setThreadCount(threads);
+			many.setSilent(true);
+			one.setSilent(true);
+
+			double score = 0.0;
+			for (int g = 0; g < games; ++g) {
+				const std::string& fen = BENCH_FENS[static_cast<size_t>(g / 2) % BENCH_FENS.size()];
+				ttMany.clear();
+				ttOne.clear();
+				score += g % 2 == 0 ? playGame(many, one, fen, moveTime) : 1.0 - playGame(one, many, fen, moveTime);
+			}
+			score /= games;
+			std::cout << std::setw(7) << threads << std::setw(12) << std::setprecision(2) << score
+				<< std::setw(12) << std::setprecision(0) << eloFromScore(score) << "\n";
+		}
+	}
+
+	uint64_t bench(const int depth, const int threads, std::ostream& out) {
+		// Signature run on one thread, every position starts from an empty table and history
+		TranspositionTable tt;
+		tt.resize(16);
+		const auto searcher = std::make_unique<search::Searcher>(tt);
+		searcher->setSilent(true);
+
+		search::Limits limits;
+		limits.depth = depth;
+		uint64_t signature = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < SIGNATURE_FENS.size(); ++i) {
+			Position pos;
+			pos.set(SIGNATURE_FENS[i]);
+			tt.clear();
+			searcher->clearHistory();
+			const uint64_t nodes = searcher->think(pos, limits).nodes;
+			signature += nodes;
+			out << "Position " << std::setw(2) << i + 1 << "/" << SIGNATURE_FENS.size() << std::setw(12) << nodes << "\n";
+		}
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		const auto nps = static_cast<uint64_t>(static_cast<double>(signature) * 1000.0 / std::max(ms, 1.0));
+
+		out << "\nDepth            : " << depth
+			<< "\nTotal time (ms)  : " << static_cast<int64_t>(ms)
+			<< "\nNodes searched   : " << signature
+			<< "\nNodes/second     : " << nps << "\n";
+
+		if (threads <= 1)
+			return signature;
+
+		// Same positions with a thread pool, node counts vary from run to run so only speed is reported
+		search::ThreadPool pool(tt);
+		pool.setThreadCount(threads);
+		pool.setSilent(true);
+		uint64_t poolNodes = 0;
+		const auto poolStart = std::chrono::steady_clock::now();
+		for (const std::string& fen : SIGNATURE_FENS) {
+			Position pos;
+			pos.set(fen);
+			tt.clear();
+			pool.clearHistory();
+			poolNodes += pool.think(pos, limits).nodes;
+		}
+		const double poolMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - poolStart).count();
+		const auto poolNps = static_cast<uint64_t>(static_cast<double>(poolNodes) * 1000.0 / std::max(poolMs, 1.0));
+
+		out << "\nThreads          : " << threads
+			<< "\nTotal time (ms)  : " << static_cast<int64_t>(poolMs)
+			<< "\nNodes searched   : " << poolNodes
+			<< "\nNodes/second     : " << poolNps
+			<< "\nSpeedup          : " << std::fixed << std::setprecision(2) << ms / std::max(poolMs, 1.0)
+			<< "\nNps scaling      : " << static_cast<double>(poolNps) / static_cast<double>(std::max<uint64_t>(nps, 1)) << "\n";
+		return signature;
+	}
+}
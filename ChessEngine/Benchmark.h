@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Benchmark.h - Micro benchmarks for performance sensitive components
+
+namespace chess::benchmark {
+
+	// FEN strings of the positions the benchmarks run on
+	extern const std::vector<std::string> BENCH_FENS;
+
+	// Fixed positions of the bench signature, openings to pawn endgames. Changing them changes the signature
+	extern const std::vector<std::string> SIGNATURE_FENS;
+
+	// Compares MoveList selection against std::sort on move lists generated from real positions
+	void moveListSorting(int iterations = 2000);
+
+	// Fixed-depth search of the benchmark positions with every selective search technique
+	// switched off in turn, reports nodes and time of each configuration
+	void searchPruning(int depth = 9);
+
+	// Fixed-depth search of the benchmark positions with MultiPV 1 and MultiPV lines,
+	// reports the cost of the extra lines in nodes and time
+	void multiPV(int depth = 9, int lines = 5);
+
+	// Searches the benchmark positions and prints the search statistics of each as one line of JSON,
+	// only available in builds with SEARCH_STATS defined
+	void searchStatistics(int depth = 10, int threads = 1);
+
+	// Fixed-depth search of the benchmark positions, reports probes and hit rate of the evaluation hash tables
+	// and of the static evaluation cache
+	void evalCaches(int depth = 10);
+
+	// Evaluations per second of the network, updated incrementally along random games from the benchmark
+	// positions, against full scalar refreshes and the hand-crafted evaluation. Random weights without a file
+	void nnueSpeed(const std::string& path = "", int rounds = 200);
+
+	// Fixed-depth search of endgame positions with the Syzygy tables in path, reports the root filtering,
+	// probes made by the search and the average latency of a probe
+	void syzygy(const std::string& path, int depth = 12);
+
+	// Positions per second of streaming a binpack file, replaying the moves of every chain
+	void binpackRead(const std::string& path);
+
+	// Time from "stop" to "bestmove" of the UCI front-end over infinite searches of the benchmark positions,
+	// each stopped after a random 10 to 50 ms
+	void stopLatency(int searches = 100, int threads = 1);
+
+	// Lazy SMP scaling for 1, 2, 4, ... maxThreads threads: time to reach depth on the benchmark
+	// positions, then the Elo of each thread count from games against one thread at moveTime ms per move
+	void smpScaling(int maxThreads, int depth = 8, int games = 8, int64_t moveTime = 100);
+
+	// Fixed-depth search of the signature positions on one thread with an empty table, prints the nodes of
+	// each, their total as the signature of the search and nodes per second. With more threads the positions
+	// are searched again to report the speedup. Returns the signature
+	uint64_t bench(int depth = 13, int threads = 1, std::ostream& out = std::cout);
+}
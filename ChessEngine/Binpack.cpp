@@ -0,0 +1,132 @@
+#include "Binpack.h"
+#include <algorithm>
+
+// Binpack.cpp - Training data stored as games: a packed start position and the moves played from it
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// and pointer arithmetic warnings (26481). Reads stay within
+// the mapping, checked against its size before each access
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+#pragma warning(disable: 26481)
+
+namespace chess::binpack {
+
+	namespace {
+		void putVarint(uint32_t v, std::vector<uint8_t>& out) {
+			while (v >= 0x80) {
+				out.push_back(static_cast<uint8_t>(v | 0x80));
+				v >>= 7;
+			}
+			out.push_back(static_cast<uint8_t>(v));
+		}
+
+		uint32_t zigzag(const int v) {
+			return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+		}
+
+		int unzigzag(const uint32_t v) {
+			return static_cast<int>(v >> 1) ^ -static_cast<int>(v & 1);
+		}
+	}
+
+	void appendChain(const PackedPosition& start, const std::vector<Move>& moves, const std::vector<Value>& scores,
+		const int whiteResult, std::vector<uint8_t>& out) {
+		const size_t count = std::min({ moves.size(), scores.size(), MAX_CHAIN_MOVES });
+		out.insert(out.end(), start.bytes.begin(), start.bytes.end());
+		out.push_back(static_cast<uint8_t>(static_cast<int8_t>(whiteResult)));
+		out.push_back(static_cast<uint8_t>(count));
+		out.push_back(static_cast<uint8_t>(count >> 8));
+
+		Value previous = 0;
+		for (size_t i = 0; i < count; ++i) {
+			out.push_back(static_cast<uint8_t>(moves[i].raw()));
+			out.push_back(static_cast<uint8_t>(moves[i].raw() >> 8));
+			putVarint(zigzag(scores[i] + previous), out);
+			previous = scores[i];
+		}
+	}
+
+	bool Reader::open(const std::string& path) {
+		m_offset = m_movesLeft = m_moveIndex = 0;
+		m_corrupt = false;
+		m_lastMove = Move::none();
+		if (!m_file.open(path))
+			return false;
+		m_file.adviseSequential();
+		return true;
+	}
+
+	bool Reader::startChain() {
+		if (m_offset + CHAIN_HEADER_SIZE > m_file.size()) {
+			m_corrupt = m_offset != m_file.size();
+			return false;
+		}
+		const uint8_t* p = m_file.data() + m_offset;
+		PackedPosition packed;
+		std::copy(p, p + PackedPosition::SIZE, packed.bytes.begin());
+		p += PackedPosition::SIZE;
+		m_whiteResult = static_cast<int8_t>(p[0]);
+		m_movesLeft = static_cast<size_t>(p[1] | (p[2] << 8));
+		m_offset += CHAIN_HEADER_SIZE;
+		if (!unpack(packed, m_pos) || m_whiteResult < -1 || m_whiteResult > 1) {
+			m_corrupt = true;
+			return false;
+		}
+		if (m_states.size() < m_movesLeft)
+			m_states.resize(m_movesLeft);
+		m_moveIndex = 0;
+		m_lastMove = Move::none();
+		m_lastScore = 0;
+		return true;
+	}
+
+	bool Reader::next(Entry& entry) {
+		if (m_corrupt || !m_file.isOpen())
+			return false;
+
+		// The move of the previous entry leads to this one, empty chains are skipped
+		if (m_lastMove)
+			m_pos.doMove(m_lastMove, m_states[m_moveIndex - 1]);
+		while (!m_movesLeft)
+			if (!startChain())
+				return false;
+
+		const uint8_t* const end = m_file.data() + m_file.size();
+		const uint8_t* p = m_file.data() + m_offset;
+		if (end - p < 3) {
+			m_corrupt = true;
+			return false;
+		}
+		const Move m(static_cast<uint16_t>(p[0] | (p[1] << 8)));
+		p += 2;
+		uint32_t v = 0;
+		for (int shift = 0; shift < 35; shift += 7) {
+			if (p == end) {
+				m_corrupt = true;
+				return false;
+			}
+			const uint8_t byte = *p++;
+			v |= static_cast<uint32_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				break;
+		}
+		if (!m || !m_pos.pseudoLegal(m) || !m_pos.legal(m)) {
+			m_corrupt = true;
+			return false;
+		}
+
+		m_offset = static_cast<size_t>(p - m_file.data());
+		m_lastScore = unzigzag(v) - m_lastScore;
+		m_lastMove = --m_movesLeft ? m : Move::none();
+		++m_moveIndex;
+
+		entry.move = m;
+		entry.score = m_lastScore;
+		entry.result = m_pos.sideToMove() == WHITE ? m_whiteResult : -m_whiteResult;
+		return true;
+	}
+}
+#pragma warning(pop)
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "Move.h"
+#include "PackedPosition.h"
+#include "Position.h"
+#include "Types.h"
+
+// Binpack.h - Training data stored as games: a packed start position and the moves played from it
+
+namespace chess::binpack {
+
+	// A chain is the packed start position, the game result for white (int8: -1, 0 or 1), the number
+	// of moves (uint16, little-endian) and per move its Move::raw() (uint16) and the search score of the
+	// position it was played from. Scores are from the side to move's view, so consecutive ones nearly
+	// cancel: each is stored as the difference to minus the previous score (0 before the first), zigzag
+	// and varint coded. A position then takes about three bytes instead of a packed position's 30
+	constexpr size_t CHAIN_HEADER_SIZE = PackedPosition::SIZE + 3;
+	constexpr size_t MAX_CHAIN_MOVES = 0xFFFF;
+
+	// Appends the chain of a game from the packed start position to out. scores[i] is the score of
+	// the position moves[i] is played from, positions beyond MAX_CHAIN_MOVES are left out
+	void appendChain(const PackedPosition& start, const std::vector<Move>& moves, const std::vector<Value>& scores,
+		int whiteResult, std::vector<uint8_t>& out);
+
+	// A position of the file with the move played from it
+	struct Entry {
+		Move move = Move::none();
+		Value score = VALUE_NONE;
+		int result = 0;  // Game result from the side to move's view
+	};
+
+	// Streams the positions of a file of chains in order, unpacking only the start of each chain and
+	// replaying the moves with doMove. The file is mapped and read front to back
+	class Reader {
+	public:
+		// Maps the file, false if it is missing or empty
+		bool open(const std::string& path);
+		void close() { m_file.close(); }
+
+		// Moves to the next position, false at the end of the file or on malformed data (see corrupt)
+		bool next(Entry& entry);
+
+		// Position of the last entry, valid until the next call
+		[[nodiscard]] const Position& position() const noexcept { return m_pos; }
+
+		// The last next() stopped at data that is not a valid chain
+		[[nodiscard]] bool corrupt() const noexcept { return m_corrupt; }
+
+	private:
+		bool startChain();
+
+		MappedFile m_file;
+		size_t m_offset = 0;
+		bool m_corrupt = false;
+
+		Position m_pos;
+		std::vector<StateInfo> m_states;  // States of the moves replayed in the current chain
+		size_t m_movesLeft = 0;
+		size_t m_moveIndex = 0;
+		Move m_lastMove = Move::none();
+		Value m_lastScore = 0;
+		int m_whiteResult = 0;
+	};
+}
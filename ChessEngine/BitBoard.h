@@ -133,6 +133,61 @@ namespace chess {
 		return gsl::narrow_cast<int>(__popcnt64(board));
 	}
 
+	// Checks if more than one bit is set
+	constexpr bool moreThanOne(const Bitboard board) {
+		return board & (board - 1);
+	}
+
+	// Shifts all squares of a bitboard one step in the given direction (wrapped squares are dropped)
+	template<Direction D>
+	constexpr Bitboard shift(const Bitboard board) {
+		if constexpr (D == NORTH) return board << 8;
+		else if constexpr (D == SOUTH) return board >> 8;
+		else if constexpr (D == EAST) return (board & ~FILE_MASK_H) << 1;
+		else if constexpr (D == WEST) return (board & ~FILE_MASK_A) >> 1;
+		else if constexpr (D == NORTH_EAST) return (board & ~FILE_MASK_H) << 9;
+		else if constexpr (D == NORTH_WEST) return (board & ~FILE_MASK_A) << 7;
+		else if constexpr (D == SOUTH_EAST) return (board & ~FILE_MASK_H) >> 7;
+		else if constexpr (D == SOUTH_WEST) return (board & ~FILE_MASK_A) >> 9;
+		else return 0;
+	}
+
+	// Gets the squares attacked by all pawns of a bitboard for the specified color
+	template<Color C>
+	constexpr Bitboard pawnAttacksBB(const Bitboard pawns) {
+		return C == WHITE ? shift<NORTH_WEST>(pawns) | shift<NORTH_EAST>(pawns)
+			: shift<SOUTH_WEST>(pawns) | shift<SOUTH_EAST>(pawns);
+	}
+
+	// Set-wise fills: smears every set square along its file to the edge of the board
+	constexpr Bitboard northFill(Bitboard board) {
+		board |= board << 8;
+		board |= board << 16;
+		return board | (board << 32);
+	}
+	constexpr Bitboard southFill(Bitboard board) {
+		board |= board >> 8;
+		board |= board >> 16;
+		return board | (board >> 32);
+	}
+	constexpr Bitboard fileFill(const Bitboard board) { return northFill(board) | southFill(board); }
+
+	// Fill towards the promotion rank of color C
+	template<Color C>
+	constexpr Bitboard forwardFill(const Bitboard board) {
+		return C == WHITE ? northFill(board) : southFill(board);
+	}
+
+	// Squares in front of / behind the given pawns of color C on their own files, the pawns excluded
+	template<Color C>
+	constexpr Bitboard frontSpans(const Bitboard pawns) { return forwardFill<C>(shift<pawnPush(C)>(pawns)); }
+	template<Color C>
+	constexpr Bitboard rearSpans(const Bitboard pawns) { return frontSpans<~C>(pawns); }
+
+	// Every square the given pawns of color C attack now or can attack after advancing
+	template<Color C>
+	constexpr Bitboard pawnAttackSpans(const Bitboard pawns) { return forwardFill<C>(pawnAttacksBB<C>(pawns)); }
+
 	// Debug function to print a bitboard
 	void printBitBoard(Bitboard board);
 
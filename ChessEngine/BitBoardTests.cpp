@@ -385,6 +385,22 @@ namespace chess::tests
 		report("Direction calculation", success);
 	}
 
+	// Test set-wise file fills and pawn spans
+	void testFills() {
+		bool success = true;
+
+		success &= (northFill(squareToBB(E4)) == (FILE_MASK_E & ~(RANK_MASK_1 | RANK_MASK_2 | RANK_MASK_3)));
+		success &= (southFill(squareToBB(E4)) == (FILE_MASK_E & (RANK_MASK_1 | RANK_MASK_2 | RANK_MASK_3 | RANK_MASK_4)));
+		success &= (fileFill(squareToBB(A2) | squareToBB(H7)) == (FILE_MASK_A | FILE_MASK_H));
+		success &= (frontSpans<WHITE>(squareToBB(E4)) == (FILE_MASK_E & (RANK_MASK_5 | RANK_MASK_6 | RANK_MASK_7 | RANK_MASK_8)));
+		success &= (frontSpans<BLACK>(squareToBB(E4)) == (FILE_MASK_E & (RANK_MASK_1 | RANK_MASK_2 | RANK_MASK_3)));
+		success &= (rearSpans<WHITE>(squareToBB(E4)) == frontSpans<BLACK>(squareToBB(E4)));
+		success &= (pawnAttackSpans<WHITE>(squareToBB(A6)) == (squareToBB(B7) | squareToBB(B8)));
+		success &= (pawnAttackSpans<BLACK>(squareToBB(H3)) == (squareToBB(G2) | squareToBB(G1)));
+
+		report("Fills and pawn spans", success);
+	}
+
 	void testPrintBitBoard() {
 		// Simple test to ensure function doesn't crash
 		constexpr Bitboard b = squareToBB(E4) | squareToBB(F5) | FILE_MASK_A | RANK_MASK_7;
@@ -409,6 +425,7 @@ namespace chess::tests
 		testMaskBitboards();
 		testInsideBoard();
 		testDirectionCalculation();
+		testFills();
 		testPrintBitBoard();
 
 		std::cout << "\nBitBoard tests completed." << "\n";
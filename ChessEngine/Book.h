@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "Move.h"
+#include "Position.h"
+#include "Types.h"
+
+// Book.h - Polyglot opening books, binary searched in place in a memory-mapped file
+
+namespace chess::book {
+
+	// Number of random keys of the Polyglot hash: 12 pieces x 64 squares, 4 castling rights,
+	// 8 en passant files and the side to move
+	constexpr int RANDOM_KEYS = 781;
+
+	// Polyglot hash of a position with the published keys, so books made by other tools can be read.
+	// Unrelated to Position::key(). En passant counts only when a pawn of the side to move can capture
+	[[nodiscard]] HashKey polyglotKey(const Position& pos);
+
+	// Polyglot move encoding: to file, to rank, from file, from rank in 3 bits each, then the
+	// promotion piece (1 knight to 4 queen). Castling is written as the king taking its rook
+	[[nodiscard]] uint16_t encodeMove(Move m);
+
+	// The legal move of pos with the Polyglot encoding, Move::none() if there is none
+	[[nodiscard]] Move decodeMove(const Position& pos, uint16_t move);
+
+	// A 16-byte book entry, stored big-endian and sorted by key
+	struct Entry {
+		HashKey key = 0;
+		uint16_t move = 0;
+		uint16_t weight = 0;
+		uint32_t learn = 0;
+	};
+
+	// Sorts entries by key and writes them as a book, false if the file cannot be written
+	bool write(const std::string& path, std::vector<Entry> entries);
+
+	struct BookMove {
+		Move move;
+		uint16_t weight;
+	};
+
+	// A book file mapped read-only, so only the pages touched by the binary search are read
+	class Book {
+	public:
+		// Maps the book, false (and closed) if it is missing or not a whole number of entries
+		bool open(const std::string& path);
+		void close() { m_file.close(); }
+
+		[[nodiscard]] bool isOpen() const noexcept { return m_file.isOpen(); }
+		[[nodiscard]] size_t size() const noexcept { return m_file.size() / ENTRY_SIZE; }
+
+		// Legal book moves of pos in file order (heaviest first in books written by Polyglot)
+		[[nodiscard]] std::vector<BookMove> probe(const Position& pos) const;
+
+		// Book move chosen with probability proportional to its weight from a uniform random number,
+		// Move::none() when out of book
+		[[nodiscard]] Move pick(const Position& pos, uint64_t random) const;
+
+	private:
+		static constexpr size_t ENTRY_SIZE = 16;
+
+		[[nodiscard]] Entry entry(size_t index) const;
+
+		MappedFile m_file;
+	};
+}
@@ -0,0 +1,142 @@
+#include "BookTests.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Book.h"
+#include "MoveGen.h"
+#include "Position.h"
+#include "Types.h"
+#include "Uci.h"
+
+// BookTests.cpp - Tests for the Polyglot hash, move encoding and book lookups
+
+namespace chess::tests
+{
+	namespace {
+		// Plays moves in UCI notation from a FEN, states must outlive the position
+		void playMoves(Position& pos, const std::string& fen, const std::vector<std::string>& moves, std::vector<StateInfo>& states) {
+			pos.set(fen);
+			states.resize(moves.size());
+			for (size_t i = 0; i < moves.size(); ++i)
+				pos.doMove(uci::parseMove(pos, moves[i]), states[i]);
+		}
+	}
+
+	// Test that the hash follows transpositions, castling rights and only capturable en passant squares
+	void testPolyglotKey() {
+		bool success = true;
+		Position a;
+		Position b;
+		std::vector<StateInfo> statesA;
+		std::vector<StateInfo> statesB;
+
+		playMoves(a, START_FEN, { "g1f3", "g8f6", "b1c3" }, statesA);
+		playMoves(b, START_FEN, { "b1c3", "g8f6", "g1f3" }, statesB);
+		success &= (book::polyglotKey(a) == book::polyglotKey(b));
+		success &= (book::polyglotKey(a) != a.key());
+
+		// No black pawn can take on e3, so the en passant square does not count
+		playMoves(a, START_FEN, { "e2e4" }, statesA);
+		b.set("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
+		success &= (book::polyglotKey(a) == book::polyglotKey(b));
+		playMoves(a, "rnbqkbnr/ppp1pppp/8/8/3p4/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", { "e2e4" }, statesA);
+		b.set("rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
+		success &= (book::polyglotKey(a) != book::polyglotKey(b));
+
+		a.set("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+		b.set("r3k2r/8/8/8/8/8/8/R3K2R w Kkq - 0 1");
+		success &= (book::polyglotKey(a) != book::polyglotKey(b));
+		b.set("r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1");
+		success &= (book::polyglotKey(a) != book::polyglotKey(b));
+
+		// Published hashes of the Polyglot format: start position, en passant that can be taken and lost castling
+		a.set(START_FEN);
+		success &= book::polyglotKey(a) == 0x463B96181691FC9CULL;
+		a.set("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
+		success &= book::polyglotKey(a) == 0x22A48B5A8E47FF78ULL;
+		a.set("rnbqkbnr/p1pppppp/8/8/P6P/R1p5/1P1PPPP1/1NBQKBNR b Kkq - 0 4");
+		success &= book::polyglotKey(a) == 0x5C3F9B829B279560ULL;
+
+		report("Polyglot key", success);
+	}
+
+	// Test that every legal move survives encoding, with castling as king takes rook
+	void testPolyglotMoveEncoding() {
+		bool success = true;
+		const std::vector<std::string> fens = {
+			START_FEN,
+			"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+			"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 b kq - 0 1",
+			"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+		};
+		for (const std::string& fen : fens) {
+			Position pos;
+			pos.set(fen);
+			MoveList moves;
+			generate<LEGAL>(pos, moves);
+			for (const ScoredMove& sm : moves)
+				success &= (book::decodeMove(pos, book::encodeMove(sm.move())) == sm.move());
+		}
+
+		Position pos;
+		pos.set(fens[1]);
+		success &= (book::encodeMove(uci::parseMove(pos, "e1g1")) == (7 | 0 << 3 | 4 << 6 | 0 << 9));
+		success &= (book::encodeMove(uci::parseMove(pos, "e1c1")) == (0 | 0 << 3 | 4 << 6 | 0 << 9));
+		pos.set(fens[2]);
+		success &= (book::encodeMove(uci::parseMove(pos, "b2a1q")) == (0 | 0 << 3 | 1 << 6 | 1 << 9 | 4 << 12));
+		success &= !book::decodeMove(pos, 0);
+
+		report("Polyglot move encoding", success);
+	}
+
+	// Test lookups among unrelated entries, weighted picks and malformed files
+	void testBookLookup() {
+		bool success = true;
+		const std::string path = tempPath("chess_book_test.bin");
+		Position start;
+		start.set(START_FEN);
+		const HashKey startKey = book::polyglotKey(start);
+
+		std::vector<book::Entry> entries;
+		std::mt19937_64 rng(5);
+		for (int i = 0; i < 10000; ++i)
+			entries.push_back({ rng(), static_cast<uint16_t>(rng()), 1, 0 });
+		entries.push_back({ startKey, book::encodeMove(uci::parseMove(start, "e2e4")), 3, 0 });
+		entries.push_back({ startKey, book::encodeMove(uci::parseMove(start, "d2d4")), 1, 0 });
+		entries.push_back({ startKey, static_cast<uint16_t>(4 | 4 << 3 | 4 << 6 | 1 << 9), 5, 0 });  // e2e5 is illegal
+		success &= book::write(path, entries);
+
+		book::Book book;
+		success &= (book.open(path) && book.size() == entries.size());
+		const std::vector<book::BookMove> moves = book.probe(start);
+		success &= (moves.size() == 2 && moves[0].move == uci::parseMove(start, "e2e4") && moves[0].weight == 3);
+		success &= (book.pick(start, 2) == uci::parseMove(start, "e2e4") && book.pick(start, 7) == uci::parseMove(start, "d2d4"));
+
+		Position outOfBook;
+		outOfBook.set("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+		success &= (book.probe(outOfBook).empty() && !book.pick(outOfBook, 0));
+
+		// A file that is not a whole number of entries is rejected
+		book.close();
+		std::filesystem::resize_file(path, 100);
+		success &= (!book.open(path) && !book.isOpen() && book.probe(start).empty());
+		success &= !book.open(tempPath("chess_book_missing.bin"));
+
+		std::remove(path.c_str());
+		report("Book lookup", success);
+	}
+
+	void runAllBookTests() {
+		std::cout << "Running Book tests...\n" << "\n";
+
+		testPolyglotKey();
+		testPolyglotMoveEncoding();
+		testBookLookup();
+
+		std::cout << "\nBook tests completed." << "\n";
+	}
+}
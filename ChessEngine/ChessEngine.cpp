@@ -1,22 +1,185 @@
 // ChessEngine.cpp : This file contains the 'main' function. Program execution begins and ends there.
 //
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <thread>
+#include "Batch.h"
+#include "Benchmark.h"
+#include "Binpack.h"
 #include "BitBoard.h"
 #include "BitBoardTests.h"
+#include "Book.h"
+#include "BookTests.h"
+#include "DataGen.h"
+#include "DataGenTests.h"
+#include "Endgame.h"
+#include "EndgameTests.h"
+#include "Epd.h"
+#include "EpdTests.h"
+#include "EvalCache.h"
+#include "EvalCacheTests.h"
+#include "Evaluate.h"
 #include "MagicBB.h"
 #include "MagicBBTests.h"
+#include "MappedFile.h"
+#include "Material.h"
+#include "MaterialTests.h"
 #include "Move.h"
+#include "MoveGen.h"
+#include "MoveGenTests.h"
+#include "MoveList.h"
+#include "MoveListTests.h"
+#include "MovePicker.h"
+#include "MovePickerTests.h"
 #include "MoveTests.h"
+#include "Nnue.h"
+#include "NnueTests.h"
+#include "PackedPosition.h"
+#include "Pawns.h"
+#include "PawnsTests.h"
 #include "Position.h"
 #include "PositionTests.h"
+#include "Psqt.h"
+#include "Search.h"
+#include "SearchTests.h"
+#include "Suite.h"
+#include "Tablebases.h"
+#include "TablebasesTests.h"
+#include "ThreadPool.h"
+#include "TimeManager.h"
+#include "TimeManagerTests.h"
+#include "TranspositionTable.h"
+#include "TranspositionTableTests.h"
+#include "Uci.h"
+#include "UciEngine.h"
+#include "UciTests.h"
 
 using namespace chess;
 
-int main()
+int main(const int argc, char* argv[])
 {
 	bitboards::init();
 	magicBB::init();
 	Position::init();
+	endgames::init();
+
+	// Without arguments the engine speaks UCI on stdin and stdout.
+	// Benchmarks can be run from the command line: "ChessEngine movelist",
+	// "ChessEngine pruning [depth]", "ChessEngine multipv [depth] [lines]", "ChessEngine searchstats [depth] [threads]",
+	// "ChessEngine evalcache [depth]", "ChessEngine nnue [networkFile]",
+	// "ChessEngine syzygy <tablebasePath> [depth]", "ChessEngine stoplatency [searches] [threads]" or
+	// "ChessEngine smp [maxThreads] [depth] [games]".
+	// "ChessEngine batch <input> <output> [depth <d>] [nodes <n>] [movetime <ms>] [threads <t>] [hash <mb>] [tagged]"
+	// analyses every position of an EPD or FEN file, at depth 10 on all cores by default.
+	// "ChessEngine datagen <output> [games <g>] [threads <t>] [nodes <n>] [random <plies>] [seed <s>] [format binpack]"
+	// appends self-play training positions to a file, "ChessEngine binpack <file>" measures reading one back.
+	// "ChessEngine suite <epdFile> [movetime <ms>] [nodes <n>] [threads <t>] [hash <mb>]" runs an EPD test suite,
+	// 1000 ms per position on all cores by default.
+	// "ChessEngine bench [depth] [threads]" prints the node signature of a fixed-depth search of built-in positions
+	const std::string command = argc > 1 ? argv[1] : "";
+	if (command.empty()) {
+		uci::Engine engine;
+		engine.loop(std::cin);
+	}
+	else if (command == "movelist")
+		benchmark::moveListSorting();
+	else if (command == "pruning")
+		benchmark::searchPruning(argc > 2 ? std::stoi(argv[2]) : 9);
+	else if (command == "multipv")
+		benchmark::multiPV(argc > 2 ? std::stoi(argv[2]) : 9, argc > 3 ? std::stoi(argv[3]) : 5);
+	else if (command == "searchstats")
+		benchmark::searchStatistics(argc > 2 ? std::stoi(argv[2]) : 10, argc > 3 ? std::stoi(argv[3]) : 1);
+	else if (command == "evalcache")
+		benchmark::evalCaches(argc > 2 ? std::stoi(argv[2]) : 10);
+	else if (command == "nnue")
+		benchmark::nnueSpeed(argc > 2 ? argv[2] : "");
+	else if (command == "syzygy" && argc > 2)
+		benchmark::syzygy(argv[2], argc > 3 ? std::stoi(argv[3]) : 12);
+	else if (command == "stoplatency")
+		benchmark::stopLatency(argc > 2 ? std::stoi(argv[2]) : 100, argc > 3 ? std::stoi(argv[3]) : 1);
+	else if (command == "batch" && argc > 3) {
+		batch::Options options;
+		options.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+		for (int i = 4; i < argc; ++i) {
+			const std::string option = argv[i];
+			if (option == "tagged")
+				options.tagged = true;
+			else if (i + 1 < argc) {
+				const std::string value = argv[++i];
+				if (option == "depth") options.limits.depth = std::stoi(value);
+				else if (option == "nodes") options.limits.nodes = std::stoull(value);
+				else if (option == "movetime") options.limits.moveTime = std::stoll(value);
+				else if (option == "threads") options.threads = std::stoi(value);
+				else if (option == "hash") options.hashMb = std::stoull(value);
+			}
+		}
+		if (!options.limits.depth && !options.limits.nodes && !options.limits.moveTime)
+			options.limits.depth = 10;
+
+		std::ofstream out(argv[3]);
+		batch::Summary summary;
+		if (!out || !batch::run(argv[2], out, options, summary)) {
+			std::cerr << "cannot read " << argv[2] << " or write " << argv[3] << "\n";
+			return 1;
+		}
+		batch::printSummary(summary, std::cout);
+	}
+	else if (command == "datagen" && argc > 2) {
+		datagen::Options options;
+		options.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+		for (int i = 3; i + 1 < argc; i += 2) {
+			const std::string option = argv[i];
+			const std::string value = argv[i + 1];
+			if (option == "games") options.games = std::stoi(value);
+			else if (option == "threads") options.threads = std::stoi(value);
+			else if (option == "nodes") options.nodes = std::stoull(value);
+			else if (option == "random") options.randomPlies = std::stoi(value);
+			else if (option == "seed") options.seed = std::stoull(value);
+			else if (option == "format") options.binpack = value == "binpack";
+		}
+		datagen::Summary summary;
+		if (!datagen::generate(argv[2], options, summary)) {
+			std::cerr << "cannot write " << argv[2] << "\n";
+			return 1;
+		}
+		datagen::printSummary(summary, std::cout);
+	}
+	else if (command == "binpack" && argc > 2)
+		benchmark::binpackRead(argv[2]);
+	else if (command == "suite" && argc > 2) {
+		suite::Options options;
+		options.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+		for (int i = 3; i + 1 < argc; i += 2) {
+			const std::string option = argv[i];
+			const std::string value = argv[i + 1];
+			if (option == "movetime") options.limits.moveTime = std::stoll(value);
+			else if (option == "nodes") options.limits.nodes = std::stoull(value);
+			else if (option == "threads") options.threads = std::stoi(value);
+			else if (option == "hash") options.hashMb = std::stoull(value);
+		}
+		if (!options.limits.moveTime && !options.limits.nodes)
+			options.limits.moveTime = 1000;
+
+		suite::Summary summary;
+		if (!suite::run(argv[2], options, summary)) {
+			std::cerr << "cannot read " << argv[2] << "\n";
+			return 1;
+		}
+		suite::printSummary(summary, std::cout);
+	}
+	else if (command == "bench") {
+		const int depth = argc > 2 ? std::stoi(argv[2]) : 13;
+		const int threads = argc > 3 ? std::stoi(argv[3]) : 1;
+		benchmark::bench(depth, threads);
+	}
+	else if (command == "smp") {
+		const int threads = argc > 2 ? std::stoi(argv[2]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+		const int depth = argc > 3 ? std::stoi(argv[3]) : 8;
+		const int games = argc > 4 ? std::stoi(argv[4]) : 8;
+		benchmark::smpScaling(threads, depth, games);
+	}
 	return 0;
 }
 
@@ -0,0 +1,269 @@
+#include "DataGen.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include "Binpack.h"
+#include "MoveGen.h"
+#include "MoveList.h"
+#include "Position.h"
+#include "Search.h"
+#include "TranspositionTable.h"
+
+// DataGen.cpp - Self-play generation of scored training positions
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// and pointer arithmetic warnings (26481). Samples are read from
+// a buffer whose size was checked
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+#pragma warning(disable: 26481)
+
+namespace chess::datagen {
+
+	namespace {
+		// Scores beyond this, for the side to move and then the opponent, end the game as won
+		constexpr Value ADJUDICATE_SCORE = 10 * PawnValue;
+		constexpr int ADJUDICATE_PLIES = 4;
+
+		// Appends blocks of bytes to a file on its own thread, in the order they were pushed
+		class BackgroundWriter {
+		public:
+			explicit BackgroundWriter(const std::string& path)
+				: m_out(path, std::ios::binary | std::ios::app), m_thread([this] { run(); }) {}
+			BackgroundWriter(const BackgroundWriter&) = delete;
+			BackgroundWriter& operator=(const BackgroundWriter&) = delete;
+			~BackgroundWriter() { close(); }
+
+			[[nodiscard]] bool isOpen() const { return m_out.is_open(); }
+
+			void push(std::vector<uint8_t> block) {
+				{
+					const std::scoped_lock lock(m_mutex);
+					m_blocks.push_back(std::move(block));
+				}
+				m_wakeUp.notify_one();
+			}
+
+			// Writes what is queued and ends the thread, false if a write failed
+			bool close() {
+				{
+					const std::scoped_lock lock(m_mutex);
+					m_closing = true;
+				}
+				m_wakeUp.notify_one();
+				if (m_thread.joinable())
+					m_thread.join();
+				m_out.close();
+				return m_good;
+			}
+
+		private:
+			void run() {
+				std::unique_lock lock(m_mutex);
+				while (true) {
+					m_wakeUp.wait(lock, [this] { return m_closing || !m_blocks.empty(); });
+					if (m_blocks.empty())
+						return;
+					std::vector<uint8_t> block = std::move(m_blocks.front());
+					m_blocks.pop_front();
+					lock.unlock();
+					m_out.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size()));
+					m_good &= static_cast<bool>(m_out);
+					lock.lock();
+				}
+			}
+
+			std::ofstream m_out;
+			std::mutex m_mutex;
+			std::condition_variable m_wakeUp;
+			std::deque<std::vector<uint8_t>> m_blocks;
+			bool m_closing = false;
+			bool m_good = true;
+			std::thread m_thread;  // Started last, after the members it uses
+		};
+
+		// Neither side can mate: kings only, or a single minor piece
+		bool insufficientMaterial(const Position& pos) {
+			const int pieces = popCount(pos.pieces());
+			return pieces == 2 || (pieces == 3 && pos.pieces(KNIGHT, BISHOP));
+		}
+
+		// Random legal moves from the start position, false if the game ended on the way
+		bool playRandomOpening(Position& pos, std::deque<StateInfo>& states, const int plies, std::mt19937_64& rng) {
+			pos.set(START_FEN);
+			for (int i = 0; i < plies; ++i) {
+				MoveList moves;
+				generate<LEGAL>(pos, moves);
+				if (moves.empty())
+					return false;
+				const Move m = moves[static_cast<int>(rng() % static_cast<uint64_t>(moves.size()))];
+				pos.doMove(m, states.emplace_back());
+			}
+			MoveList moves;
+			generate<LEGAL>(pos, moves);
+			return !moves.empty();
+		}
+
+		struct GameCounters {
+			std::atomic<uint64_t> samples{ 0 };
+			std::array<std::atomic<uint64_t>, COLOR_NB + 1> results{};  // White wins, black wins, draws
+		};
+
+		// Plays one game and queues its samples for the writer
+		void playGame(search::Searcher& searcher, TranspositionTable& tt, const Options& options, const uint64_t game,
+			BackgroundWriter& writer, GameCounters& counters) {
+			std::mt19937_64 rng(options.seed * 0x9E3779B97F4A7C15ULL + game);
+			Position pos;
+			std::deque<StateInfo> states;
+			while (!playRandomOpening(pos, states, options.randomPlies, rng))
+				states.clear();
+			tt.clear();
+			searcher.clearHistory();
+			const PackedPosition start = pack(pos);
+
+			search::Limits limits;
+			limits.nodes = options.nodes;
+			std::vector<Sample> samples;
+			std::vector<Color> sampleSides;
+			std::vector<Move> gameMoves;
+			std::vector<Value> gameScores;
+			Color winner = COLOR_NB;  // Draw
+			Color decisiveWinner = COLOR_NB;
+			int decisivePlies = 0;
+			for (int ply = 0;; ++ply) {
+				MoveList moves;
+				generate<LEGAL>(pos, moves);
+				if (moves.empty()) {
+					winner = pos.checkers() ? ~pos.sideToMove() : COLOR_NB;
+					break;
+				}
+				if (pos.isDraw(0) || insufficientMaterial(pos) || ply >= options.maxPlies)
+					break;
+
+				const search::Result result = searcher.think(pos, limits);
+				const Value score = result.score;
+
+				// A clearly won or lost score confirmed by both sides ends the game: the count restarts
+				// whenever the side the score says is winning changes
+				const Color scoreWinner = score > 0 ? pos.sideToMove() : ~pos.sideToMove();
+				if (std::abs(score) < ADJUDICATE_SCORE)
+					decisivePlies = 0;
+				else {
+					decisivePlies = scoreWinner == decisiveWinner ? decisivePlies + 1 : 1;
+					decisiveWinner = scoreWinner;
+				}
+				if (decisivePlies >= ADJUDICATE_PLIES) {
+					winner = decisiveWinner;
+					break;
+				}
+
+				if (!pos.checkers() && !pos.captureOrPromotion(result.bestMove) && std::abs(score) < VALUE_MATE_IN_MAX_PLY) {
+					Sample sample;
+					sample.position = pack(pos);
+					sample.score = static_cast<int16_t>(score);
+					samples.push_back(sample);
+					sampleSides.push_back(pos.sideToMove());
+				}
+				gameMoves.push_back(result.bestMove);
+				gameScores.push_back(score);
+				pos.doMove(result.bestMove, states.emplace_back());
+			}
+
+			std::vector<uint8_t> block;
+			if (options.binpack) {
+				const int whiteResult = winner == WHITE ? 1 : winner == BLACK ? -1 : 0;
+				binpack::appendChain(start, gameMoves, gameScores, whiteResult, block);
+				counters.samples.fetch_add(std::min(gameMoves.size(), binpack::MAX_CHAIN_MOVES), std::memory_order_relaxed);
+			}
+			else {
+				block.reserve(samples.size() * SAMPLE_SIZE);
+				for (size_t i = 0; i < samples.size(); ++i) {
+					samples[i].result = static_cast<int8_t>(winner == COLOR_NB ? 0 : winner == sampleSides[i] ? 1 : -1);
+					appendSample(samples[i], block);
+				}
+				counters.samples.fetch_add(samples.size(), std::memory_order_relaxed);
+			}
+			writer.push(std::move(block));
+			counters.results[winner].fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void appendSample(const Sample& sample, std::vector<uint8_t>& out) {
+		out.insert(out.end(), sample.position.bytes.begin(), sample.position.bytes.end());
+		const auto score = static_cast<uint16_t>(sample.score);
+		out.push_back(static_cast<uint8_t>(score));
+		out.push_back(static_cast<uint8_t>(score >> 8));
+		out.push_back(static_cast<uint8_t>(sample.result));
+	}
+
+	bool readSamples(const std::string& path, std::vector<Sample>& samples) {
+		std::ifstream in(path, std::ios::binary);
+		if (!in)
+			return false;
+		const std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		if (data.size() % SAMPLE_SIZE)
+			return false;
+		for (size_t offset = 0; offset < data.size(); offset += SAMPLE_SIZE) {
+			const uint8_t* p = data.data() + offset;
+			Sample& sample = samples.emplace_back();
+			std::copy(p, p + PackedPosition::SIZE, sample.position.bytes.begin());
+			p += PackedPosition::SIZE;
+			sample.score = static_cast<int16_t>(p[0] | (p[1] << 8));
+			sample.result = static_cast<int8_t>(p[2]);
+		}
+		return true;
+	}
+
+	bool generate(const std::string& path, const Options& options, Summary& summary) {
+		BackgroundWriter writer(path);
+		if (!writer.isOpen())
+			return false;
+
+		GameCounters counters;
+		std::atomic<uint64_t> nextGame{ 0 };
+		const auto games = static_cast<uint64_t>(std::max(options.games, 0));
+		const auto start = std::chrono::steady_clock::now();
+		std::vector<std::thread> threads;
+		for (int t = 0; t < std::max(options.threads, 1); ++t)
+			threads.emplace_back([&] {
+				TranspositionTable tt;
+				tt.resize(options.hashMb);
+				const auto searcher = std::make_unique<search::Searcher>(tt);
+				searcher->setSilent(true);
+				for (uint64_t game = nextGame.fetch_add(1); game < games; game = nextGame.fetch_add(1))
+					playGame(*searcher, tt, options, game, writer, counters);
+			});
+		for (std::thread& thread : threads)
+			thread.join();
+		const bool written = writer.close();
+
+		summary = Summary{};
+		summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		summary.samples = counters.samples.load();
+		summary.whiteWins = counters.results[WHITE].load();
+		summary.blackWins = counters.results[BLACK].load();
+		summary.draws = counters.results[COLOR_NB].load();
+		summary.games = summary.whiteWins + summary.blackWins + summary.draws;
+		return written;
+	}
+
+	void printSummary(const Summary& summary, std::ostream& out) {
+		const double seconds = std::max(summary.seconds, 1e-9);
+		out << summary.games << " games (+" << summary.whiteWins << " =" << summary.draws << " -" << summary.blackWins
+			<< " for white), " << summary.samples << " positions in " << std::fixed << std::setprecision(2) << summary.seconds
+			<< " s: " << std::setprecision(1) << static_cast<double>(summary.samples) / seconds << " positions/s\n";
+	}
+}
+#pragma warning(pop)
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "PackedPosition.h"
+#include "Types.h"
+
+// DataGen.h - Self-play generation of scored training positions
+
+namespace chess::datagen {
+
+	// One training position: the packed position, the search score and the game result, both from the
+	// side to move's point of view. Stored as the packed bytes, the score as little-endian int16 and
+	// the result as int8 (-1 loss, 0 draw, 1 win)
+	struct Sample {
+		PackedPosition position;
+		int16_t score = 0;
+		int8_t result = 0;
+	};
+
+	constexpr size_t SAMPLE_SIZE = PackedPosition::SIZE + 3;
+
+	void appendSample(const Sample& sample, std::vector<uint8_t>& out);
+
+	// Reads the samples of a file, false if it cannot be read or ends inside a sample
+	bool readSamples(const std::string& path, std::vector<Sample>& samples);
+
+	struct Options {
+		int games = 100;
+		int threads = 1;
+		uint64_t nodes = 5000;  // Node limit of every move
+		int randomPlies = 8;    // Random legal moves from the start position before the search plays
+		uint64_t seed = 1;      // Game i opens with the moves drawn from seed and i, whatever the thread count
+		int maxPlies = 400;     // Longer games are drawn
+		size_t hashMb = 16;     // Transposition table of each thread, cleared for every game
+		bool binpack = false;   // Whole games as binpack chains instead of quiet positions as samples
+	};
+
+	struct Summary {
+		uint64_t games = 0;
+		uint64_t samples = 0;   // Samples or binpack positions written
+		uint64_t whiteWins = 0;
+		uint64_t draws = 0;
+		uint64_t blackWins = 0;
+		double seconds = 0.0;
+	};
+
+	// Plays options.games games on options.threads threads and appends their quiet positions (not in check,
+	// best move neither capture nor promotion) to the file at path, or every searched position as binpack
+	// chains which readers filter themselves. Each thread hands a finished game's
+	// samples to a background writer, so searches never wait on the disk. False if path cannot be opened
+	bool generate(const std::string& path, const Options& options, Summary& summary);
+
+	void printSummary(const Summary& summary, std::ostream& out);
+}
@@ -0,0 +1,156 @@
+#include "DataGenTests.h"
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Binpack.h"
+#include "DataGen.h"
+#include "PackedPosition.h"
+#include "Position.h"
+#include "Types.h"
+#include "Uci.h"
+
+// DataGenTests.cpp - Tests for packed positions and self-play training data
+
+namespace chess::tests
+{
+	// Test that positions survive packing, with castling rights, en passant and either side to move
+	void testPackedPosition() {
+		bool success = true;
+		for (const char* fen : {
+			"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+			"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w Kq - 3 10",
+			"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+			"rnbqkbnr/pppp1ppp/8/8/3Pp3/8/PPP1PPPP/RNBQKBNR b kq d3 0 2",
+			"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 b - - 17 60",
+			"4k3/8/8/8/8/8/8/4K3 w - - 99 200" }) {
+			Position pos;
+			pos.set(fen);
+			const PackedPosition packed = pack(pos);
+			Position unpacked;
+			success &= unpack(packed, unpacked) && unpacked.fen() == pos.fen() && unpacked.key() == pos.key();
+		}
+
+		// Two white kings are no position
+		Position pos;
+		pos.set("4k3/8/8/8/8/8/8/4K3 w - - 0 1");
+		PackedPosition packed = pack(pos);
+		packed.bytes[8] = static_cast<uint8_t>((packed.bytes[8] & 0xF0) | 5);
+		packed.bytes[8] = static_cast<uint8_t>((packed.bytes[8] & 0x0F) | (5 << 4));
+		success &= !unpack(packed, pos) && pos.fen() == "4k3/8/8/8/8/8/8/4K3 w - - 0 1";
+		report("Packed position round trip", success);
+	}
+
+	// Test that generated samples unpack, carry game results and are appended by later runs
+	void testDataGeneration() {
+		const std::string path = tempPath("chess_datagen_test.bin");
+		std::remove(path.c_str());
+
+		datagen::Options options;
+		options.games = 4;
+		options.threads = 2;
+		options.nodes = 2000;
+		options.maxPlies = 60;
+		options.hashMb = 1;
+		datagen::Summary summary;
+		bool success = datagen::generate(path, options, summary) && summary.games == 4 && summary.samples > 0;
+
+		std::vector<datagen::Sample> samples;
+		success &= datagen::readSamples(path, samples) && samples.size() == summary.samples;
+		for (const datagen::Sample& sample : samples) {
+			Position pos;
+			success &= unpack(sample.position, pos) && !pos.checkers() && sample.result >= -1 && sample.result <= 1;
+		}
+
+		datagen::Summary second;
+		success &= datagen::generate(path, options, second);
+		std::vector<datagen::Sample> appended;
+		success &= datagen::readSamples(path, appended) && appended.size() == summary.samples + second.samples;
+
+		// Games only depend on their number and the seed, so the same run repeats them
+		success &= second.samples == summary.samples;
+		std::remove(path.c_str());
+		report("Self-play data generation", success);
+	}
+
+	// Test that chains replay their games with the scores and results they were written with
+	void testBinpackChains() {
+		const std::string path = tempPath("chess_binpack_test.bin");
+		const std::vector<std::string> uciMoves = { "e2e4", "e7e5", "g1f3", "b8c6", "f1b5", "a7a6", "e1g1" };
+		const std::vector<Value> scores = { 20, -25, 30, -1200, 4000, -VALUE_MATE + 10, 0 };
+
+		Position pos;
+		std::deque<StateInfo> states;
+		pos.set(START_FEN);
+		const PackedPosition start = pack(pos);
+		std::vector<Move> moves;
+		std::vector<std::string> fens;
+		for (const std::string& m : uciMoves) {
+			fens.push_back(pos.fen());
+			moves.push_back(uci::parseMove(pos, m));
+			pos.doMove(moves.back(), states.emplace_back());
+		}
+
+		std::vector<uint8_t> data;
+		binpack::appendChain(start, moves, scores, -1, data);
+		binpack::appendChain(start, {}, {}, 0, data);
+		binpack::appendChain(pack(pos), { uci::parseMove(pos, "f8c5") }, { 15 }, 1, data);
+		{
+			std::ofstream out(path, std::ios::binary);
+			out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		}
+
+		binpack::Reader reader;
+		bool success = reader.open(path);
+		binpack::Entry entry;
+		for (size_t i = 0; i < moves.size(); ++i) {
+			success &= reader.next(entry) && reader.position().fen() == fens[i] && entry.move == moves[i] && entry.score == scores[i];
+			success &= entry.result == (reader.position().sideToMove() == WHITE ? -1 : 1);
+		}
+		success &= reader.next(entry) && reader.position().fen() == pos.fen() && entry.score == 15 && entry.result == -1;
+		success &= !reader.next(entry) && !reader.corrupt();
+
+		// A move that is not legal where it is replayed stops the reader
+		data.clear();
+		binpack::appendChain(start, { Move(E2, E5) }, { 0 }, 0, data);
+		{
+			std::ofstream out(path, std::ios::binary);
+			out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		}
+		success &= reader.open(path) && !reader.next(entry) && reader.corrupt();
+		reader.close();
+		std::remove(path.c_str());
+
+		// Self-play games written as chains read back position by position
+		datagen::Options options;
+		options.games = 2;
+		options.nodes = 2000;
+		options.maxPlies = 40;
+		options.hashMb = 1;
+		options.binpack = true;
+		datagen::Summary summary;
+		success &= datagen::generate(path, options, summary);
+		uint64_t positions = 0;
+		success &= reader.open(path);
+		while (reader.next(entry))
+			++positions;
+		success &= !reader.corrupt() && positions == summary.samples && positions > 0;
+		reader.close();
+		std::remove(path.c_str());
+		report("Binpack chains", success);
+	}
+
+	// Run all data generation tests
+	void runAllDataGenTests() {
+		std::cout << "Running data generation tests...\n" << "\n";
+
+		testPackedPosition();
+		testDataGeneration();
+		testBinpackChains();
+
+		std::cout << "\nData generation tests completed." << "\n";
+	}
+}
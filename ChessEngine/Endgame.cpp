@@ -0,0 +1,275 @@
+#include "Endgame.h"
+#include <algorithm>
+#include <vector>
+#include "BitBoard.h"
+#include "MoveGen.h"
+
+// Endgame.cpp - Specialised evaluation of known endgames and the KPK bitbase
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// Bitbase indices are built from valid squares and stay below
+// KPK_SIZE, squares index the attack tables directly
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+#pragma warning(disable: 26482)
+
+namespace chess::endgames {
+
+	namespace {
+		constexpr Bitboard DARK_SQUARES = 0xAA55AA55AA55AA55ULL;
+
+		// Side to move, 24 pawn squares (files A-D, ranks 2-7) and both king squares
+		constexpr unsigned KPK_SIZE = 2 * 24 * 64 * 64;
+		std::array<uint32_t, KPK_SIZE / 32> g_kpkBitbase{};
+
+		// Known endgames by material key, only searched when the material table misses
+		std::vector<std::pair<HashKey, Endgame>> g_endgames;
+
+		unsigned kpkIndex(const Color stm, const Square blackKing, const Square whiteKing, const Square pawn) {
+			return static_cast<unsigned>(whiteKing) | (blackKing << 6) | (stm << 12) | (fileOf(pawn) << 13)
+				| ((RANK_7 - rankOf(pawn)) << 15);
+		}
+
+		enum KPKResult : uint8_t { INVALID = 0, UNKNOWN = 1, DRAW = 2, WIN = 4 };
+
+		// One position of the bitbase, classified by retrograde iteration until nothing changes
+		struct KPKPosition {
+			explicit KPKPosition(const unsigned index) {
+				kings[WHITE] = static_cast<Square>(index & 0x3F);
+				kings[BLACK] = static_cast<Square>((index >> 6) & 0x3F);
+				stm = static_cast<Color>((index >> 12) & 1);
+				pawn = makeSquare(static_cast<File>((index >> 13) & 3), static_cast<Rank>(RANK_7 - ((index >> 15) & 7)));
+
+				const Square push = pawn + NORTH;
+				const Bitboard whiteKingAttacks = g_pseudoAttacks[KING][kings[WHITE]];
+				const Bitboard blackKingAttacks = g_pseudoAttacks[KING][kings[BLACK]];
+
+				// Kings touching, a piece on top of another or black in check with white to move
+				if (distance<Square>(kings[WHITE], kings[BLACK]) <= 1 || kings[WHITE] == pawn || kings[BLACK] == pawn
+					|| (stm == WHITE && (pawnAttack<WHITE>(pawn) & squareToBB(kings[BLACK]))))
+					result = INVALID;
+
+				// The pawn promotes and the queen can't be taken
+				else if (stm == WHITE && rankOf(pawn) == RANK_7 && kings[WHITE] != push
+					&& (distance<Square>(kings[BLACK], push) > 1 || (whiteKingAttacks & squareToBB(push))))
+					result = WIN;
+
+				// Black is stalemated or takes an undefended pawn
+				else if (stm == BLACK && (!(blackKingAttacks & ~(whiteKingAttacks | pawnAttack<WHITE>(pawn)))
+					|| (blackKingAttacks & ~whiteKingAttacks & squareToBB(pawn))))
+					result = DRAW;
+
+				else
+					result = UNKNOWN;
+			}
+
+			// Result from the positions one move away, UNKNOWN while none of them decides
+			KPKResult classify(const std::vector<KPKPosition>& db) {
+				const KPKResult good = stm == WHITE ? WIN : DRAW;
+				const KPKResult bad = stm == WHITE ? DRAW : WIN;
+
+				int r = INVALID;
+				for (Bitboard b = g_pseudoAttacks[KING][kings[stm]]; b; ) {
+					const Square to = popLsb(b);
+					r |= stm == WHITE ? db[kpkIndex(BLACK, kings[BLACK], to, pawn)].result
+						: db[kpkIndex(WHITE, to, kings[WHITE], pawn)].result;
+				}
+
+				if (stm == WHITE) {
+					if (rankOf(pawn) < RANK_7)
+						r |= db[kpkIndex(BLACK, kings[BLACK], kings[WHITE], pawn + NORTH)].result;
+					if (rankOf(pawn) == RANK_2 && pawn + NORTH != kings[WHITE] && pawn + NORTH != kings[BLACK])
+						r |= db[kpkIndex(BLACK, kings[BLACK], kings[WHITE], pawn + NORTH + NORTH)].result;
+				}
+
+				return result = (r & good) ? good : (r & UNKNOWN) ? UNKNOWN : bad;
+			}
+
+			std::array<Square, COLOR_NB> kings;
+			Square pawn;
+			Color stm;
+			KPKResult result;
+		};
+
+		void initKPK() {
+			std::vector<KPKPosition> db;
+			db.reserve(KPK_SIZE);
+			for (unsigned idx = 0; idx < KPK_SIZE; ++idx)
+				db.emplace_back(idx);
+
+			bool changed = true;
+			while (changed) {
+				changed = false;
+				for (KPKPosition& p : db)
+					changed |= p.result == UNKNOWN && p.classify(db) != UNKNOWN;
+			}
+
+			g_kpkBitbase.fill(0);
+			for (unsigned idx = 0; idx < KPK_SIZE; ++idx)
+				if (db[idx].result == WIN)
+					g_kpkBitbase[idx / 32] |= 1u << (idx & 31);
+		}
+
+		// Bonus for driving a king to the edge, and for kings close together or far apart
+		int pushToEdge(const Square sq) {
+			const int f = fileOf(sq);
+			const int r = rankOf(sq);
+			return 100 - 13 * (std::min(f, 7 - f) + std::min(r, 7 - r));
+		}
+		int pushClose(const Square a, const Square b) { return 140 - 20 * distance<Square>(a, b); }
+		int pushAway(const Square a, const Square b) { return 20 * distance<Square>(a, b) - 20; }
+	}
+
+	void init() {
+		initKPK();
+
+		const std::pair<const char*, EvalFn> known[] = {
+			{ "KBNK", evaluateKBNK }, { "KPK", evaluateKPK }, { "KRKP", evaluateKRKP }, { "KRKB", evaluateKRKB },
+			{ "KRKN", evaluateKRKN }, { "KQKR", evaluateKQKR }, { "KNNK", evaluateKNNK }
+		};
+		g_endgames.clear();
+		for (const auto& [code, fn] : known)
+			for (const Color strong : { WHITE, BLACK })
+				g_endgames.push_back({ materialKey(code, strong), Endgame{ fn, strong } });
+	}
+
+	Endgame probe(const HashKey key) {
+		const auto it = std::find_if(g_endgames.begin(), g_endgames.end(), [key](const auto& e) { return e.first == key; });
+		return it != g_endgames.end() ? it->second : Endgame{};
+	}
+
+	HashKey materialKey(const std::string& code, const Color strong) {
+		assert(code.size() >= 2 && code[0] == 'K' && code.find('K', 1) != std::string::npos);
+
+		std::array<int, PIECE_NB> counts{};
+		HashKey key = 0;
+		Color c = ~strong;
+		for (const char ch : code) {
+			if (ch == 'K')
+				c = ~c;
+			const size_t pt = std::string(" PNBRQK").find(ch);
+			assert(pt != std::string::npos && pt != 0);
+			const Piece piece = makePiece(c, static_cast<PieceType>(pt));
+			key ^= zobrist::materialKey(piece, counts[piece]++);
+		}
+		return key;
+	}
+
+	bool probeKPK(const Square whiteKing, const Square whitePawn, const Square blackKing, const Color sideToMove) {
+		assert(fileOf(whitePawn) <= FILE_D);
+		const unsigned idx = kpkIndex(sideToMove, blackKing, whiteKing, whitePawn);
+		return g_kpkBitbase[idx / 32] & (1u << (idx & 31));
+	}
+
+	Value evaluateKXK(const Position& pos, const Color strongSide) {
+		const Color weakSide = ~strongSide;
+
+		// Driving the king to the edge also leads to stalemates, which the search must not stand pat on
+		if (pos.sideToMove() == weakSide && !pos.checkers()) {
+			MoveList moves;
+			generate<LEGAL>(pos, moves);
+			if (moves.empty())
+				return VALUE_DRAW;
+		}
+
+		const Square strongKing = pos.kingSquare(strongSide);
+		const Square weakKing = pos.kingSquare(weakSide);
+
+		Value result = pos.nonPawnMaterial(strongSide) + PawnValue * pos.count(strongSide, PAWN)
+			+ pushToEdge(weakKing) + pushClose(strongKing, weakKing);
+
+		const Bitboard bishops = pos.pieces(strongSide, BISHOP);
+		if (pos.pieces(strongSide, QUEEN, ROOK) || (bishops && pos.pieces(strongSide, KNIGHT))
+			|| ((bishops & DARK_SQUARES) && (bishops & ~DARK_SQUARES)))
+			result = std::min(result + VALUE_KNOWN_WIN, VALUE_MATE_IN_MAX_PLY - 1);
+		return result;
+	}
+
+	// Mate can only be forced in a corner of the bishop's color
+	Value evaluateKBNK(const Position& pos, const Color strongSide) {
+		assert(pos.count(strongSide, BISHOP) == 1 && pos.count(strongSide, KNIGHT) == 1);
+		const Square strongKing = pos.kingSquare(strongSide);
+		const Square weakKing = pos.kingSquare(~strongSide);
+		const bool darkBishop = pos.pieces(strongSide, BISHOP) & DARK_SQUARES;
+
+		const int cornerDistance = darkBishop ? std::min(distance<Square>(weakKing, A1), distance<Square>(weakKing, H8))
+			: std::min(distance<Square>(weakKing, A8), distance<Square>(weakKing, H1));
+		return VALUE_KNOWN_WIN + pushClose(strongKing, weakKing) + 60 * (7 - cornerDistance);
+	}
+
+	Value evaluateKPK(const Position& pos, const Color strongSide) {
+		assert(pos.count(strongSide, PAWN) == 1 && popCount(pos.pieces()) == 3);
+
+		// Look the position up with the strong side as white and the pawn on files A-D
+		Square strongKing = pos.kingSquare(strongSide);
+		Square weakKing = pos.kingSquare(~strongSide);
+		Square pawn = lsb(pos.pieces(strongSide, PAWN));
+		Color stm = pos.sideToMove();
+		if (strongSide == BLACK) {
+			strongKing = flipRank(strongKing);
+			weakKing = flipRank(weakKing);
+			pawn = flipRank(pawn);
+			stm = ~stm;
+		}
+		if (fileOf(pawn) >= FILE_E) {
+			strongKing = flipFile(strongKing);
+			weakKing = flipFile(weakKing);
+			pawn = flipFile(pawn);
+		}
+
+		if (!probeKPK(strongKing, pawn, weakKing, stm))
+			return VALUE_DRAW;
+		return VALUE_KNOWN_WIN + PawnValue + rankOf(pawn);
+	}
+
+	// Won when the strong king blocks the pawn or the weak king is far away, drawish when the pawn is
+	// far advanced with its king next to it, otherwise decided by the race of the kings to the pawn
+	Value evaluateKRKP(const Position& pos, const Color strongSide) {
+		const Color weakSide = ~strongSide;
+		const Square strongKing = relativeSquare(strongSide, pos.kingSquare(strongSide));
+		const Square weakKing = relativeSquare(strongSide, pos.kingSquare(weakSide));
+		const Square strongRook = relativeSquare(strongSide, lsb(pos.pieces(strongSide, ROOK)));
+		const Square weakPawn = relativeSquare(strongSide, lsb(pos.pieces(weakSide, PAWN)));
+		const Square queeningSquare = makeSquare(fileOf(weakPawn), RANK_1);
+		const bool weakToMove = pos.sideToMove() == weakSide;
+
+		if (fileOf(strongKing) == fileOf(weakPawn) && rankOf(strongKing) < rankOf(weakPawn))
+			return RookValue - distance<Square>(strongKing, weakPawn);
+
+		if (distance<Square>(weakKing, weakPawn) >= 3 + weakToMove && distance<Square>(weakKing, strongRook) >= 3)
+			return RookValue - distance<Square>(strongKing, weakPawn);
+
+		if (rankOf(weakKing) <= RANK_3 && distance<Square>(weakKing, weakPawn) == 1 && rankOf(strongKing) >= RANK_4
+			&& distance<Square>(strongKing, weakPawn) > 2 + !weakToMove)
+			return 80 - 8 * distance<Square>(strongKing, weakPawn);
+
+		return 200 - 8 * (distance<Square>(strongKing, weakPawn + SOUTH) - distance<Square>(weakKing, weakPawn + SOUTH)
+			- distance<Square>(weakPawn, queeningSquare));
+	}
+
+	// Usually a draw, a little better with the weak king on the edge
+	Value evaluateKRKB(const Position& pos, const Color strongSide) {
+		return pushToEdge(pos.kingSquare(~strongSide));
+	}
+
+	// Usually a draw, better when the knight is cut off from its king
+	Value evaluateKRKN(const Position& pos, const Color strongSide) {
+		const Square weakKing = pos.kingSquare(~strongSide);
+		const Square weakKnight = lsb(pos.pieces(~strongSide, KNIGHT));
+		return pushToEdge(weakKing) + pushAway(weakKing, weakKnight);
+	}
+
+	Value evaluateKQKR(const Position& pos, const Color strongSide) {
+		const Square strongKing = pos.kingSquare(strongSide);
+		const Square weakKing = pos.kingSquare(~strongSide);
+		return QueenValue - RookValue + pushToEdge(weakKing) + pushClose(strongKing, weakKing);
+	}
+
+	// Two knights can't force mate
+	Value evaluateKNNK(const Position&, Color) {
+		return VALUE_DRAW;
+	}
+}
+#pragma warning(pop)
@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include "Position.h"
+#include "Types.h"
+
+// Endgame.h - Specialised evaluation of known endgames and the KPK bitbase
+
+namespace chess::endgames {
+
+	// Value of a position that is won but not yet a forced mate in the search horizon
+	constexpr Value VALUE_KNOWN_WIN = 10000;
+
+	// Evaluation of a known material configuration from the strong side's point of view
+	using EvalFn = Value (*)(const Position& pos, Color strongSide);
+
+	struct Endgame {
+		EvalFn eval = nullptr;
+		Color strongSide = WHITE;
+	};
+
+	// Builds the KPK bitbase and the table of endgames by material key, after Position::init
+	void init();
+
+	// Specialised evaluation for a material key, eval is null when there is none
+	[[nodiscard]] Endgame probe(HashKey materialKey);
+
+	// Material key of a configuration written like "KBNK", the pieces before the second king belong to strong
+	[[nodiscard]] HashKey materialKey(const std::string& code, Color strong);
+
+	// Is the position with white king, white pawn on files A-D and black king won for white
+	[[nodiscard]] bool probeKPK(Square whiteKing, Square whitePawn, Square blackKing, Color sideToMove);
+
+	// Lone king against enough material to mate, not keyed by material since it covers many configurations.
+	// A draw when the lone king is stalemated
+	Value evaluateKXK(const Position& pos, Color strongSide);
+
+	Value evaluateKBNK(const Position& pos, Color strongSide);
+	Value evaluateKPK(const Position& pos, Color strongSide);
+	Value evaluateKRKP(const Position& pos, Color strongSide);
+	Value evaluateKRKB(const Position& pos, Color strongSide);
+	Value evaluateKRKN(const Position& pos, Color strongSide);
+	Value evaluateKQKR(const Position& pos, Color strongSide);
+	Value evaluateKNNK(const Position& pos, Color strongSide);
+}
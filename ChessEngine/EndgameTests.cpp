@@ -0,0 +1,110 @@
+#include "EndgameTests.h"
+#include <iostream>
+
+#include "Endgame.h"
+#include "Position.h"
+#include "Types.h"
+
+// EndgameTests.cpp - Tests for the known endgame evaluations and the KPK bitbase
+
+namespace chess::tests
+{
+	// Test the KPK bitbase on textbook positions, for both colors and pawns on either wing
+	void testKPKBitbase() {
+		bool success = true;
+
+		// King on the sixth rank in front of its pawn wins whoever moves
+		success &= endgames::probeKPK(D6, D5, D8, WHITE);
+		success &= endgames::probeKPK(D6, D5, D8, BLACK);
+
+		// Rook pawn with the defending king in the corner is a draw
+		success &= !endgames::probeKPK(A1, A2, A8, WHITE);
+
+		// The pawn outruns the king (rule of the square)
+		success &= endgames::probeKPK(H1, B2, H3, WHITE);
+
+		// Defending king directly in front of the pawn with the opposition
+		success &= !endgames::probeKPK(D1, D2, D3, WHITE);
+
+		Position pos;
+		pos.set("4k3/8/4K3/4P3/8/8/8/8 w - - 0 1");
+		success &= (endgames::evaluateKPK(pos, WHITE) > endgames::VALUE_KNOWN_WIN);
+
+		// The same position mirrored to black and to the h-file side
+		pos.set("8/8/8/8/4p3/4k3/8/4K3 b - - 0 1");
+		success &= (endgames::evaluateKPK(pos, BLACK) > endgames::VALUE_KNOWN_WIN);
+		pos.set("7k/8/8/8/8/8/7P/7K w - - 0 1");
+		success &= (endgames::evaluateKPK(pos, WHITE) == VALUE_DRAW);
+
+		report("KPK bitbase", success);
+	}
+
+	// Test that the specialised evaluations push the play the right way
+	void testEndgameEvaluations() {
+		bool success = true;
+		Position pos;
+
+		// KBNK: the corner of the bishop's color is the one to drive the king to
+		pos.set("7k/8/8/8/8/8/8/1KBN4 w - - 0 1");
+		const Value rightCorner = endgames::evaluateKBNK(pos, WHITE);
+		pos.set("k7/8/8/8/8/8/8/1KBN4 w - - 0 1");
+		const Value wrongCorner = endgames::evaluateKBNK(pos, WHITE);
+		success &= (rightCorner > wrongCorner && wrongCorner >= endgames::VALUE_KNOWN_WIN);
+
+		// KXK: won with a rook, closer to mate with the defending king on the edge
+		pos.set("8/8/8/3k4/8/8/8/R3K3 w - - 0 1");
+		const Value centre = endgames::evaluateKXK(pos, WHITE);
+		pos.set("3k4/8/3K4/8/8/8/8/R7 w - - 0 1");
+		const Value edge = endgames::evaluateKXK(pos, WHITE);
+		success &= (centre > endgames::VALUE_KNOWN_WIN && edge > centre);
+
+		// KXK: a stalemate is a draw however close the king is to the corner
+		pos.set("k7/2Q5/1K6/8/8/8/8/8 b - - 0 1");
+		success &= (endgames::evaluateKXK(pos, WHITE) == VALUE_DRAW);
+		pos.set("k7/2Q5/1K6/8/8/8/8/8 w - - 0 1");
+		success &= (endgames::evaluateKXK(pos, WHITE) > endgames::VALUE_KNOWN_WIN);
+
+		// KRKP: the strong king in front of the pawn wins, a far advanced supported pawn is drawish
+		pos.set("R7/8/7K/8/8/2kp4/8/8 w - - 0 1");
+		const Value drawish = endgames::evaluateKRKP(pos, WHITE);
+		pos.set("8/3p4/8/8/3k4/8/8/3K3R w - - 0 1");
+		const Value blocked = endgames::evaluateKRKP(pos, WHITE);
+		success &= (blocked > RookValue / 2 && drawish < blocked);
+
+		// KNNK can't be won
+		pos.set("8/8/8/3k4/8/8/8/1NN1K3 w - - 0 1");
+		success &= (endgames::evaluateKNNK(pos, WHITE) == VALUE_DRAW);
+
+		report("Endgame evaluations", success);
+	}
+
+	// Test that the material key of a configuration code matches real positions and finds the endgame
+	void testEndgameLookup() {
+		bool success = true;
+		Position pos;
+
+		pos.set("7k/8/8/8/8/8/8/1KBN4 w - - 0 1");
+		success &= (endgames::materialKey("KBNK", WHITE) == pos.materialKey());
+		success &= (endgames::probe(pos.materialKey()).eval == endgames::evaluateKBNK);
+		success &= (endgames::probe(pos.materialKey()).strongSide == WHITE);
+
+		pos.set("8/8/8/8/3K4/8/3k3P/3r4 b - - 0 1");
+		success &= (endgames::probe(pos.materialKey()).eval == endgames::evaluateKRKP);
+		success &= (endgames::probe(pos.materialKey()).strongSide == BLACK);
+
+		pos.set(START_FEN);
+		success &= (endgames::probe(pos.materialKey()).eval == nullptr);
+
+		report("Endgame lookup by material key", success);
+	}
+
+	void runAllEndgameTests() {
+		std::cout << "Running Endgame tests...\n" << "\n";
+
+		testKPKBitbase();
+		testEndgameEvaluations();
+		testEndgameLookup();
+
+		std::cout << "\nEndgame tests completed." << "\n";
+	}
+}
@@ -0,0 +1,270 @@
+#include "Epd.h"
+#include <array>
+#include <algorithm>
+#include "MoveGen.h"
+#include "MoveList.h"
+#include "Position.h"
+#include "Types.h"
+#include "Uci.h"
+
+// Epd.cpp - Parsing of EPD and FEN position lines
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// Piece counts are indexed by piece, checked before use
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+
+namespace chess::epd {
+
+	namespace {
+		constexpr std::string_view WHITESPACE = " \t\r\n";
+
+		std::string_view nextToken(std::string_view& line) {
+			const size_t start = line.find_first_not_of(WHITESPACE);
+			if (start == std::string_view::npos) {
+				line = {};
+				return {};
+			}
+			line.remove_prefix(start);
+			const size_t end = std::min(line.find_first_of(WHITESPACE), line.size());
+			const std::string_view token = line.substr(0, end);
+			line.remove_prefix(end);
+			return token;
+		}
+
+		bool isNumber(const std::string_view s) {
+			return !s.empty() && s.find_first_not_of("0123456789") == std::string_view::npos;
+		}
+
+		// Eight ranks of eight squares, one king per side and no pawns on the first or last rank
+		bool validBoard(const std::string_view board) {
+			constexpr std::string_view PIECES = "PNBRQKpnbrqk";
+			std::array<int, 12> counts{};
+			int rank = 7;
+			int file = 0;
+			for (const char c : board) {
+				if (c == '/') {
+					if (file != 8 || rank == 0)
+						return false;
+					--rank;
+					file = 0;
+				}
+				else if (c >= '1' && c <= '8')
+					file += c - '0';
+				else if (const size_t idx = PIECES.find(c); idx != std::string_view::npos) {
+					if ((c == 'P' || c == 'p') && (rank == 0 || rank == 7))
+						return false;
+					++counts[idx];
+					++file;
+				}
+				else
+					return false;
+				if (file > 8)
+					return false;
+			}
+			return rank == 0 && file == 8 && counts[5] == 1 && counts[11] == 1;
+		}
+
+		bool validCastling(const std::string_view castling) {
+			return castling == "-" || (castling.size() <= 4 && castling.find_first_not_of("KQkq") == std::string_view::npos);
+		}
+
+		// Piece letter on a square of a valid board, ' ' for an empty square
+		char pieceOn(const std::string_view board, const int file, const int rank) {
+			int f = 0, r = 7;
+			for (const char c : board) {
+				if (c == '/') {
+					--r;
+					f = 0;
+				}
+				else if (c >= '1' && c <= '8')
+					f += c - '0';
+				else {
+					if (f == file && r == rank)
+						return c;
+					++f;
+				}
+			}
+			return ' ';
+		}
+
+		// The rights of a valid castling field whose king and rook are still on their home squares,
+		// Position::set would otherwise register a castling move without a rook
+		std::string castlingRights(const std::string_view board, const std::string_view castling) {
+			std::string rights;
+			constexpr std::string_view LETTERS = "KQkq";
+			for (size_t i = 0; i < LETTERS.size(); ++i) {
+				const bool white = i < 2;
+				const int rank = white ? 0 : 7;
+				const int rookFile = i % 2 == 0 ? 7 : 0;
+				if (castling.find(LETTERS[i]) != std::string_view::npos
+					&& pieceOn(board, 4, rank) == (white ? 'K' : 'k') && pieceOn(board, rookFile, rank) == (white ? 'R' : 'r'))
+					rights += LETTERS[i];
+			}
+			return rights.empty() ? "-" : rights;
+		}
+
+		bool validEnPassant(const std::string_view ep) {
+			return ep == "-" || (ep.size() == 2 && ep[0] >= 'a' && ep[0] <= 'h' && (ep[1] == '3' || ep[1] == '6'));
+		}
+
+		// Splits "opcode operand...; opcode; ..." into operations, keeping quoted operands whole
+		void parseOperations(std::string_view ops, std::vector<std::pair<std::string, std::string>>& operations) {
+			while (true) {
+				std::string_view opcode = nextToken(ops);
+				if (opcode.empty())
+					return;
+				std::string operand;
+				if (opcode.back() == ';')
+					opcode.remove_suffix(1);
+				else {
+					bool quoted = false;
+					size_t i = 0;
+					for (; i < ops.size() && (quoted || ops[i] != ';'); ++i) {
+						if (ops[i] == '"')
+							quoted = !quoted;
+						else
+							operand += ops[i];
+					}
+					ops.remove_prefix(std::min(i + 1, ops.size()));
+					const size_t first = operand.find_first_not_of(WHITESPACE);
+					operand = first == std::string::npos ? std::string()
+						: operand.substr(first, operand.find_last_not_of(WHITESPACE) - first + 1);
+				}
+				operations.emplace_back(std::string(opcode), std::move(operand));
+			}
+		}
+
+		// Standard algebraic notation only
+		Move sanMove(const Position& pos, std::string_view san) {
+			if (san.empty())
+				return Move::none();
+
+			MoveList moves;
+			generate<LEGAL>(pos, moves);
+			const Color us = pos.sideToMove();
+
+			// Castling is the king's two-square move
+			if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+				const Square to = relativeSquare(us, san.size() == 3 ? G1 : C1);
+				for (const ScoredMove& sm : moves)
+					if (sm.move().moveType() == CASTLING && sm.move().toSq() == to)
+						return sm.move();
+				return Move::none();
+			}
+
+			// [piece][from file][from rank][x]to[=promotion]
+			constexpr std::string_view PIECES = "PNBRQK";
+			PieceType piece = PAWN;
+			if (const size_t idx = PIECES.find(san.front()); idx != std::string_view::npos && san.front() != 'P') {
+				piece = static_cast<PieceType>(PAWN + idx);
+				san.remove_prefix(1);
+			}
+			PieceType promotion = NO_PIECE_TYPE;
+			if (san.size() >= 2 && PIECES.find(san.back()) != std::string_view::npos) {
+				promotion = static_cast<PieceType>(PAWN + PIECES.find(san.back()));
+				san.remove_suffix(san[san.size() - 2] == '=' ? 2 : 1);
+			}
+			if (san.size() < 2)
+				return Move::none();
+			const char toFile = san[san.size() - 2];
+			const char toRank = san[san.size() - 1];
+			if (toFile < 'a' || toFile > 'h' || toRank < '1' || toRank > '8')
+				return Move::none();
+			const Square to = makeSquare(static_cast<File>(toFile - 'a'), static_cast<Rank>(toRank - '1'));
+			san.remove_suffix(2);
+			if (!san.empty() && san.back() == 'x')
+				san.remove_suffix(1);
+			int fromFile = -1;
+			int fromRank = -1;
+			for (const char c : san) {
+				if (c >= 'a' && c <= 'h')
+					fromFile = c - 'a';
+				else if (c >= '1' && c <= '8')
+					fromRank = c - '1';
+				else
+					return Move::none();
+			}
+
+			Move found = Move::none();
+			for (const ScoredMove& sm : moves) {
+				const Move m = sm.move();
+				if (m.toSq() != to || typeOf(pos.movedPiece(m)) != piece || m.moveType() == CASTLING
+					|| (fromFile >= 0 && fileOf(m.fromSq()) != fromFile) || (fromRank >= 0 && rankOf(m.fromSq()) != fromRank)
+					|| (m.moveType() == PROMOTION ? m.promotionType() : NO_PIECE_TYPE) != promotion)
+					continue;
+				if (found)
+					return Move::none();  // Ambiguous
+				found = m;
+			}
+			return found;
+		}
+	}
+
+	const std::string* Record::operation(const std::string_view opcode) const {
+		for (const auto& [code, operand] : operations)
+			if (code == opcode)
+				return &operand;
+		return nullptr;
+	}
+
+	bool parse(std::string_view line, Record& record) {
+		record.fen.clear();
+		record.operations.clear();
+
+		const std::string_view board = nextToken(line);
+		if (board.empty() || board.front() == '#')
+			return false;
+		const std::string_view side = nextToken(line);
+		const std::string_view castling = nextToken(line);
+		const std::string_view ep = nextToken(line);
+		if (!validBoard(board) || (side != "w" && side != "b") || !validCastling(castling) || !validEnPassant(ep))
+			return false;
+
+		// FEN counters, or EPD operations that may carry them
+		std::string_view rest = line;
+		const std::string_view halfmove = nextToken(rest);
+		const std::string_view fullmove = nextToken(rest);
+		std::array<std::string, 2> counters = { "0", "1" };
+		if (isNumber(halfmove) && isNumber(fullmove)) {
+			counters[0] = halfmove;
+			counters[1] = fullmove;
+			line = rest;
+		}
+		parseOperations(line, record.operations);
+		if (const std::string* hmvc = record.operation("hmvc"); hmvc && isNumber(*hmvc))
+			counters[0] = *hmvc;
+		if (const std::string* fmvn = record.operation("fmvn"); fmvn && isNumber(*fmvn))
+			counters[1] = *fmvn;
+
+		record.fen.append(board).append(" ").append(side).append(" ").append(castlingRights(board, castling)).append(" ").append(ep)
+			.append(" ").append(counters[0]).append(" ").append(counters[1]);
+
+		// The side that just moved must not have left its king in check
+		Position pos;
+		pos.set(record.fen);
+		const Color them = ~pos.sideToMove();
+		return !(pos.attackersTo(pos.kingSquare(them)) & pos.pieces(pos.sideToMove()));
+	}
+
+	Move parseSan(const Position& pos, std::string_view san) {
+		while (!san.empty() && std::string_view("+#!?").find(san.back()) != std::string_view::npos)
+			san.remove_suffix(1);
+		const Move m = sanMove(pos, san);
+		return m ? m : uci::parseMove(pos, san);
+	}
+
+	bool parseMoves(const Position& pos, std::string_view operand, std::vector<Move>& moves) {
+		moves.clear();
+		for (std::string_view token = nextToken(operand); !token.empty(); token = nextToken(operand)) {
+			const Move m = parseSan(pos, token);
+			if (!m)
+				return false;
+			moves.push_back(m);
+		}
+		return true;
+	}
+}
+#pragma warning(pop)
@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "Move.h"
+
+// Epd.h - Parsing of EPD and FEN position lines
+
+namespace chess {
+	class Position;
+}
+
+namespace chess::epd {
+
+	// A position line: the FEN with move counters and the EPD operations after it
+	struct Record {
+		std::string fen;
+
+		// Opcode and operand in line order, quotes removed from string operands
+		std::vector<std::pair<std::string, std::string>> operations;
+
+		// Operand of the first operation with the opcode, null if there is none
+		[[nodiscard]] const std::string* operation(std::string_view opcode) const;
+	};
+
+	// Parses "board side castling ep [halfmove fullmove] [opcode operands; ...]". EPD lines get their
+	// counters from the hmvc and fmvn operations, or 0 and 1. False for blank lines, '#' comments and
+	// boards that are malformed or illegal (no single king per side, pawns on the last ranks, the side
+	// not to move in check); the position must pass this before Position::set. Castling rights whose
+	// king or rook is not on its home square are dropped from the FEN
+	bool parse(std::string_view line, Record& record);
+
+	// The legal move of pos written in standard algebraic notation ("Nbd7", "exd5", "e8=Q+", "O-O"),
+	// check and annotation marks ignored; UCI notation is accepted too. Move::none() if it names no
+	// legal move or more than one
+	[[nodiscard]] Move parseSan(const Position& pos, std::string_view san);
+
+	// The moves of a space-separated list such as a "bm" or "am" operand, false if one is not legal
+	bool parseMoves(const Position& pos, std::string_view operand, std::vector<Move>& moves);
+}
@@ -0,0 +1,178 @@
+#include "EpdTests.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Batch.h"
+#include "Epd.h"
+#include "Position.h"
+#include "Suite.h"
+#include "Types.h"
+
+// EpdTests.cpp - Tests for EPD parsing, the batch analysis of position files and test suites
+
+namespace chess::tests
+{
+	namespace {
+		std::vector<std::string> splitLines(const std::string& text) {
+			std::vector<std::string> lines;
+			std::istringstream in(text);
+			for (std::string line; std::getline(in, line);)
+				lines.push_back(line);
+			return lines;
+		}
+	}
+
+	// Test FEN and EPD lines, operations and the rejection of malformed positions
+	void testEpdParse() {
+		epd::Record record;
+		bool success = epd::parse(std::string(START_FEN), record) && record.fen == START_FEN && record.operations.empty();
+
+		success &= epd::parse("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - bm Bb5; id \"test 1\"; c0 \"a; b\";", record);
+		success &= record.fen == "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 0 1";
+		success &= record.operations.size() == 3 && record.operation("bm") && *record.operation("bm") == "Bb5";
+		success &= record.operation("id") && *record.operation("id") == "test 1";
+		success &= record.operation("c0") && *record.operation("c0") == "a; b" && !record.operation("am");
+
+		success &= epd::parse("4k3/8/8/8/8/8/8/4K3 b - - hmvc 12; fmvn 40; noop;", record);
+		success &= record.fen == "4k3/8/8/8/8/8/8/4K3 b - - 12 40" && record.operation("noop") && record.operation("noop")->empty();
+
+		// Castling rights without the king and rook on their home squares are dropped
+		success &= epd::parse("4k3/8/8/8/8/8/8/4K3 w K - 0 1", record) && record.fen == "4k3/8/8/8/8/8/8/4K3 w - - 0 1";
+		success &= epd::parse("8/8/8/8/8/8/8/k1K5 w KQkq - 0 1", record) && record.fen == "8/8/8/8/8/8/8/k1K5 w - - 0 1";
+		success &= epd::parse("r3k2r/8/8/8/8/8/8/R3K1R1 w KQkq - 0 1", record) && record.fen == "r3k2r/8/8/8/8/8/8/R3K1R1 w Qkq - 0 1";
+
+		for (const char* bad : {
+			"", "   ", "# comment",
+			"4k3/8/8/8/8/8/8/4K3 x - -",                  // Side to move
+			"4k3/8/8/8/8/8/8/4KK2 w - -",                 // Two white kings
+			"4k3/8/8/8/8/8/8 w - -",                      // Seven ranks
+			"4k3/9/8/8/8/8/8/4K3 w - -",                  // Rank too long
+			"4k2P/8/8/8/8/8/8/4K3 w - -",                 // Pawn on the last rank
+			"4k3/8/8/8/8/8/8/4RK2 w - -" })               // Black in check with white to move
+			success &= !epd::parse(bad, record);
+		report("EPD parsing", success);
+	}
+
+	// Test that a batch run writes one result per position line, in input order or tagged by line number
+	void testBatchRun() {
+		const std::string input = tempPath("chess_batch_test.epd");
+		{
+			std::ofstream out(input);
+			out << "# batch test\n"
+				<< START_FEN << "\n"
+				<< "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - id \"two\";\n"
+				<< "\n"
+				<< "not a position\n"
+				<< "4k3/8/8/8/8/8/8/4K2R w K - 0 1\n"
+				<< "k7/8/1K6/8/8/8/8/7R w - - 0 1\r\n"
+				<< "7k/5Q2/6K1/8/8/8/8/8 b - - 0 1\n"
+				<< "4k3/8/8/8/8/8/8/4K3 w K - 0 1\n"
+				<< "8/8/8/8/8/8/8/k1K5 w KQkq - 0 1\n";
+		}
+
+		batch::Options options;
+		options.limits.depth = 4;
+		options.threads = 3;
+		options.hashMb = 1;
+		std::ostringstream ordered;
+		batch::Summary summary;
+		bool success = batch::run(input, ordered, options, summary);
+		const std::vector<std::string> lines = splitLines(ordered.str());
+		success &= summary.positions == 7 && summary.invalid == 1 && summary.threads.size() == 3 && lines.size() == 8;
+		if (lines.size() == 8) {
+			success &= lines[0].rfind(std::string(START_FEN) + ";bestmove ", 0) == 0;
+			success &= lines[1].find(";id two") != std::string::npos;
+			success &= lines[2] == "not a position;error invalid position";
+			success &= lines[4].find(";bestmove h1h8;score mate 1;") != std::string::npos;
+			success &= lines[5].find(";bestmove (none);score cp 0;") != std::string::npos;
+			success &= lines[6].rfind("4k3/8/8/8/8/8/8/4K3 w - - 0 1;bestmove ", 0) == 0;
+			success &= lines[7].rfind("8/8/8/8/8/8/8/k1K5 w - - 0 1;bestmove ", 0) == 0;
+		}
+
+		options.tagged = true;
+		std::ostringstream tagged;
+		success &= batch::run(input, tagged, options, summary);
+		std::set<std::string> numbers;
+		for (const std::string& line : splitLines(tagged.str()))
+			numbers.insert(line.substr(0, line.find(';')));
+		success &= numbers == std::set<std::string>{ "2", "3", "5", "6", "7", "8", "9", "10" };
+
+		success &= !batch::run(tempPath("chess_batch_missing.epd"), tagged, options, summary);
+		std::remove(input.c_str());
+		report("Batch analysis", success);
+	}
+
+	// Test standard algebraic notation with disambiguation, promotions, castling and UCI fallback
+	void testSanParsing() {
+		Position pos;
+		pos.set("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+		bool success = epd::parseSan(pos, "O-O") == Move(E1, G1, CASTLING) && epd::parseSan(pos, "0-0-0") == Move(E1, C1, CASTLING);
+		success &= epd::parseSan(pos, "Nxd7") == Move(E5, D7) && epd::parseSan(pos, "Nxf7!?") == Move(E5, F7);
+		success &= epd::parseSan(pos, "dxe6") == Move(D5, E6) && epd::parseSan(pos, "Qxf6+") == Move(F3, F6);
+		success &= epd::parseSan(pos, "Bxa6") == Move(E2, A6) && epd::parseSan(pos, "e2a6") == Move(E2, A6);
+		success &= epd::parseSan(pos, "Nd3") == Move(E5, D3) && !epd::parseSan(pos, "Nb6");
+		success &= !epd::parseSan(pos, "Ke3") && !epd::parseSan(pos, "") && !epd::parseSan(pos, "xx");
+
+		pos.set("4k3/1P6/8/8/8/8/8/R3K1N1 w Q - 0 1");
+		success &= epd::parseSan(pos, "b8=Q+") == Move(B7, B8, PROMOTION, QUEEN) && epd::parseSan(pos, "b8N") == Move(B7, B8, PROMOTION, KNIGHT);
+		success &= epd::parseSan(pos, "Ne2") == Move(G1, E2) && epd::parseSan(pos, "Rd1") == Move(A1, D1);
+
+		// Both knights reach b3
+		pos.set("4k3/8/8/8/8/8/8/N1N1K3 w - - 0 1");
+		success &= !epd::parseSan(pos, "Nb3") && epd::parseSan(pos, "Nab3") == Move(A1, B3) && epd::parseSan(pos, "Ncb3") == Move(C1, B3);
+
+		pos.set("4k3/1P6/8/8/8/8/8/R3K1N1 w Q - 0 1");
+		std::vector<Move> moves;
+		success &= epd::parseMoves(pos, "b8=Q Rd1", moves) && moves.size() == 2 && !epd::parseMoves(pos, "b8=Q Rd2", moves);
+		report("SAN parsing", success);
+	}
+
+	// Test that a suite run solves simple positions, honours avoid moves and records solve times
+	void testSuiteRun() {
+		const std::string path = tempPath("chess_suite_test.epd");
+		{
+			std::ofstream out(path);
+			out << "k7/8/1K6/8/8/8/8/7R w - - bm Rh8#; id \"mate\";\n"
+				<< "# comment\n"
+				<< "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - am Ng5; id \"avoid\";\n"
+				<< "4k3/8/8/8/8/8/8/4K3 w - - bm Ke8;\n"
+				<< "4k3/8/8/8/8/8/3q4/4K3 w - - bm Kxd2; id \"capture\";\n"
+				<< "this is not a position; bm e4;\n";
+		}
+		suite::Options options;
+		options.limits.nodes = 20000;
+		options.threads = 2;
+		options.hashMb = 1;
+		suite::Summary summary;
+		bool success = suite::run(path, options, summary) && summary.results.size() == 5;
+		success &= summary.positions == 3 && summary.solved == 3 && summary.nodes > 0;
+		if (summary.results.size() == 5) {
+			const suite::PositionResult& mate = summary.results[0];
+			success &= mate.id == "mate" && mate.solved && mate.bestMove == Move(H1, H8) && mate.solveDepth >= 1 && mate.solveNodes > 0;
+			success &= summary.results[1].id == "avoid" && summary.results[1].solved && summary.results[1].bestMove != Move(F3, G5);
+			success &= summary.results[2].id == "line 4" && !summary.results[2].valid;
+			success &= summary.results[3].solved && summary.results[3].bestMove == Move(E1, D2);
+			success &= summary.results[4].id == "line 6" && !summary.results[4].valid;
+		}
+		success &= !suite::run(tempPath("chess_suite_missing.epd"), options, summary);
+		std::remove(path.c_str());
+		report("EPD suite runner", success);
+	}
+
+	// Run all EPD tests
+	void runAllEpdTests() {
+		std::cout << "Running EPD tests...\n" << "\n";
+
+		testEpdParse();
+		testBatchRun();
+		testSanParsing();
+		testSuiteRun();
+
+		std::cout << "\nEPD tests completed." << "\n";
+	}
+}
@@ -0,0 +1,30 @@
+#include "EvalCache.h"
+#include <algorithm>
+#include <bit>
+
+// EvalCache.cpp - Lock-free cache of static evaluations shared by the search threads
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// Entry indices are masked by the power of two table size
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+#pragma warning(disable: 26482)
+
+namespace chess {
+
+	void EvalCache::resize(const size_t mb) {
+		m_entries.reset();
+		m_size = mb ? std::bit_floor(std::max<size_t>(mb * 1024 * 1024 / sizeof(uint64_t), 1)) : 0;
+		if (m_size)
+			m_entries = std::make_unique<std::atomic<uint64_t>[]>(m_size);
+		clear();
+	}
+
+	void EvalCache::clear() noexcept {
+		for (size_t i = 0; i < m_size; ++i)
+			m_entries[i].store(0, std::memory_order_relaxed);
+	}
+}
+#pragma warning(pop)
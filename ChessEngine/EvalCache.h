@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "Types.h"
+
+// EvalCache.h - Lock-free cache of static evaluations shared by the search threads
+
+namespace chess {
+
+	// Direct-mapped table of static evaluations keyed by the position key. An entry is one 64-bit word:
+	// the upper 48 key bits check the position and the low 16 bits hold the value, so a racing read sees
+	// either a whole old entry or a whole new one. Kept apart from the transposition table so evaluations
+	// never take slots from search results. Must be cleared when the evaluation function changes
+	class EvalCache {
+	public:
+		EvalCache() = default;
+		EvalCache(const EvalCache&) = delete;
+		EvalCache& operator=(const EvalCache&) = delete;
+
+		// Allocates about mb megabytes, rounded down to a power of two number of entries, and clears
+		// the table. Zero frees it, the cache must then not be probed
+		void resize(size_t mb);
+		void clear() noexcept;
+
+		// Looks up key, returns true and sets value on a hit
+		bool probe(const HashKey key, Value& value) const noexcept {
+			const uint64_t data = entry(key).load(std::memory_order_relaxed);
+			if ((data ^ key) >> 16)
+				return false;
+			value = static_cast<int16_t>(data);
+			return true;
+		}
+
+		void store(const HashKey key, const Value value) noexcept {
+			assert(value > -VALUE_INFINITE && value < VALUE_INFINITE);
+			entry(key).store((key & ~0xFFFFull) | static_cast<uint16_t>(value), std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] size_t size() const noexcept { return m_size; }
+
+	private:
+		// The low key bits select the entry
+		[[nodiscard]] std::atomic<uint64_t>& entry(const HashKey key) const noexcept {
+			assert(m_size);
+			return m_entries[key & (m_size - 1)];
+		}
+
+		std::unique_ptr<std::atomic<uint64_t>[]> m_entries;
+		size_t m_size = 0;
+	};
+
+	// Probe counts of one thread, kept out of the shared table so threads never write to a common line
+	class EvalCacheCounters {
+	public:
+		void count(const bool hit) noexcept { ++m_probes; m_hits += hit; }
+		void clear() noexcept { m_probes = m_hits = 0; }
+		void merge(const EvalCacheCounters& other) noexcept { m_probes += other.m_probes; m_hits += other.m_hits; }
+
+		[[nodiscard]] uint64_t probes() const noexcept { return m_probes; }
+		[[nodiscard]] uint64_t hits() const noexcept { return m_hits; }
+		[[nodiscard]] double hitRate() const noexcept { return m_probes ? static_cast<double>(m_hits) / static_cast<double>(m_probes) : 0.0; }
+
+	private:
+		uint64_t m_probes = 0;
+		uint64_t m_hits = 0;
+	};
+}
@@ -0,0 +1,114 @@
+#include "EvalCacheTests.h"
+#include <atomic>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "EvalCache.h"
+#include "Position.h"
+#include "ThreadPool.h"
+#include "TranspositionTable.h"
+#include "Types.h"
+
+// EvalCacheTests.cpp - Tests for the static evaluation cache
+
+namespace chess::tests
+{
+	// Test store and probe, including negative values, other keys on the same entry and sizes
+	void testEvalCacheStoreProbe() {
+		bool success = true;
+		EvalCache cache;
+		cache.resize(1);
+		success &= (cache.size() == 1024 * 1024 / 8);
+
+		const HashKey key = 0x123456789ABCDEF0ull;
+		Value v = VALUE_NONE;
+		success &= !cache.probe(key, v);
+		cache.store(key, -1234);
+		success &= (cache.probe(key, v) && v == -1234);
+
+		// Same entry, different upper bits: a miss that replaces the entry
+		const HashKey other = key ^ (1ull << 40);
+		success &= !cache.probe(other, v);
+		cache.store(other, 567);
+		success &= (cache.probe(other, v) && v == 567 && !cache.probe(key, v));
+
+		cache.clear();
+		success &= !cache.probe(other, v);
+		cache.resize(0);
+		success &= (cache.size() == 0);
+
+		report("Eval cache store and probe", success);
+	}
+
+	// Test that racing writers never produce an entry mixing two positions
+	void testEvalCacheConcurrentWrites() {
+		EvalCache cache;
+		cache.resize(1);
+
+		const auto valueFor = [](const HashKey key) { return static_cast<Value>((key >> 48) % 20000) - 10000; };
+
+		std::atomic<int> mismatches{ 0 };
+		std::atomic<int> hits{ 0 };
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; ++t) {
+			threads.emplace_back([&, t] {
+				std::mt19937_64 rng(t);
+				for (int i = 0; i < 200000; ++i) {
+					// Few keys over 64 entries to force collisions between the threads
+					const HashKey r = rng() % 4096;
+					const HashKey key = (r << 48) | (r & 63);
+					Value v;
+					if (cache.probe(key, v)) {
+						hits.fetch_add(1, std::memory_order_relaxed);
+						if (v != valueFor(key))
+							mismatches.fetch_add(1, std::memory_order_relaxed);
+					}
+					cache.store(key, valueFor(key));
+				}
+			});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+		report("Eval cache concurrent writes", hits > 0 && mismatches == 0);
+	}
+
+	// Test that the cache hits in a search without changing it
+	void testEvalCacheSearch() {
+		bool success = true;
+		Position pos;
+		pos.set("r1bq1rk1/ppp1nppp/4n3/3p3Q/3P4/1BP1B3/PP1N2PP/R4RK1 w - - 1 16");
+		search::Limits limits;
+		limits.depth = 7;
+
+		TranspositionTable tt;
+		tt.resize(16);
+		search::ThreadPool pool(tt);
+		pool.setSilent(true);
+		pool.resizeEvalCache(0);
+		const search::Result plain = pool.think(pos, limits);
+		success &= (pool.evalCacheCounters().probes() == 0);
+
+		// Same search again from empty tables and history
+		tt.clear();
+		pool.clearHistory();
+		pool.resizeEvalCache(4);
+		const search::Result cached = pool.think(pos, limits);
+		const EvalCacheCounters counters = pool.evalCacheCounters();
+		success &= (cached.bestMove == plain.bestMove && cached.score == plain.score && cached.nodes == plain.nodes);
+		success &= (counters.probes() > 0 && counters.hits() > 0 && counters.hits() < counters.probes());
+
+		report("Eval cache in search", success);
+	}
+
+	void runAllEvalCacheTests() {
+		std::cout << "Running EvalCache tests...\n" << "\n";
+
+		testEvalCacheStoreProbe();
+		testEvalCacheConcurrentWrites();
+		testEvalCacheSearch();
+
+		std::cout << "\nEvalCache tests completed." << "\n";
+	}
+}
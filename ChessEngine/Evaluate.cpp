@@ -0,0 +1,49 @@
+#include "Evaluate.h"
+#include "Nnue.h"
+
+// Evaluate.cpp - Static evaluation of positions
+
+namespace chess::eval {
+
+	namespace {
+		Value evaluateUncached(const Position& pos, Caches& caches) {
+			// Known endgames are a single probe and a direct call
+			const material::Entry* materialEntry = caches.material.probe(pos);
+			if (materialEntry->specializedEval())
+				return materialEntry->evaluate(pos);
+
+			// A loaded network replaces the hand-crafted terms
+			if (nnue::isLoaded())
+				return nnue::evaluate(pos);
+
+			// Material and piece squares are kept up to date by the position
+			assert(pos.psqConsistent());
+
+			// Pawn structure and king shelter come from the pawn hash
+			pawns::Entry* pawnEntry = caches.pawns.probe(pos);
+			const Score score = pos.psqScore() + materialEntry->imbalance
+				+ pawnEntry->scores[WHITE] - pawnEntry->scores[BLACK]
+				+ pawnEntry->kingSafety(pos, WHITE) - pawnEntry->kingSafety(pos, BLACK);
+
+			// Drawish material scales the endgame part down for the side ahead
+			const Color strongSide = egValue(score) > VALUE_DRAW ? WHITE : BLACK;
+			const Value v = taper(score, materialEntry->phase, materialEntry->scaleFactor(strongSide));
+
+			return (pos.sideToMove() == WHITE ? v : -v) + TEMPO;
+		}
+	}
+
+	Value evaluate(const Position& pos, Caches& caches) {
+		if (!caches.evalCache)
+			return evaluateUncached(pos, caches);
+
+		Value v;
+		const bool hit = caches.evalCache->probe(pos.key(), v);
+		caches.evalCacheCounters.count(hit);
+		if (!hit) {
+			v = evaluateUncached(pos, caches);
+			caches.evalCache->store(pos.key(), v);
+		}
+		return v;
+	}
+}
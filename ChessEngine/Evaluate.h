@@ -0,0 +1,32 @@
+#pragma once
+#include "EvalCache.h"
+#include "Material.h"
+#include "Pawns.h"
+#include "Position.h"
+#include "Types.h"
+
+// Evaluate.h - Static evaluation of positions
+
+namespace chess::eval {
+
+	// Small bonus for the side to move
+	constexpr Value TEMPO = 12;
+
+	// Hash tables the evaluation caches its terms in, each search thread owns one set
+	struct Caches {
+		pawns::Table pawns;
+		material::Table material;
+
+		// Whole evaluations, shared with the other threads; none when null
+		EvalCache* evalCache = nullptr;
+		EvalCacheCounters evalCacheCounters;
+	};
+
+	// Interpolates between the midgame and the scaled endgame value of a score by game phase
+	[[nodiscard]] constexpr Value taper(const Score s, const int phase, const int scale = material::SCALE_FACTOR_NORMAL) {
+		return (mgValue(s) * phase + egValue(s) * scale / material::SCALE_FACTOR_NORMAL * (PHASE_MIDGAME - phase)) / PHASE_MIDGAME;
+	}
+
+	// Static evaluation from the side to move's point of view
+	Value evaluate(const Position& pos, Caches& caches);
+}
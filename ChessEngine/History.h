@@ -0,0 +1,47 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include "Move.h"
+#include "Types.h"
+
+// History.h - Move ordering statistics collected during search
+
+namespace chess {
+
+	// Entries of each history table stay within [-HISTORY_MAX, HISTORY_MAX], so the sum of the
+	// three tables a quiet move is scored with still fits the 16-bit score of a ScoredMove
+	constexpr int HISTORY_MAX = 8192;
+
+	// Gravity update: the bonus shrinks as the entry approaches the bound, so entries saturate
+	// smoothly and old results fade instead of being clipped
+	inline void updateHistory(int16_t& entry, const int bonus) {
+		const int b = std::clamp(bonus, -HISTORY_MAX, HISTORY_MAX);
+		entry = static_cast<int16_t>(entry + b - entry * std::abs(b) / HISTORY_MAX);
+	}
+
+	// Butterfly history: quiet move success indexed by [color][from-to squares]
+	using ButterflyHistory = std::array<std::array<int16_t, SQUARE_NB * SQUARE_NB>, COLOR_NB>;
+
+	// Two killer moves (quiet moves that caused a beta cutoff) per ply
+	using KillerMoves = std::array<Move, 2>;
+
+	// Counter moves: the quiet move that refuted a move, indexed by [moved piece][to square] of that move
+	using CounterMoveHistory = std::array<std::array<Move, SQUARE_NB>, PIECE_NB>;
+
+	// Quiet move success indexed by [piece][to square], one table per preceding move
+	using PieceToHistory = std::array<std::array<int16_t, SQUARE_NB>, PIECE_NB>;
+
+	// Continuation history: [piece][to square] of a preceding move selects the 2 KB table the
+	// current move is scored in, so a node only touches the few tables of its preceding moves.
+	// [NO_PIECE][0] is a sentinel for null moves and the plies before the root that is never updated
+	using ContinuationHistory = std::array<std::array<PieceToHistory, SQUARE_NB>, PIECE_NB>;
+
+	// History a move picker scores quiet moves with, any table may be missing
+	struct MoveHistories {
+		const ButterflyHistory* butterfly = nullptr;
+		std::array<const PieceToHistory*, 2> continuation{};  // Tables of the moves one and two plies ago
+		Move counterMove = Move::none();
+	};
+}
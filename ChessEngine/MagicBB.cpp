@@ -273,4 +273,15 @@ namespace chess {
 	Bitboard getQueenAttacks(const Square sq, const Bitboard occupied) {
 		return getBishopAttacks(sq, occupied) | getRookAttacks(sq, occupied);
 	}
+
+	// Gets attacks of any non-pawn piece type, sliders see the given occupancy
+	Bitboard getAttacks(const PieceType pt, const Square sq, const Bitboard occupied) {
+		assert(pt != PAWN && isSquare(sq));
+		switch (pt) {
+		case BISHOP: return getBishopAttacks(sq, occupied);
+		case ROOK:   return getRookAttacks(sq, occupied);
+		case QUEEN:  return getQueenAttacks(sq, occupied);
+		default:     return g_pseudoAttacks.at(pt).at(sq);
+		}
+	}
 }
\ No newline at end of file
@@ -43,6 +43,7 @@ namespace chess {
 	Bitboard getBishopAttacks(Square sq, Bitboard occupied);  // Bishop attacks
 	Bitboard getRookAttacks(Square sq, Bitboard occupied);    // Rook attacks
 	Bitboard getQueenAttacks(Square sq, Bitboard occupied);   // Queen attacks (bishop + rook)
+	Bitboard getAttacks(PieceType pt, Square sq, Bitboard occupied);  // Attacks of any non-pawn piece
 
 	// Helper functions for initialization
 	MagicResult findMagic(Square square, PieceType pieceType);  // Find a magic number
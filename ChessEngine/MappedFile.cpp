@@ -0,0 +1,83 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// MappedFile.cpp - Read-only memory mapping of a whole file
+
+namespace chess {
+
+	bool MappedFile::open(const std::string& path) {
+		close();
+#ifdef _WIN32
+		const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+		LARGE_INTEGER size;
+		const bool sized = GetFileSizeEx(file, &size) && size.QuadPart > 0;
+		const HANDLE mapping = sized ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+		CloseHandle(file);
+		if (!mapping)
+			return false;
+		const void* base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!base) {
+			CloseHandle(mapping);
+			return false;
+		}
+		m_mapping = mapping;
+		m_data = static_cast<const uint8_t*>(base);
+		m_size = static_cast<size_t>(size.QuadPart);
+#else
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd == -1)
+			return false;
+		struct stat st {};
+		if (fstat(fd, &st) || st.st_size <= 0) {
+			::close(fd);
+			return false;
+		}
+		void* base = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (base == MAP_FAILED)
+			return false;
+		madvise(base, static_cast<size_t>(st.st_size), MADV_RANDOM);
+		m_data = static_cast<const uint8_t*>(base);
+		m_size = static_cast<size_t>(st.st_size);
+#endif
+		return true;
+	}
+
+	void MappedFile::close() {
+		if (!m_data)
+			return;
+#ifdef _WIN32
+		UnmapViewOfFile(m_data);
+		CloseHandle(m_mapping);
+#else
+		munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+		m_data = nullptr;
+		m_size = 0;
+		m_mapping = nullptr;
+	}
+
+	void MappedFile::adviseSequential() const {
+#ifndef _WIN32
+		if (m_data)
+			madvise(const_cast<uint8_t*>(m_data), m_size, MADV_SEQUENTIAL);
+#endif
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// MappedFile.h - Read-only memory mapping of a whole file
+
+namespace chess {
+
+	// Pages are read by the OS on first touch, so large files cost nothing until used. The mapping
+	// is opened for random access; sequential readers can ask for read-ahead with adviseSequential
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile() { close(); }
+
+		// Maps the file, false if it is missing, empty or cannot be mapped. Closes any previous mapping
+		bool open(const std::string& path);
+		void close();
+
+		// Hints that the mapping will be read front to back
+		void adviseSequential() const;
+
+		[[nodiscard]] bool isOpen() const noexcept { return m_data != nullptr; }
+		[[nodiscard]] const uint8_t* data() const noexcept { return m_data; }
+		[[nodiscard]] size_t size() const noexcept { return m_size; }
+
+	private:
+		const uint8_t* m_data = nullptr;
+		size_t m_size = 0;
+		void* m_mapping = nullptr;  // Mapping object handle on Windows
+	};
+}
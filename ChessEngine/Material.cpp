@@ -0,0 +1,123 @@
+#include "Material.h"
+#include <algorithm>
+
+// Material.cpp - Material configuration terms cached in a per-thread hash table keyed by the material key
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// Piece types and colors index fixed size tables, the table
+// index is masked by the power of two table size
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+#pragma warning(disable: 26482)
+
+namespace chess::material {
+
+	namespace {
+		// Second-degree polynomial imbalance, index 0 stands for the bishop pair. Row is the piece
+		// getting the bonus, column the piece counted with it, our own or the opponent's
+		constexpr int QUADRATIC_OURS[][PIECE_TYPE_NB] = {
+			//  pair  pawn knight bishop  rook queen
+			{ 1438 },                                   // Bishop pair
+			{   40,   38 },                             // Pawn
+			{   32,  255,  -62 },                       // Knight
+			{    0,  104,    4,    0 },                 // Bishop
+			{  -26,   -2,   47,  105, -208 },           // Rook
+			{ -189,   24,  117,  133, -134,   -6 }      // Queen
+		};
+		constexpr int QUADRATIC_THEIRS[][PIECE_TYPE_NB] = {
+			//  pair  pawn knight bishop  rook queen
+			{    0 },                                   // Bishop pair
+			{   36,    0 },                             // Pawn
+			{    9,   63,    0 },                       // Knight
+			{   59,   65,   42,    0 },                 // Bishop
+			{   46,   39,   24,  -24,    0 },           // Rook
+			{   97,  100,  -42,  137,  268,    0 }      // Queen
+		};
+
+		using PieceCounts = std::array<std::array<int, PIECE_TYPE_NB>, COLOR_NB>;
+
+		template<Color Us>
+		int imbalance(const PieceCounts& counts) {
+			constexpr Color Them = ~Us;
+			int bonus = 0;
+			for (int pt1 = NO_PIECE_TYPE; pt1 <= QUEEN; ++pt1) {
+				if (!counts[Us][pt1])
+					continue;
+				int v = 0;
+				for (int pt2 = NO_PIECE_TYPE; pt2 <= pt1; ++pt2)
+					v += QUADRATIC_OURS[pt1][pt2] * counts[Us][pt2] + QUADRATIC_THEIRS[pt1][pt2] * counts[Them][pt2];
+				bonus += counts[Us][pt1] * v;
+			}
+			return bonus;
+		}
+
+		// Lone king against at least a rook's worth of pieces
+		bool isKXK(const Position& pos, const Color us) {
+			return !pos.pieces(~us, PAWN) && pos.nonPawnMaterial(~us) == VALUE_ZERO && pos.nonPawnMaterial(us) >= RookValue;
+		}
+
+		// Endgame scale for us as the stronger side in drawish material configurations
+		uint8_t scaleFactor(const Position& pos, const Color us) {
+			const Value npmUs = pos.nonPawnMaterial(us);
+			const Value npmThem = pos.nonPawnMaterial(~us);
+
+			// Without pawns a piece up is not enough, a minor piece more is a draw
+			if (!pos.count(us, PAWN) && npmUs - npmThem <= BishopValue)
+				return npmUs < RookValue ? SCALE_FACTOR_DRAW : npmThem <= BishopValue ? 4 : 14;
+
+			// A single pawn and no real piece advantage is hard to convert
+			if (pos.count(us, PAWN) == 1 && npmUs - npmThem <= BishopValue)
+				return SCALE_FACTOR_ONEPAWN;
+
+			return SCALE_FACTOR_NORMAL;
+		}
+	}
+
+	Entry* Table::probe(const Position& pos) {
+		const HashKey key = pos.materialKey();
+		Entry* entry = &m_entries[key & (SIZE - 1)];
+		++m_probes;
+		if (entry->key == key) {
+			++m_hits;
+			return entry;
+		}
+		evaluate(pos, *entry);
+		return entry;
+	}
+
+	void Table::clear() {
+		std::fill(m_entries.begin(), m_entries.end(), Entry{});
+		m_probes = m_hits = 0;
+	}
+
+	void evaluate(const Position& pos, Entry& entry) {
+		entry = Entry{};
+		entry.key = pos.materialKey();
+		entry.phase = pos.gamePhase();
+
+		// Known endgames replace the evaluation, the rest of the entry is then unused
+		entry.endgame = endgames::probe(entry.key);
+		if (entry.specializedEval())
+			return;
+		for (const Color c : { WHITE, BLACK })
+			if (isKXK(pos, c)) {
+				entry.endgame = endgames::Endgame{ endgames::evaluateKXK, c };
+				return;
+			}
+
+		entry.factor[WHITE] = scaleFactor(pos, WHITE);
+		entry.factor[BLACK] = scaleFactor(pos, BLACK);
+
+		PieceCounts counts{};
+		for (const Color c : { WHITE, BLACK }) {
+			counts[c][NO_PIECE_TYPE] = pos.count(c, BISHOP) > 1;
+			for (PieceType pt = PAWN; pt <= QUEEN; ++pt)
+				counts[c][pt] = pos.count(c, pt);
+		}
+		const int v = (imbalance<WHITE>(counts) - imbalance<BLACK>(counts)) / 16;
+		entry.imbalance = makeScore(v, v);
+	}
+}
+#pragma warning(pop)
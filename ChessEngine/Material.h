@@ -0,0 +1,59 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Endgame.h"
+#include "Position.h"
+#include "Types.h"
+
+// Material.h - Material configuration terms cached in a per-thread hash table keyed by the material key
+
+namespace chess::material {
+
+	// Scale applied to the endgame part of the evaluation, SCALE_FACTOR_NORMAL leaves it unchanged
+	constexpr int SCALE_FACTOR_DRAW = 0;
+	constexpr int SCALE_FACTOR_ONEPAWN = 48;
+	constexpr int SCALE_FACTOR_NORMAL = 64;
+
+	// Evaluation terms depending only on the material of both sides
+	struct Entry {
+		HashKey key = 0;
+		Score imbalance = SCORE_ZERO;                    // From white's point of view
+		int phase = PHASE_MIDGAME;
+		std::array<uint8_t, COLOR_NB> factor{};          // Endgame scale when the color is the stronger side
+		endgames::Endgame endgame;                       // Replaces the evaluation for known endgames
+
+		[[nodiscard]] bool specializedEval() const { return endgame.eval != nullptr; }
+
+		// Specialised evaluation from the side to move's point of view
+		[[nodiscard]] Value evaluate(const Position& pos) const {
+			const Value v = endgame.eval(pos, endgame.strongSide);
+			return pos.sideToMove() == endgame.strongSide ? v : -v;
+		}
+		[[nodiscard]] int scaleFactor(const Color c) const { return factor[c]; }
+	};
+
+	// Hash table of material entries, each search thread owns one so there is no locking
+	class Table {
+	public:
+		static constexpr size_t SIZE = 8192;  // Power of two
+
+		Table() : m_entries(SIZE) {}
+
+		// Entry for the material configuration of the position, computed on a miss
+		[[nodiscard]] Entry* probe(const Position& pos);
+		void clear();
+
+		[[nodiscard]] uint64_t probes() const { return m_probes; }
+		[[nodiscard]] uint64_t hits() const { return m_hits; }
+		[[nodiscard]] double hitRate() const { return m_probes ? static_cast<double>(m_hits) / static_cast<double>(m_probes) : 0.0; }
+
+	private:
+		std::vector<Entry> m_entries;
+		uint64_t m_probes = 0;
+		uint64_t m_hits = 0;
+	};
+
+	// Computes the material terms of the position into the entry from scratch
+	void evaluate(const Position& pos, Entry& entry);
+}
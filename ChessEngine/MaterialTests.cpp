@@ -0,0 +1,115 @@
+#include "MaterialTests.h"
+#include <iostream>
+
+#include "Endgame.h"
+#include "Material.h"
+#include "Position.h"
+#include "Types.h"
+
+// MaterialTests.cpp - Tests for the material table
+
+namespace chess::tests
+{
+	// Test the game phase at both ends and that the imbalance is antisymmetric
+	void testPhaseAndImbalance() {
+		bool success = true;
+		Position pos;
+		material::Entry entry;
+
+		pos.set(START_FEN);
+		material::evaluate(pos, entry);
+		success &= (entry.phase == PHASE_MIDGAME && entry.imbalance == SCORE_ZERO);
+
+		pos.set("4k3/pppp4/8/8/8/8/PPPP4/4K3 w - - 0 1");
+		material::evaluate(pos, entry);
+		success &= (entry.phase == PHASE_ENDGAME);
+
+		// Bishop pair against bishop and knight, then with the colors swapped
+		pos.set("2b1kb2/pppppppp/8/8/8/8/PPPPPPPP/2B1KN2 w - - 0 1");
+		material::evaluate(pos, entry);
+		const Score blackPair = entry.imbalance;
+		pos.set("2b1kn2/pppppppp/8/8/8/8/PPPPPPPP/2B1KB2 w - - 0 1");
+		material::evaluate(pos, entry);
+		success &= (entry.imbalance == -blackPair && mgValue(entry.imbalance) > 0);
+
+		report("Phase and imbalance", success);
+	}
+
+	// Test the scale factors of drawish material
+	void testScaleFactors() {
+		bool success = true;
+		Position pos;
+		material::Entry entry;
+
+		// A lone minor piece can't win
+		pos.set("8/8/3k4/8/8/3NK3/8/8 w - - 0 1");
+		material::evaluate(pos, entry);
+		success &= (!entry.specializedEval() && entry.scaleFactor(WHITE) == material::SCALE_FACTOR_DRAW);
+
+		// Rook and pawn against rook
+		pos.set("8/3k4/8/3r4/8/3PK3/8/3R4 w - - 0 1");
+		material::evaluate(pos, entry);
+		success &= (entry.scaleFactor(WHITE) == material::SCALE_FACTOR_ONEPAWN);
+		success &= (entry.scaleFactor(BLACK) != material::SCALE_FACTOR_NORMAL);
+
+		pos.set(START_FEN);
+		material::evaluate(pos, entry);
+		success &= (entry.scaleFactor(WHITE) == material::SCALE_FACTOR_NORMAL && entry.scaleFactor(BLACK) == material::SCALE_FACTOR_NORMAL);
+
+		report("Scale factors", success);
+	}
+
+	// Test that known endgames and a lone king are dispatched to their evaluation
+	void testSpecializedDispatch() {
+		bool success = true;
+		Position pos;
+		material::Entry entry;
+
+		pos.set("8/8/8/3k4/8/8/8/1q2K3 w - - 0 1");
+		material::evaluate(pos, entry);
+		success &= (entry.endgame.eval == endgames::evaluateKXK && entry.endgame.strongSide == BLACK);
+		success &= (entry.evaluate(pos) < -endgames::VALUE_KNOWN_WIN);
+
+		pos.set("4k3/8/4K3/4P3/8/8/8/8 b - - 0 1");
+		material::evaluate(pos, entry);
+		success &= (entry.endgame.eval == endgames::evaluateKPK && entry.evaluate(pos) < -endgames::VALUE_KNOWN_WIN);
+
+		pos.set("4k3/8/8/8/8/8/8/1NN1K3 w - - 0 1");
+		material::evaluate(pos, entry);
+		success &= (entry.specializedEval() && entry.evaluate(pos) == VALUE_DRAW);
+
+		report("Specialised endgame dispatch", success);
+	}
+
+	// Test that the table caches entries per material key and counts hits
+	void testMaterialTable() {
+		bool success = true;
+		material::Table table;
+		Position pos;
+
+		pos.set(START_FEN);
+		const material::Entry* first = table.probe(pos);
+		success &= (table.probes() == 1 && table.hits() == 0);
+
+		// A quiet move keeps the material key
+		StateInfo st;
+		pos.doMove(Move(E2, E4), st);
+		success &= (table.probe(pos) == first && table.hits() == 1 && table.hitRate() == 0.5);
+
+		table.clear();
+		success &= (table.probes() == 0 && table.hits() == 0);
+
+		report("Material hash table", success);
+	}
+
+	void runAllMaterialTests() {
+		std::cout << "Running Material tests...\n" << "\n";
+
+		testPhaseAndImbalance();
+		testScaleFactors();
+		testSpecializedDispatch();
+		testMaterialTable();
+
+		std::cout << "\nMaterial tests completed." << "\n";
+	}
+}
@@ -1,6 +1,4 @@
 #include "Move.h"
-#include "BitBoard.h"
-#include <sstream>
 
 namespace chess {
 	// Convert a move to a human-readable string
@@ -10,36 +8,34 @@ namespace chess {
 		if (*this == null())
 			return "null";
 
-		// Get square names using your existing utility
-		std::string from = squareToString(fromSq());
-		std::string to = squareToString(toSq());
+		char buffer[MAX_STRING_LENGTH];
+		return std::string(buffer, format(buffer));
+	}
 
-		std::stringstream ss;
+	// Write the move in UCI notation without allocating
+	char* Move::format(char* buffer) const noexcept {
+		assert(buffer);
+		char* out = buffer;
 
-		// Handle castling moves specially
-		if (moveType() == CASTLING) {
-			// Determine kingside or queenside based on the squares
-			const bool isKingside = toSq() > fromSq();
-			ss << (isKingside ? "O-O" : "O-O-O");
-			return ss.str();
+		// UCI uses "0000" for the null move (and for no move at all)
+		if (!validMove()) {
+			for (int i = 0; i < 4; ++i)
+				*out++ = '0';
+			*out = '\0';
+			return out;
 		}
 
-		// Add origin and destination
-		ss << from << to;
+		// Castling is stored as the king's move, which is exactly what UCI expects
+		*out++ = gsl::narrow_cast<char>('a' + fileOf(fromSq()));
+		*out++ = gsl::narrow_cast<char>('1' + rankOf(fromSq()));
+		*out++ = gsl::narrow_cast<char>('a' + fileOf(toSq()));
+		*out++ = gsl::narrow_cast<char>('1' + rankOf(toSq()));
 
 		// Add promotion piece if applicable
-		if (moveType() == PROMOTION) {
-			char promotionChar = ' ';
-			switch (promotionType()) {
-			case KNIGHT: promotionChar = 'n'; break;
-			case BISHOP: promotionChar = 'b'; break;
-			case ROOK:   promotionChar = 'r'; break;
-			case QUEEN:  promotionChar = 'q'; break;
-			default: break;
-			}
-			ss << promotionChar;
-		}
+		if (moveType() == PROMOTION)
+			*out++ = " pnbrqk"[promotionType()];
 
-		return ss.str();
+		*out = '\0';
+		return out;
 	}
-}
\ No newline at end of file
+}
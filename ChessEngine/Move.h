@@ -66,6 +66,14 @@ public:
 	// Conversion to string (for debugging and display)
 	[[nodiscard]] std::string toString() const;
 
+	// Writes the move in UCI long algebraic notation ("e2e4", "e7e8q", castling as the king move "e1g1",
+	// null move "0000") into a caller-supplied buffer of at least MAX_STRING_LENGTH chars.
+	// The string is null-terminated, returns a pointer to the terminator so calls can be chained
+	char* format(char* buffer) const noexcept;
+
+	// Longest formatted move (from, to, promotion piece) including the terminator
+	static constexpr int MAX_STRING_LENGTH = 6;
+
 	// Comparison operators
 	constexpr bool operator==(const Move& m) const = default;
 
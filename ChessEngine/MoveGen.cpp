@@ -0,0 +1,226 @@
+#include "MoveGen.h"
+#include "BitBoard.h"
+#include "MagicBB.h"
+
+// MoveGen.cpp - Pseudo-legal and legal move generation
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// Move generation indexes lookup tables with squares taken from
+// bitboards, which are always valid
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+#pragma warning(disable: 26482)
+
+namespace chess {
+
+	namespace {
+
+		// Adds promotions of the pawn moving to square "to" along direction D
+		template<GenType Type, Direction D>
+		void makePromotions(MoveList& moveList, const Square to) {
+			const Square from = to - D;
+			if constexpr (Type == CAPTURES || Type == EVASIONS || Type == NON_EVASIONS)
+				moveList.add(Move(from, to, PROMOTION, QUEEN));
+			if constexpr (Type == QUIETS || Type == EVASIONS || Type == NON_EVASIONS) {
+				moveList.add(Move(from, to, PROMOTION, ROOK));
+				moveList.add(Move(from, to, PROMOTION, BISHOP));
+				moveList.add(Move(from, to, PROMOTION, KNIGHT));
+			}
+		}
+
+		// Adds all pawn moves to squares in target (target only restricts pushes and evasions)
+		template<Color Us, GenType Type>
+		void generatePawnMoves(const Position& pos, MoveList& moveList, const Bitboard target) {
+			constexpr Color Them = ~Us;
+			constexpr Direction Up = pawnPush(Us);
+			constexpr Direction UpRight = Us == WHITE ? NORTH_EAST : SOUTH_WEST;
+			constexpr Direction UpLeft = Us == WHITE ? NORTH_WEST : SOUTH_EAST;
+			constexpr Bitboard Rank7 = Us == WHITE ? RANK_MASK_7 : RANK_MASK_2;
+			constexpr Bitboard Rank3 = Us == WHITE ? RANK_MASK_3 : RANK_MASK_6;
+
+			const Bitboard emptySquares = ~pos.pieces();
+			const Bitboard enemies = Type == EVASIONS ? pos.checkers() : pos.pieces(Them);
+			const Bitboard pawnsOn7 = pos.pieces(Us, PAWN) & Rank7;
+			const Bitboard pawnsNotOn7 = pos.pieces(Us, PAWN) & ~Rank7;
+
+			// Single and double pushes, no promotions
+			if constexpr (Type != CAPTURES) {
+				Bitboard b1 = shift<Up>(pawnsNotOn7) & emptySquares;
+				Bitboard b2 = shift<Up>(b1 & Rank3) & emptySquares;
+				if constexpr (Type == EVASIONS) {
+					// Only blocking squares
+					b1 &= target;
+					b2 &= target;
+				}
+				while (b1) {
+					const Square to = popLsb(b1);
+					moveList.add(Move(to - Up, to));
+				}
+				while (b2) {
+					const Square to = popLsb(b2);
+					moveList.add(Move(to - Up - Up, to));
+				}
+			}
+
+			// Promotions and under-promotions
+			if (pawnsOn7) {
+				Bitboard b1 = shift<UpRight>(pawnsOn7) & enemies;
+				Bitboard b2 = shift<UpLeft>(pawnsOn7) & enemies;
+				Bitboard b3 = shift<Up>(pawnsOn7) & emptySquares;
+				if constexpr (Type == EVASIONS)
+					b3 &= target;
+				while (b1)
+					makePromotions<Type, UpRight>(moveList, popLsb(b1));
+				while (b2)
+					makePromotions<Type, UpLeft>(moveList, popLsb(b2));
+				while (b3)
+					makePromotions<Type, Up>(moveList, popLsb(b3));
+			}
+
+			// Standard and en passant captures
+			if constexpr (Type == CAPTURES || Type == EVASIONS || Type == NON_EVASIONS) {
+				Bitboard b1 = shift<UpRight>(pawnsNotOn7) & enemies;
+				Bitboard b2 = shift<UpLeft>(pawnsNotOn7) & enemies;
+				while (b1) {
+					const Square to = popLsb(b1);
+					moveList.add(Move(to - UpRight, to));
+				}
+				while (b2) {
+					const Square to = popLsb(b2);
+					moveList.add(Move(to - UpLeft, to));
+				}
+
+				if (pos.epSquare() != NO_SQUARE) {
+					assert(relativeRank(Us, pos.epSquare()) == RANK_6);
+
+					// An en passant capture can only evade a check by the pawn that just double pushed
+					if (Type == EVASIONS && (target & squareToBB(pos.epSquare() + Up)))
+						return;
+
+					b1 = pawnsNotOn7 & g_pawnAttacks[Them][pos.epSquare()];
+					while (b1)
+						moveList.add(Move(popLsb(b1), pos.epSquare(), EN_PASSANT));
+				}
+			}
+		}
+
+		// Adds knight, bishop, rook and queen moves to squares in target
+		template<Color Us, PieceType Pt>
+		void generatePieceMoves(const Position& pos, MoveList& moveList, const Bitboard target) {
+			static_assert(Pt != KING && Pt != PAWN, "Unsupported piece type in generatePieceMoves()");
+			Bitboard bb = pos.pieces(Us, Pt);
+			while (bb) {
+				const Square from = popLsb(bb);
+				Bitboard b = getAttacks(Pt, from, pos.pieces()) & target;
+				while (b)
+					moveList.add(Move(from, popLsb(b)));
+			}
+		}
+
+		template<Color Us, GenType Type>
+		void generateAll(const Position& pos, MoveList& moveList) {
+			static_assert(Type != LEGAL, "Unsupported type in generateAll()");
+			const Square kingSq = pos.kingSquare(Us);
+			Bitboard target = 0;
+
+			// With a double check only king moves can help
+			if (Type != EVASIONS || !moreThanOne(pos.checkers())) {
+				if constexpr (Type == EVASIONS) {
+					// Capture the checker or block the line between it and the king
+					const Square checkerSq = lsb(pos.checkers());
+					target = g_betweenBB[kingSq][checkerSq] | squareToBB(checkerSq);
+				}
+				else if constexpr (Type == NON_EVASIONS)
+					target = ~pos.pieces(Us);
+				else if constexpr (Type == CAPTURES)
+					target = pos.pieces(~Us);
+				else
+					target = ~pos.pieces();
+
+				generatePawnMoves<Us, Type>(pos, moveList, target);
+				generatePieceMoves<Us, KNIGHT>(pos, moveList, target);
+				generatePieceMoves<Us, BISHOP>(pos, moveList, target);
+				generatePieceMoves<Us, ROOK>(pos, moveList, target);
+				generatePieceMoves<Us, QUEEN>(pos, moveList, target);
+			}
+
+			// King moves, legality of the destination is checked by Position::legal()
+			Bitboard b = g_pseudoAttacks[KING][kingSq] & (Type == EVASIONS ? ~pos.pieces(Us) : target);
+			while (b)
+				moveList.add(Move(kingSq, popLsb(b)));
+
+			// Castling, encoded as the king's two-square move
+			if constexpr (Type == QUIETS || Type == NON_EVASIONS) {
+				assert(!pos.checkers());
+				for (const CastlingRights side : { KING_SIDE, QUEEN_SIDE }) {
+					const auto cr = static_cast<CastlingRights>((Us == WHITE ? WHITE_CASTLING : BLACK_CASTLING) & side);
+					if (pos.canCastle(cr) && !pos.castlingImpeded(cr))
+						moveList.add(Move(kingSq, relativeSquare(Us, side == KING_SIDE ? G1 : C1), CASTLING));
+				}
+			}
+		}
+	}
+
+	template<GenType Type>
+	void generate(const Position& pos, MoveList& moveList) {
+		static_assert(Type != LEGAL, "Unsupported type in generate()");
+		assert((Type == EVASIONS) == static_cast<bool>(pos.checkers()) || Type == CAPTURES);
+
+		if (pos.sideToMove() == WHITE)
+			generateAll<WHITE, Type>(pos, moveList);
+		else
+			generateAll<BLACK, Type>(pos, moveList);
+	}
+
+	// Explicit instantiations
+	template void generate<CAPTURES>(const Position&, MoveList&);
+	template void generate<QUIETS>(const Position&, MoveList&);
+	template void generate<EVASIONS>(const Position&, MoveList&);
+	template void generate<NON_EVASIONS>(const Position&, MoveList&);
+
+	// Generates all legal moves by filtering pseudo-legal ones,
+	// only pinned pieces, king moves and en passant can be illegal
+	template<>
+	void generate<LEGAL>(const Position& pos, MoveList& moveList) {
+		const Color us = pos.sideToMove();
+		const Bitboard pinned = pos.blockersForKing(us) & pos.pieces(us);
+		const Square kingSq = pos.kingSquare(us);
+		const int first = moveList.size();
+
+		if (pos.checkers())
+			generate<EVASIONS>(pos, moveList);
+		else
+			generate<NON_EVASIONS>(pos, moveList);
+
+		for (int i = first; i < moveList.size(); ) {
+			const Move m = moveList[i];
+			if (((pinned & squareToBB(m.fromSq())) || m.fromSq() == kingSq || m.moveType() == EN_PASSANT)
+				&& !pos.legal(m))
+				moveList.remove(i);
+			else
+				++i;
+		}
+	}
+
+	uint64_t perft(Position& pos, const int depth) {
+		if (depth <= 0)
+			return 1;
+
+		MoveList moveList;
+		generate<LEGAL>(pos, moveList);
+		if (depth == 1)
+			return static_cast<uint64_t>(moveList.size());
+
+		uint64_t nodes = 0;
+		StateInfo state;
+		for (const ScoredMove& sm : moveList) {
+			pos.doMove(sm.move(), state);
+			nodes += perft(pos, depth - 1);
+			pos.undoMove(sm.move());
+		}
+		return nodes;
+	}
+}
+#pragma warning(pop)
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include "MoveList.h"
+#include "Position.h"
+
+// MoveGen.h - Pseudo-legal and legal move generation
+
+namespace chess {
+
+	// Kinds of move lists the generator can produce
+	enum GenType {
+		CAPTURES,      // Captures, en passant and queen promotions
+		QUIETS,        // Non-captures, castling and under-promotions
+		EVASIONS,      // Check evasions (only when in check)
+		NON_EVASIONS,  // Captures and quiets (only when not in check)
+		LEGAL          // All legal moves
+	};
+
+	// Appends the generated moves to moveList (the list is not cleared)
+	template<GenType Type>
+	void generate(const Position& pos, MoveList& moveList);
+	template<>
+	void generate<LEGAL>(const Position& pos, MoveList& moveList);
+
+	// Counts leaf nodes of the legal move tree to the given depth (move generator verification)
+	uint64_t perft(Position& pos, int depth);
+}
@@ -0,0 +1,89 @@
+#include "MoveGenTests.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "MoveGen.h"
+#include "Position.h"
+#include "Types.h"
+
+// MoveGenTests.cpp - Perft and generator consistency tests
+
+namespace chess::tests
+{
+	struct PerftCase {
+		std::string fen;
+		int depth;
+		uint64_t nodes;
+	};
+
+	// Well known perft positions (chessprogramming.org), kept at shallow depths
+	const std::vector<PerftCase> PERFT_CASES = {
+		{ START_FEN, 4, 197281 },
+		{ "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862 },
+		{ "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624 },
+		{ "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333 },
+		{ "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379 },
+		{ "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 3, 89890 }
+	};
+
+	// Test leaf node counts against reference values
+	void testPerft() {
+		for (const auto& [fen, depth, expected] : PERFT_CASES) {
+			Position pos;
+			pos.set(fen);
+			const uint64_t nodes = perft(pos, depth);
+			if (nodes != expected)
+				std::cout << "Perft(" << depth << ") of " << fen << ": " << nodes << ", expected " << expected << "\n";
+			report("Perft " + std::to_string(depth) + " " + fen, nodes == expected);
+		}
+	}
+
+	// Test that captures and quiets together equal the non-evasion list
+	void testGenTypeSplit() {
+		bool success = true;
+		for (const auto& c : PERFT_CASES) {
+			Position pos;
+			pos.set(c.fen);
+			if (pos.checkers())
+				continue;
+			MoveList all, split;
+			generate<NON_EVASIONS>(pos, all);
+			generate<CAPTURES>(pos, split);
+			generate<QUIETS>(pos, split);
+
+			success &= all.size() == split.size();
+			for (const ScoredMove& sm : split)
+				success &= all.contains(sm.move());
+		}
+		report("Captures + quiets == non-evasions", success);
+	}
+
+	// Test that every evasion leaves the king out of check
+	void testEvasions() {
+		Position pos;
+		pos.set("4k3/8/8/8/1b6/8/8/4K2R w K - 0 1");
+		MoveList moves;
+		generate<LEGAL>(pos, moves);
+
+		bool success = pos.checkers() != 0 && moves.size() == 4;
+		for (const ScoredMove& sm : moves) {
+			StateInfo st;
+			pos.doMove(sm.move(), st);
+			success &= !(pos.attackersTo(pos.kingSquare(WHITE)) & pos.pieces(BLACK));
+			pos.undoMove(sm.move());
+		}
+		report("Check evasions", success);
+	}
+
+	// Run all move generation tests
+	void runAllMoveGenTests() {
+		std::cout << "Running MoveGen tests...\n" << "\n";
+
+		testPerft();
+		testGenTypeSplit();
+		testEvasions();
+
+		std::cout << "\nMoveGen tests completed." << "\n";
+	}
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include "Move.h"
+#include "Types.h"
+
+#if defined(__AVX2__) || defined(_M_X64) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// MoveList.h - Fixed-capacity, stack-allocated list of scored moves
+
+namespace chess {
+
+	// A move and its ordering score packed into 32 bits (score in the high half, move in the low half)
+	// Comparing the packed values as signed integers orders by score, so a whole list can be scanned with SIMD
+	struct ScoredMove {
+		int32_t packed;
+
+		[[nodiscard]] constexpr Move move() const { return Move(static_cast<uint16_t>(packed & 0xFFFF)); }
+		[[nodiscard]] constexpr int score() const { return packed >> 16; }
+
+		constexpr void setScore(const int score) {
+			packed = (std::clamp(score, SCORE_MIN, SCORE_MAX) << 16) | (packed & 0xFFFF);
+		}
+
+		// Range of scores that fit into the high half
+		static constexpr int SCORE_MIN = INT16_MIN;
+		static constexpr int SCORE_MAX = INT16_MAX;
+	};
+	static_assert(sizeof(ScoredMove) == 4);
+
+	class MoveList {
+	public:
+		MoveList() noexcept : m_size(0) {}
+
+		// Adds a move with a zero score
+		void add(const Move m) noexcept {
+			assert(m_size < MAX_MOVES);
+			m_moves[m_size++].packed = m.raw();
+		}
+
+		// Removes the move at index by moving the last move into its place
+		void remove(const int index) noexcept {
+			assert(index >= 0 && index < m_size);
+			m_moves[index] = m_moves[--m_size];
+		}
+
+		void clear() noexcept { m_size = 0; }
+
+		[[nodiscard]] int size() const noexcept { return m_size; }
+		[[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+		[[nodiscard]] Move operator[](const int index) const noexcept { assert(index < m_size); return m_moves[index].move(); }
+		[[nodiscard]] ScoredMove& at(const int index) noexcept { assert(index < m_size); return m_moves[index]; }
+
+		[[nodiscard]] ScoredMove* begin() noexcept { return m_moves.data(); }
+		[[nodiscard]] ScoredMove* end() noexcept { return m_moves.data() + m_size; }
+		[[nodiscard]] const ScoredMove* begin() const noexcept { return m_moves.data(); }
+		[[nodiscard]] const ScoredMove* end() const noexcept { return m_moves.data() + m_size; }
+
+		[[nodiscard]] bool contains(const Move m) const noexcept {
+			return std::any_of(begin(), end(), [m](const ScoredMove& sm) { return sm.move() == m; });
+		}
+
+		// Scores moves in [first, size) with scoreFn(Move) -> int, the packing itself is branch-free
+		template<typename ScoreFn>
+		void score(const int first, ScoreFn&& scoreFn) noexcept {
+			for (int i = first; i < m_size; ++i)
+				m_moves[i].setScore(scoreFn(m_moves[i].move()));
+		}
+
+		// Returns the index of the highest scored move in [first, size)
+		[[nodiscard]] int bestIndex(int first) const noexcept;
+
+		// Swaps the highest scored move in [first, size) to index first and returns it (one selection sort step)
+		Move pickBest(const int first) noexcept {
+			const int best = bestIndex(first);
+			std::swap(m_moves[first], m_moves[best]);
+			return m_moves[first].move();
+		}
+
+		// Sorts moves in [first, size) scoring at least limit to the front in descending order,
+		// the remaining moves are left unsorted behind them
+		void partialInsertionSort(int first, int limit) noexcept;
+
+	private:
+		alignas(32) std::array<ScoredMove, MAX_MOVES> m_moves;
+		int m_size;
+	};
+
+	inline int MoveList::bestIndex(const int first) const noexcept {
+		assert(first >= 0 && first < m_size);
+		const auto* data = reinterpret_cast<const int32_t*>(m_moves.data());
+		int32_t best = data[first];
+		int i = first;
+
+#if defined(__AVX2__)
+		if (m_size - i >= 8) {
+			__m256i vmax = _mm256_set1_epi32(best);
+			for (; i + 8 <= m_size; i += 8)
+				vmax = _mm256_max_epi32(vmax, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+			__m128i m = _mm_max_epi32(_mm256_castsi256_si128(vmax), _mm256_extracti128_si256(vmax, 1));
+			m = _mm_max_epi32(m, _mm_shuffle_epi32(m, 0x4E));
+			m = _mm_max_epi32(m, _mm_shuffle_epi32(m, 0xB1));
+			best = _mm_cvtsi128_si32(m);
+		}
+#elif defined(_M_X64) || defined(__SSE2__)
+		// SSE2 has no signed 32-bit max, emulate it with compare and select
+		const auto max4 = [](const __m128i a, const __m128i b) {
+			const __m128i gt = _mm_cmpgt_epi32(a, b);
+			return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+			};
+		if (m_size - i >= 4) {
+			__m128i vmax = _mm_set1_epi32(best);
+			for (; i + 4 <= m_size; i += 4)
+				vmax = max4(vmax, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+			vmax = max4(vmax, _mm_shuffle_epi32(vmax, 0x4E));
+			vmax = max4(vmax, _mm_shuffle_epi32(vmax, 0xB1));
+			best = _mm_cvtsi128_si32(vmax);
+		}
+#endif
+		for (; i < m_size; ++i)
+			best = std::max(best, data[i]);
+
+		// Packed values are unique within a list (the low half is the move), so the first match is the best move
+		int index = first;
+		while (data[index] != best)
+			++index;
+		return index;
+	}
+
+	inline void MoveList::partialInsertionSort(const int first, const int limit) noexcept {
+		ScoredMove* const begin = m_moves.data() + first;
+		ScoredMove* const end = m_moves.data() + m_size;
+		// The sorted moves are [begin, sortedEnd), the first move is sorted in only if it reaches limit
+		for (ScoredMove *sortedEnd = begin, *p = begin; p < end; ++p) {
+			if (p->score() >= limit) {
+				const ScoredMove tmp = *p;
+				ScoredMove* q = sortedEnd++;
+				*p = *q;
+				for (; q != begin && (q - 1)->packed < tmp.packed; --q)
+					*q = *(q - 1);
+				*q = tmp;
+			}
+		}
+	}
+}
@@ -0,0 +1,83 @@
+#include "MoveListTests.h"
+#include <iostream>
+
+#include "MoveList.h"
+#include "Types.h"
+
+// MoveListTests.cpp - Tests for the packed, fixed-capacity move list
+
+namespace chess::tests
+{
+	// Test packing of score and move into 32 bits
+	void testScoredMovePacking() {
+		ScoredMove sm{ Move(E7, E8, PROMOTION, QUEEN).raw() };
+		bool success = sm.move() == Move(E7, E8, PROMOTION, QUEEN) && sm.score() == 0;
+
+		sm.setScore(-1234);
+		success &= sm.move() == Move(E7, E8, PROMOTION, QUEEN) && sm.score() == -1234;
+
+		// Out of range scores are clamped
+		sm.setScore(1 << 20);
+		success &= sm.score() == ScoredMove::SCORE_MAX;
+		sm.setScore(-(1 << 20));
+		success &= sm.score() == ScoredMove::SCORE_MIN;
+		success &= sm.move() == Move(E7, E8, PROMOTION, QUEEN);
+
+		report("ScoredMove packing", success);
+	}
+
+	// Test that repeated best-move selection yields descending scores
+	void testPickBest() {
+		MoveList moves;
+		for (Square sq = A1; sq < SQUARE_NB; ++sq)
+			moves.add(Move(sq, static_cast<Square>(63 - sq)));
+		moves.score(0, [](const Move m) { return (m.fromSq() * 37) % 101 - 50; });
+
+		bool success = moves.size() == SQUARE_NB;
+		int last = ScoredMove::SCORE_MAX;
+		for (int i = 0; i < moves.size(); ++i) {
+			const Move m = moves.pickBest(i);
+			success &= m == moves[i] && moves.at(i).score() <= last;
+			last = moves.at(i).score();
+		}
+		report("pickBest selection order", success);
+	}
+
+	// Test partial insertion sort leaves good moves sorted at the front
+	void testPartialInsertionSort() {
+		MoveList moves;
+		const int scores[] = { 5, -3, 40, 0, 12, -7, 40, 1 };
+		for (int i = 0; i < 8; ++i) {
+			moves.add(Move(static_cast<Square>(i), static_cast<Square>(i + 8)));
+			moves.at(i).setScore(scores[i]);
+		}
+		moves.partialInsertionSort(0, 1);
+
+		// Scores >= 1 sorted in front: 40, 40, 12, 5, 1
+		bool success = moves.at(0).score() == 40 && moves.at(1).score() == 40 && moves.at(2).score() == 12
+			&& moves.at(3).score() == 5 && moves.at(4).score() == 1;
+		success &= moves.size() == 8 && moves.contains(Move(B1, B2)) && moves.contains(Move(F1, F2));
+
+		// A first move below the limit is moved behind the sorted ones
+		MoveList low;
+		const int lowScores[] = { -5, 3, -1, 9 };
+		for (int i = 0; i < 4; ++i) {
+			low.add(Move(static_cast<Square>(i), static_cast<Square>(i + 8)));
+			low.at(i).setScore(lowScores[i]);
+		}
+		low.partialInsertionSort(0, 1);
+		success &= low.at(0).score() == 9 && low.at(1).score() == 3 && low.at(2).score() < 1 && low.at(3).score() < 1;
+		report("Partial insertion sort", success);
+	}
+
+	// Run all MoveList tests
+	void runAllMoveListTests() {
+		std::cout << "Running MoveList tests...\n" << "\n";
+
+		testScoredMovePacking();
+		testPickBest();
+		testPartialInsertionSort();
+
+		std::cout << "\nMoveList tests completed." << "\n";
+	}
+}
@@ -0,0 +1,209 @@
+#include "MovePicker.h"
+#include <iomanip>
+#include <iostream>
+
+#include "MoveGen.h"
+
+// MovePicker.cpp - Staged, lazily generated move ordering for the search
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// History tables are indexed with 12-bit from-to squares and
+// colors, which always fit the fixed table sizes
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+#pragma warning(disable: 26482)
+
+namespace chess {
+
+	namespace {
+		// Names of the stages for the statistics output
+		constexpr std::array<const char*, PICKER_STAGE_NB> STAGE_NAMES = {
+			"tt move", "capture init", "good captures", "killer 1", "killer 2", "counter move", "quiet init", "quiets", "bad captures",
+			"evasion tt", "evasion init", "evasions", "qsearch tt", "qcapture init", "qcaptures"
+		};
+	}
+
+	MovePicker::MovePicker(const Position& pos, const Move ttMove, const int depth, const MoveHistories& histories,
+		const KillerMoves& killers, PickerStats* stats) :
+		m_pos(pos), m_histories(histories), m_stats(stats), m_ttMove(ttMove), m_killers(killers),
+		m_stage(pos.checkers() ? EVASION_TT : MAIN_TT), m_depth(depth) {
+		assert(depth > 0);
+		init(ttMove.validMove() && pos.pseudoLegal(ttMove));
+	}
+
+	MovePicker::MovePicker(const Position& pos, const Move ttMove, const ButterflyHistory* history, PickerStats* stats) :
+		m_pos(pos), m_stats(stats), m_ttMove(ttMove),
+		m_stage(pos.checkers() ? EVASION_TT : QSEARCH_TT), m_depth(0) {
+		m_histories.butterfly = history;
+		init(ttMove.validMove() && pos.pseudoLegal(ttMove) && (pos.checkers() || pos.captureOrPromotion(ttMove)));
+	}
+
+	void MovePicker::init(const bool ttUsable) {
+		// Without a usable TT move start directly with move generation
+		if (!ttUsable) {
+			m_ttMove = Move::none();
+			m_stage = static_cast<PickerStage>(m_stage + 1);
+		}
+
+		if (m_stats) {
+			++m_stats->pickers;
+			++m_stats->reached[m_stage];
+		}
+	}
+
+	// Captures are ordered by MVV-LVA: most valuable victim first, least valuable attacker breaks ties
+	void MovePicker::scoreCaptures(const int first) {
+		m_moves.score(first, [this](const Move m) {
+			const PieceType victim = m.moveType() == EN_PASSANT ? PAWN : typeOf(m_pos.pieceOn(m.toSq()));
+			const Value promotionGain = m.moveType() == PROMOTION ? PieceValues[m.promotionType()] - PawnValue : 0;
+			return 4 * (PieceValues[victim] + promotionGain) - typeOf(m_pos.movedPiece(m));
+			});
+	}
+
+	// Quiet moves are ordered by butterfly history plus the continuation histories of the last two moves
+	void MovePicker::scoreQuiets(const int first) {
+		const Color us = m_pos.sideToMove();
+		m_moves.score(first, [this, us](const Move m) {
+			int score = m_histories.butterfly ? (*m_histories.butterfly)[us][m.fromToSq()] : 0;
+			const Piece piece = m_pos.movedPiece(m);
+			for (const PieceToHistory* continuation : m_histories.continuation)
+				if (continuation)
+					score += (*continuation)[piece][m.toSq()];
+			return score;
+			});
+	}
+
+	// Evasions: captures by MVV-LVA above all quiet moves, quiets by history
+	void MovePicker::scoreEvasions(const int first) {
+		const Color us = m_pos.sideToMove();
+		m_moves.score(first, [this, us](const Move m) {
+			if (m_pos.capture(m)) {
+				const PieceType victim = m.moveType() == EN_PASSANT ? PAWN : typeOf(m_pos.pieceOn(m.toSq()));
+				return (1 << 14) + PieceValues[victim] - typeOf(m_pos.movedPiece(m));
+			}
+			return m_histories.butterfly ? (*m_histories.butterfly)[us][m.fromToSq()] : 0;
+			});
+	}
+
+	Move MovePicker::nextMove(const bool skipQuiets) {
+		while (true) {
+			switch (m_stage) {
+
+			case MAIN_TT:
+			case EVASION_TT:
+			case QSEARCH_TT:
+				advance();
+				return m_ttMove;
+
+			case CAPTURE_INIT:
+			case QCAPTURE_INIT:
+				generate<CAPTURES>(m_pos, m_moves);
+				scoreCaptures(0);
+				m_cur = m_endBadCaptures = 0;
+				m_endCaptures = m_moves.size();
+				advance();
+				break;
+
+			case GOOD_CAPTURE:
+				while (m_cur < m_endCaptures) {
+					const Move m = m_moves.pickBest(m_cur);
+					if (m == m_ttMove) {
+						++m_cur;
+						continue;
+					}
+					if (m_pos.seeGe(m, VALUE_ZERO)) {
+						++m_cur;
+						return m;
+					}
+					// Losing capture, keep it for the last stage
+					std::swap(m_moves.at(m_endBadCaptures++), m_moves.at(m_cur++));
+				}
+				advance();
+				break;
+
+			case KILLER_1:
+			case KILLER_2: {
+				const Move killer = m_killers[m_stage - KILLER_1];
+				advance();
+				if (killer != m_ttMove && killer.validMove() && !m_pos.captureOrPromotion(killer) && m_pos.pseudoLegal(killer))
+					return killer;
+				break;
+			}
+
+			case COUNTER_MOVE: {
+				const Move counter = m_histories.counterMove;
+				advance();
+				if (counter != m_ttMove && counter != m_killers[0] && counter != m_killers[1] && counter.validMove()
+					&& !m_pos.captureOrPromotion(counter) && m_pos.pseudoLegal(counter))
+					return counter;
+				break;
+			}
+
+			case QUIET_INIT:
+				if (!skipQuiets) {
+					generate<QUIETS>(m_pos, m_moves);
+					scoreQuiets(m_endCaptures);
+					m_moves.partialInsertionSort(m_endCaptures, -3000 * m_depth);
+				}
+				m_cur = m_endCaptures;
+				advance();
+				break;
+
+			case QUIET:
+				while (!skipQuiets && m_cur < m_moves.size()) {
+					const Move m = m_moves[m_cur++];
+					if (m != m_ttMove && !isRefutation(m))
+						return m;
+				}
+				m_cur = 0;
+				advance();
+				break;
+
+			case BAD_CAPTURE:
+				if (m_cur < m_endBadCaptures)
+					return m_moves[m_cur++];
+				return Move::none();
+
+			case EVASION_INIT:
+				generate<EVASIONS>(m_pos, m_moves);
+				scoreEvasions(0);
+				m_cur = 0;
+				advance();
+				break;
+
+			case EVASION:
+				while (m_cur < m_moves.size()) {
+					const Move m = m_moves.pickBest(m_cur++);
+					if (m != m_ttMove)
+						return m;
+				}
+				return Move::none();
+
+			// Losing captures are left to the search, which knows whether to prune them
+			case QCAPTURE:
+				while (m_cur < m_endCaptures) {
+					const Move m = m_moves.pickBest(m_cur++);
+					if (m != m_ttMove)
+						return m;
+				}
+				return Move::none();
+
+			default:
+				assert(false);
+				return Move::none();
+			}
+		}
+	}
+
+	void PickerStats::print() const {
+		std::cout << "Move picker stages reached (" << pickers << " pickers)\n";
+		for (int stage = 0; stage < PICKER_STAGE_NB; ++stage) {
+			const double share = pickers ? 100.0 * static_cast<double>(reached[stage]) / static_cast<double>(pickers) : 0.0;
+			std::cout << "  " << std::left << std::setw(14) << STAGE_NAMES[stage] << std::right << std::setw(12) << reached[stage]
+				<< std::fixed << std::setprecision(1) << std::setw(8) << share << "%\n";
+		}
+	}
+}
+#pragma warning(pop)
@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "History.h"
+#include "MoveList.h"
+#include "Position.h"
+
+// MovePicker.h - Staged, lazily generated move ordering for the search
+
+namespace chess {
+
+	// Stages of the move picker, each is only generated once the previous ones are exhausted
+	enum PickerStage : int {
+		// Main search
+		MAIN_TT, CAPTURE_INIT, GOOD_CAPTURE, KILLER_1, KILLER_2, COUNTER_MOVE, QUIET_INIT, QUIET, BAD_CAPTURE,
+		// Main search when in check, also used by the quiescence search in check
+		EVASION_TT, EVASION_INIT, EVASION,
+		// Quiescence search: captures and queen promotions only
+		QSEARCH_TT, QCAPTURE_INIT, QCAPTURE,
+		PICKER_STAGE_NB
+	};
+
+	// How often each stage was reached, indexed by PickerStage
+	struct PickerStats {
+		std::array<uint64_t, PICKER_STAGE_NB> reached{};
+		uint64_t pickers = 0;  // Number of move pickers created
+
+		// Prints the counters, with each stage as a share of the pickers created
+		void print() const;
+	};
+
+	class MovePicker {
+	public:
+		MovePicker(const Position& pos, Move ttMove, int depth, const MoveHistories& histories,
+			const KillerMoves& killers, PickerStats* stats = nullptr);
+
+		// Quiescence search picker: captures and queen promotions, or all evasions when in check
+		MovePicker(const Position& pos, Move ttMove, const ButterflyHistory* history, PickerStats* stats = nullptr);
+		MovePicker(const MovePicker&) = delete;
+		MovePicker& operator=(const MovePicker&) = delete;
+
+		// Returns the next pseudo-legal move or Move::none() when all stages are exhausted,
+		// with skipQuiets set the remaining quiet moves are not generated or returned
+		Move nextMove(bool skipQuiets = false);
+
+		// Current stage (for statistics and debugging)
+		[[nodiscard]] PickerStage stage() const { return m_stage; }
+
+	private:
+		// Score moves in [first, size) of the list for their stage
+		void scoreCaptures(int first);
+		void scoreQuiets(int first);
+		void scoreEvasions(int first);
+
+		// Drops an unusable TT move and counts the first stage
+		void init(bool ttUsable);
+
+		// Killer or counter move that is not returned by another stage
+		[[nodiscard]] bool isRefutation(Move m) const {
+			return m == m_killers[0] || m == m_killers[1] || m == m_histories.counterMove;
+		}
+
+		// Enter the next stage and count it
+		void advance() {
+			m_stage = static_cast<PickerStage>(m_stage + 1);
+			if (m_stats)
+				++m_stats->reached[m_stage];
+		}
+
+		const Position& m_pos;
+		MoveHistories m_histories;
+		PickerStats* m_stats;
+		Move m_ttMove;
+		KillerMoves m_killers{};
+		PickerStage m_stage;
+		int m_depth;
+
+		// Moves live in one list: captures, then quiets, bad captures are gathered in front
+		MoveList m_moves;
+		int m_cur = 0;
+		int m_endBadCaptures = 0;
+		int m_endCaptures = 0;
+	};
+}
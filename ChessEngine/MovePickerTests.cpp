@@ -0,0 +1,183 @@
+#include "MovePickerTests.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "MoveGen.h"
+#include "MovePicker.h"
+#include "Position.h"
+#include "Types.h"
+
+// MovePickerTests.cpp - Tests for static exchange evaluation and the staged move picker
+
+namespace chess::tests
+{
+	const std::vector<std::string> PICKER_FENS = {
+		START_FEN,
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+		"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+		"4k3/8/4p3/3p4/8/8/8/3QK3 w - - 0 1"
+	};
+
+	// Test static exchange evaluation on simple exchanges
+	void testSee() {
+		Position pos;
+		bool success = true;
+
+		// Pawn defended by a pawn: queen takes loses the queen for a pawn
+		pos.set("4k3/8/4p3/3p4/8/8/8/3QK3 w - - 0 1");
+		success &= !pos.seeGe(Move(D1, D5), VALUE_ZERO);
+		success &= pos.seeGe(Move(D1, D5), PawnValue - QueenValue);
+
+		// Undefended rook: wins a full rook
+		pos.set("4k3/8/8/3r4/8/8/8/3QK3 w - - 0 1");
+		success &= pos.seeGe(Move(D1, D5), RookValue) && !pos.seeGe(Move(D1, D5), RookValue + 1);
+
+		// Knight takes pawn defended by a bishop, with a rook behind the bishop no longer recaptures
+		pos.set("4k3/8/2b5/3p4/8/4N3/8/4K3 w - - 0 1");
+		success &= !pos.seeGe(Move(E3, D5), VALUE_ZERO);
+		pos.set("4k3/8/2b5/3p4/8/4N3/8/3RK3 w - - 0 1");
+		success &= pos.seeGe(Move(E3, D5), PawnValue) && !pos.seeGe(Move(E3, D5), PawnValue + 1);
+
+		// Defender pinned to its king cannot recapture
+		pos.set("8/8/5n1k/3p4/8/4N3/8/4K3 w - - 0 1");
+		success &= !pos.seeGe(Move(E3, D5), VALUE_ZERO);
+		pos.set("8/8/R4n1k/3p4/8/4N3/8/4K3 w - - 0 1");
+		success &= pos.seeGe(Move(E3, D5), PawnValue);
+
+		report("Static exchange evaluation", success);
+	}
+
+	// Test that the picker returns every pseudo-legal move exactly once
+	void testPickerCompleteness() {
+		bool success = true;
+		for (const std::string& fen : PICKER_FENS) {
+			Position pos;
+			pos.set(fen);
+			MoveList expected;
+			if (pos.checkers())
+				generate<EVASIONS>(pos, expected);
+			else
+				generate<NON_EVASIONS>(pos, expected);
+
+			// Use a real move as TT move, one real and one bogus killer and a real counter move
+			const Move ttMove = expected[expected.size() / 2];
+			const KillerMoves killers = { expected[expected.size() - 1], Move(A3, H7) };
+			ButterflyHistory history{};
+			MoveHistories histories{ &history };
+			histories.counterMove = expected[expected.size() / 3];
+			MovePicker picker(pos, ttMove, 4, histories, killers);
+
+			MoveList picked;
+			bool firstIsTT = true;
+			for (Move m; (m = picker.nextMove()); ) {
+				if (picked.empty())
+					firstIsTT = m == ttMove;
+				success &= !picked.contains(m);
+				picked.add(m);
+			}
+			success &= firstIsTT && picked.size() == expected.size();
+			for (const ScoredMove& sm : expected)
+				success &= picked.contains(sm.move());
+		}
+		report("Move picker returns each move once", success);
+	}
+
+	// Test stage order: good captures, quiets, then losing captures
+	void testPickerStageOrder() {
+		Position pos;
+		pos.set("4k3/8/4p3/3p4/8/8/4P3/3QK3 w - - 0 1");
+		PickerStats stats;
+		ButterflyHistory history{};
+		MovePicker picker(pos, Move::none(), 4, MoveHistories{ &history }, KillerMoves{}, &stats);
+
+		std::vector<Move> order;
+		for (Move m; (m = picker.nextMove()); )
+			order.push_back(m);
+
+		// Qxd5 loses the queen and must come last, the TT stage is skipped without a TT move
+		const bool success = !order.empty() && order.back() == Move(D1, D5)
+			&& stats.pickers == 1 && stats.reached[MAIN_TT] == 0 && stats.reached[CAPTURE_INIT] == 1
+			&& stats.reached[QUIET] == 1 && stats.reached[BAD_CAPTURE] == 1;
+		report("Move picker stage order and counters", success);
+	}
+
+	// Test that quiets are not generated when skipped
+	void testPickerSkipQuiets() {
+		Position pos;
+		pos.set(START_FEN);
+		MovePicker picker(pos, Move::none(), 1, MoveHistories{}, KillerMoves{});
+		report("Move picker skips quiets", !picker.nextMove(true));
+	}
+
+	// Test that the quiescence picker returns exactly the captures, or all evasions in check
+	void testQuiescencePicker() {
+		bool success = true;
+		for (const std::string& fen : PICKER_FENS) {
+			Position pos;
+			pos.set(fen);
+			MoveList expected;
+			if (pos.checkers())
+				generate<EVASIONS>(pos, expected);
+			else
+				generate<CAPTURES>(pos, expected);
+
+			// A quiet TT move is not used outside of check
+			MoveList quiets;
+			if (!pos.checkers())
+				generate<QUIETS>(pos, quiets);
+			MovePicker picker(pos, quiets.empty() ? Move::none() : quiets[0], nullptr);
+
+			MoveList picked;
+			for (Move m; (m = picker.nextMove()); ) {
+				success &= !picked.contains(m);
+				picked.add(m);
+			}
+			success &= picked.size() == expected.size();
+			for (const ScoredMove& sm : expected)
+				success &= picked.contains(sm.move());
+		}
+		report("Quiescence move picker", success);
+	}
+
+	// Test that gravity updates saturate at the bound and that history orders quiet moves
+	void testHistoryOrdering() {
+		int16_t entry = 0;
+		bool success = true;
+		for (int i = 0; i < 1000; ++i) {
+			updateHistory(entry, 3000);
+			success &= entry <= HISTORY_MAX;
+		}
+		success &= entry > HISTORY_MAX - 100;
+		updateHistory(entry, -HISTORY_MAX);
+		success &= entry == -HISTORY_MAX;
+
+		// Counter move right after the killers, then quiets by butterfly plus continuation history
+		Position pos;
+		pos.set(START_FEN);
+		ButterflyHistory butterfly{};
+		PieceToHistory continuation{};
+		butterfly[WHITE][Move(B1, C3).fromToSq()] = 500;
+		continuation[W_KNIGHT][F3] = 600;
+		MoveHistories histories{ &butterfly, { &continuation, nullptr }, Move(E2, E4) };
+		MovePicker picker(pos, Move::none(), 4, histories, KillerMoves{ Move(D2, D4), Move::none() });
+		success &= picker.nextMove() == Move(D2, D4) && picker.nextMove() == Move(E2, E4)
+			&& picker.nextMove() == Move(G1, F3) && picker.nextMove() == Move(B1, C3);
+		report("History updates and ordering", success);
+	}
+
+	// Run all MovePicker tests
+	void runAllMovePickerTests() {
+		std::cout << "Running MovePicker tests...\n" << "\n";
+
+		testSee();
+		testPickerCompleteness();
+		testPickerStageOrder();
+		testPickerSkipQuiets();
+		testQuiescencePicker();
+		testHistoryOrdering();
+
+		std::cout << "\nMovePicker tests completed." << "\n";
+	}
+}
@@ -0,0 +1,359 @@
+#include "Nnue.h"
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <random>
+#include "Position.h"
+
+#if defined(__AVX2__) || defined(__AVX512BW__) || defined(_M_X64) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Nnue.cpp - Network weights, accumulator updates and the quantized forward pass
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// and pointer arithmetic warnings (26481). Feature indices are
+// bounded by construction and the layers walk raw rows
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+#pragma warning(disable: 26481)
+#pragma warning(disable: 26482)
+
+namespace chess::nnue {
+
+	namespace {
+		// Hidden layer sums are scaled down by 2^WEIGHT_SHIFT before clipping to [0, 127],
+		// the output by OUTPUT_SCALE to centipawn-like engine units
+		constexpr int WEIGHT_SHIFT = 6;
+		constexpr int OUTPUT_SCALE = 16;
+
+		// File header: magic "NNUE", format version and the dimensions the weights were trained for.
+		// Arrays follow in little endian in the order of the Network members
+		constexpr uint32_t FILE_MAGIC = 0x45554E4E;
+		constexpr uint32_t FILE_VERSION = 1;
+
+		struct alignas(64) Network {
+			std::array<int16_t, HALF_DIMS> ftBiases;
+			std::array<int16_t, static_cast<size_t>(INPUT_DIMS) * HALF_DIMS> ftWeights;  // One column of HALF_DIMS per feature
+			std::array<int32_t, HIDDEN_DIMS> l1Biases;
+			std::array<std::array<int8_t, 2 * HALF_DIMS>, HIDDEN_DIMS> l1Weights;
+			std::array<int32_t, HIDDEN_DIMS> l2Biases;
+			std::array<std::array<int8_t, HIDDEN_DIMS>, HIDDEN_DIMS> l2Weights;
+			int32_t outBias;
+			std::array<int8_t, HIDDEN_DIMS> outWeights;
+		};
+
+		std::unique_ptr<Network> g_network;
+
+		// HalfKP index seen from perspective: black's view is rotated so both sides share the weights
+		int featureIndex(const Color perspective, const Square kingSq, const Piece pc, const Square sq) {
+			const int flip = perspective == WHITE ? 0 : 63;
+			const int pieceIndex = 2 * (typeOf(pc) - 1) + (colorOf(pc) != perspective);
+			return ((kingSq ^ flip) * 10 + pieceIndex) * SQUARE_NB + (sq ^ flip);
+		}
+
+		const int16_t* column(const int index) {
+			return &g_network->ftWeights[static_cast<size_t>(index) * HALF_DIMS];
+		}
+
+		// Feature transformer: one weight column added to or taken from the accumulator
+		template<bool Add>
+		void updateColumn(int16_t* acc, const int16_t* weights, const bool simd) {
+#if defined(__AVX512BW__)
+			if (simd) {
+				for (int i = 0; i < HALF_DIMS; i += 32) {
+					__m512i* a = reinterpret_cast<__m512i*>(acc + i);
+					const __m512i w = _mm512_load_si512(weights + i);
+					*a = Add ? _mm512_add_epi16(*a, w) : _mm512_sub_epi16(*a, w);
+				}
+				return;
+			}
+#elif defined(__AVX2__)
+			if (simd) {
+				for (int i = 0; i < HALF_DIMS; i += 16) {
+					__m256i* a = reinterpret_cast<__m256i*>(acc + i);
+					const __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i*>(weights + i));
+					*a = Add ? _mm256_add_epi16(*a, w) : _mm256_sub_epi16(*a, w);
+				}
+				return;
+			}
+#elif defined(_M_X64) || defined(__SSE2__)
+			if (simd) {
+				for (int i = 0; i < HALF_DIMS; i += 8) {
+					__m128i* a = reinterpret_cast<__m128i*>(acc + i);
+					const __m128i w = _mm_load_si128(reinterpret_cast<const __m128i*>(weights + i));
+					*a = Add ? _mm_add_epi16(*a, w) : _mm_sub_epi16(*a, w);
+				}
+				return;
+			}
+#endif
+			(void)simd;
+			for (int i = 0; i < HALF_DIMS; ++i)
+				acc[i] = static_cast<int16_t>(Add ? acc[i] + weights[i] : acc[i] - weights[i]);
+		}
+
+		// Dot product of clipped activations with one int8 weight row. maddubs cannot saturate:
+		// two products of at most 127 * 128 stay within int16
+		int32_t dot(const uint8_t* input, const int8_t* weights, const int n, const bool simd) {
+			int i = 0;
+			int32_t sum = 0;
+#if defined(__AVX512BW__)
+			if (simd) {
+				__m512i acc = _mm512_setzero_si512();
+				const __m512i ones = _mm512_set1_epi16(1);
+				for (; i + 64 <= n; i += 64) {
+					const __m512i products = _mm512_maddubs_epi16(_mm512_loadu_si512(input + i), _mm512_loadu_si512(weights + i));
+					acc = _mm512_add_epi32(acc, _mm512_madd_epi16(products, ones));
+				}
+				sum += _mm512_reduce_add_epi32(acc);
+			}
+#endif
+#if defined(__AVX2__)
+			if (simd) {
+				__m256i acc = _mm256_setzero_si256();
+				const __m256i ones = _mm256_set1_epi16(1);
+				for (; i + 32 <= n; i += 32) {
+					const __m256i products = _mm256_maddubs_epi16(
+						_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i)),
+						_mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i)));
+					acc = _mm256_add_epi32(acc, _mm256_madd_epi16(products, ones));
+				}
+				__m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+				s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+				s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+				sum += _mm_cvtsi128_si32(s);
+			}
+#elif defined(_M_X64) || defined(__SSE2__)
+			// SSE2 has no maddubs: widen both operands to int16, sign extending the weights, then madd
+			if (simd) {
+				__m128i acc = _mm_setzero_si128();
+				const __m128i zero = _mm_setzero_si128();
+				for (; i + 16 <= n; i += 16) {
+					const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+					const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+					const __m128i sign = _mm_cmpgt_epi8(zero, w);
+					acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi8(in, zero), _mm_unpacklo_epi8(w, sign)));
+					acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpackhi_epi8(in, zero), _mm_unpackhi_epi8(w, sign)));
+				}
+				acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4E));
+				acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xB1));
+				sum += _mm_cvtsi128_si32(acc);
+			}
+#endif
+			(void)simd;
+			for (; i < n; ++i)
+				sum += input[i] * weights[i];
+			return sum;
+		}
+
+		void refresh(const Position& pos, Accumulator& acc, const Color perspective, const bool simd) {
+			acc.values[perspective] = g_network->ftBiases;
+			const Square kingSq = pos.kingSquare(perspective);
+			Bitboard b = pos.pieces() & ~pos.pieces(KING);
+			while (b) {
+				const Square sq = popLsb(b);
+				updateColumn<true>(acc.values[perspective].data(), column(featureIndex(perspective, kingSq, pos.pieceOn(sq), sq)), simd);
+			}
+			acc.computed[perspective] = true;
+		}
+
+		// Applies the changes of one move seen from perspective, whose king did not move
+		void applyDirty(Accumulator& acc, const DirtyPiece& dp, const Color perspective, const Square kingSq) {
+			for (int i = 0; i < dp.count; ++i) {
+				if (typeOf(dp.piece[i]) == KING)
+					continue;
+				if (dp.from[i] != NO_SQUARE)
+					updateColumn<false>(acc.values[perspective].data(), column(featureIndex(perspective, kingSq, dp.piece[i], dp.from[i])), true);
+				if (dp.to[i] != NO_SQUARE)
+					updateColumn<true>(acc.values[perspective].data(), column(featureIndex(perspective, kingSq, dp.piece[i], dp.to[i])), true);
+			}
+		}
+
+		// Starts from the closest ancestor with a computed accumulator and replays the moves since.
+		// A king move of this perspective changes every feature, so it needs a refresh instead,
+		// as does a long chain of changes that costs more than summing the pieces on the board
+		void update(const Position& pos, StateInfo* st, const Color perspective) {
+			if (st->accumulator.computed[perspective])
+				return;
+
+			const Piece ourKing = makePiece(perspective, KING);
+			const int refreshCost = popCount(pos.pieces());
+			int cost = 0;
+			StateInfo* ancestor = st;
+			while (true) {
+				const DirtyPiece& dp = ancestor->dirtyPiece;
+				bool kingMoved = false;
+				for (int i = 0; i < std::min(dp.count, DirtyPiece::MAX); ++i)
+					kingMoved |= dp.piece[i] == ourKing;
+				cost += 2 * dp.count;
+				if (dp.overflow() || kingMoved || !ancestor->previous || cost > refreshCost) {
+					refresh(pos, st->accumulator, perspective, true);
+					return;
+				}
+				ancestor = ancestor->previous;
+				if (ancestor->accumulator.computed[perspective])
+					break;
+			}
+
+			// Additions commute, so the moves are replayed newest first
+			const Square kingSq = pos.kingSquare(perspective);
+			st->accumulator.values[perspective] = ancestor->accumulator.values[perspective];
+			for (const StateInfo* s = st; s != ancestor; s = s->previous)
+				applyDirty(st->accumulator, s->dirtyPiece, perspective, kingSq);
+			st->accumulator.computed[perspective] = true;
+		}
+
+		// Hidden layers and output from the accumulator, side to move's half first
+		Value propagate(const Accumulator& acc, const Color stm, const bool simd) {
+			const Network& net = *g_network;
+
+			alignas(64) std::array<uint8_t, 2 * HALF_DIMS> input;
+			for (int half = 0; half < 2; ++half) {
+				const auto& values = acc.values[half == 0 ? stm : ~stm];
+				for (int i = 0; i < HALF_DIMS; ++i)
+					input[half * HALF_DIMS + i] = static_cast<uint8_t>(std::clamp<int>(values[i], 0, 127));
+			}
+
+			alignas(64) std::array<uint8_t, HIDDEN_DIMS> hidden1;
+			for (int i = 0; i < HIDDEN_DIMS; ++i) {
+				const int32_t sum = net.l1Biases[i] + dot(input.data(), net.l1Weights[i].data(), 2 * HALF_DIMS, simd);
+				hidden1[i] = static_cast<uint8_t>(std::clamp(sum >> WEIGHT_SHIFT, 0, 127));
+			}
+
+			alignas(64) std::array<uint8_t, HIDDEN_DIMS> hidden2;
+			for (int i = 0; i < HIDDEN_DIMS; ++i) {
+				const int32_t sum = net.l2Biases[i] + dot(hidden1.data(), net.l2Weights[i].data(), HIDDEN_DIMS, simd);
+				hidden2[i] = static_cast<uint8_t>(std::clamp(sum >> WEIGHT_SHIFT, 0, 127));
+			}
+
+			const int32_t out = net.outBias + dot(hidden2.data(), net.outWeights.data(), HIDDEN_DIMS, simd);
+			return std::clamp(out / OUTPUT_SCALE, VALUE_MATED_IN_MAX_PLY + 1, VALUE_MATE_IN_MAX_PLY - 1);
+		}
+
+		// Raw little endian arrays, the only platforms the engine targets
+		template<typename T>
+		bool readArray(std::istream& in, T* data, const size_t count) {
+			in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+			return static_cast<bool>(in);
+		}
+
+		template<typename T>
+		void writeArray(std::ostream& out, const T* data, const size_t count) {
+			out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+		}
+	}
+
+	bool load(const std::string& path) {
+		std::ifstream in(path, std::ios::binary);
+		if (!in)
+			return false;
+
+		std::array<uint32_t, 5> header{};
+		if (!readArray(in, header.data(), header.size()))
+			return false;
+		if (header != std::array<uint32_t, 5>{ FILE_MAGIC, FILE_VERSION, INPUT_DIMS, HALF_DIMS, HIDDEN_DIMS })
+			return false;
+
+		auto net = std::make_unique<Network>();
+		bool ok = readArray(in, net->ftBiases.data(), net->ftBiases.size())
+			&& readArray(in, net->ftWeights.data(), net->ftWeights.size())
+			&& readArray(in, net->l1Biases.data(), net->l1Biases.size());
+		for (auto& row : net->l1Weights)
+			ok = ok && readArray(in, row.data(), row.size());
+		ok = ok && readArray(in, net->l2Biases.data(), net->l2Biases.size());
+		for (auto& row : net->l2Weights)
+			ok = ok && readArray(in, row.data(), row.size());
+		ok = ok && readArray(in, &net->outBias, 1)
+			&& readArray(in, net->outWeights.data(), net->outWeights.size());
+
+		// Trailing bytes mean the file was written for another architecture
+		if (!ok || in.peek() != std::ifstream::traits_type::eof())
+			return false;
+
+		g_network = std::move(net);
+		return true;
+	}
+
+	bool save(const std::string& path) {
+		if (!g_network)
+			return false;
+		std::ofstream out(path, std::ios::binary);
+		if (!out)
+			return false;
+
+		const Network& net = *g_network;
+		const std::array<uint32_t, 5> header = { FILE_MAGIC, FILE_VERSION, INPUT_DIMS, HALF_DIMS, HIDDEN_DIMS };
+		writeArray(out, header.data(), header.size());
+		writeArray(out, net.ftBiases.data(), net.ftBiases.size());
+		writeArray(out, net.ftWeights.data(), net.ftWeights.size());
+		writeArray(out, net.l1Biases.data(), net.l1Biases.size());
+		for (const auto& row : net.l1Weights)
+			writeArray(out, row.data(), row.size());
+		writeArray(out, net.l2Biases.data(), net.l2Biases.size());
+		for (const auto& row : net.l2Weights)
+			writeArray(out, row.data(), row.size());
+		writeArray(out, &net.outBias, 1);
+		writeArray(out, net.outWeights.data(), net.outWeights.size());
+		return static_cast<bool>(out);
+	}
+
+	void randomize(const uint64_t seed) {
+		std::mt19937_64 rng(seed);
+		auto random = [&rng](const int lo, const int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+
+		auto net = std::make_unique<Network>();
+		for (auto& b : net->ftBiases) b = static_cast<int16_t>(random(0, 64));
+		for (auto& w : net->ftWeights) w = static_cast<int16_t>(random(-24, 24));
+		for (auto& b : net->l1Biases) b = random(-512, 512);
+		for (auto& row : net->l1Weights)
+			for (auto& w : row) w = static_cast<int8_t>(random(-16, 16));
+		for (auto& b : net->l2Biases) b = random(-512, 512);
+		for (auto& row : net->l2Weights)
+			for (auto& w : row) w = static_cast<int8_t>(random(-32, 32));
+		net->outBias = random(-256, 256);
+		for (auto& w : net->outWeights) w = static_cast<int8_t>(random(-16, 16));
+		g_network = std::move(net);
+	}
+
+	void unload() {
+		g_network.reset();
+	}
+
+	bool isLoaded() {
+		return g_network != nullptr;
+	}
+
+	const char* simdName() {
+#if defined(__AVX512BW__)
+		return "AVX-512";
+#elif defined(__AVX2__)
+		return "AVX2";
+#elif defined(_M_X64) || defined(__SSE2__)
+		return "SSE2";
+#else
+		return "scalar";
+#endif
+	}
+
+	void updateAccumulator(const Position& pos) {
+		assert(g_network);
+		for (const Color c : { WHITE, BLACK })
+			update(pos, pos.state(), c);
+	}
+
+	Value evaluate(const Position& pos) {
+		updateAccumulator(pos);
+		return propagate(pos.state()->accumulator, pos.sideToMove(), true);
+	}
+
+	Value evaluateScalar(const Position& pos) {
+		assert(g_network);
+		Accumulator acc;
+		for (const Color c : { WHITE, BLACK })
+			refresh(pos, acc, c, false);
+		return propagate(acc, pos.sideToMove(), false);
+	}
+}
+#pragma warning(pop)
@@ -0,0 +1,77 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include "Types.h"
+
+// Nnue.h - Efficiently updatable neural network evaluation (HalfKP 40960x256x2-32-32-1)
+
+namespace chess {
+	class Position;
+}
+
+namespace chess::nnue {
+
+	// Network dimensions: HalfKP features (own king square x non-king piece x square) per perspective
+	// into HALF_DIMS int16 neurons, both perspectives concatenated into two int8 hidden layers
+	constexpr int INPUT_DIMS = SQUARE_NB * 10 * SQUARE_NB;
+	constexpr int HALF_DIMS = 256;
+	constexpr int HIDDEN_DIMS = 32;
+
+	// Piece changes of one move, recorded by Position::putPiece, removePiece and movePiece
+	// (from is NO_SQUARE for a piece put on the board, to is NO_SQUARE for a piece removed)
+	struct DirtyPiece {
+		static constexpr int MAX = 4;  // Castling and promotions with capture change four pieces
+
+		std::array<Piece, MAX> piece;
+		std::array<Square, MAX> from;
+		std::array<Square, MAX> to;
+		int count = 0;
+
+		// More changes than fit, as while a position is set up from FEN; forces a refresh
+		[[nodiscard]] bool overflow() const { return count > MAX; }
+
+		void add(const Piece pc, const Square f, const Square t) {
+			if (count < MAX) {
+				piece[count] = pc;
+				from[count] = f;
+				to[count] = t;
+			}
+			count += count <= MAX;
+		}
+	};
+
+	// First layer output of both perspectives, kept in the state of every position
+	struct alignas(64) Accumulator {
+		std::array<std::array<int16_t, HALF_DIMS>, COLOR_NB> values;
+		std::array<bool, COLOR_NB> computed = { false, false };
+	};
+
+	// Loads network weights, returns false and keeps the current network if the file is missing or malformed
+	bool load(const std::string& path);
+
+	// Writes the current network in the format load reads
+	bool save(const std::string& path);
+
+	// Fills the network with small random weights, for tests and benchmarks without a weights file
+	void randomize(uint64_t seed);
+
+	// Drops the network, the evaluation falls back to the hand-crafted one
+	void unload();
+
+	[[nodiscard]] bool isLoaded();
+
+	// Instruction set the layers were compiled for: "AVX-512", "AVX2", "SSE2" or "scalar"
+	[[nodiscard]] const char* simdName();
+
+	// Brings the accumulator of the position's state up to date. Search threads share the states
+	// of the game before the root, so the root is computed once before they start
+	void updateAccumulator(const Position& pos);
+
+	// Evaluation from the side to move's point of view, updating the accumulator of the
+	// position's state incrementally from the closest computed ancestor state
+	[[nodiscard]] Value evaluate(const Position& pos);
+
+	// Reference evaluation with a fresh accumulator and scalar code only, leaves the position's state alone
+	[[nodiscard]] Value evaluateScalar(const Position& pos);
+}
@@ -0,0 +1,131 @@
+#include "NnueTests.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Evaluate.h"
+#include "MoveGen.h"
+#include "Nnue.h"
+#include "Position.h"
+#include "Types.h"
+
+// NnueTests.cpp - Tests for the network evaluation, run on random weights
+
+namespace chess::tests
+{
+	// Test that saved weights load back into the same evaluation and that bad files are rejected
+	void testNetworkFile() {
+		bool success = true;
+		Position pos;
+		pos.set("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4");
+		const std::string path = tempPath("chess_nnue_test.bin");
+
+		nnue::randomize(1);
+		const Value original = nnue::evaluateScalar(pos);
+		success &= nnue::save(path);
+
+		nnue::randomize(2);
+		success &= (nnue::evaluateScalar(pos) != original);
+		success &= (nnue::load(path) && nnue::evaluateScalar(pos) == original);
+
+		// A missing file and a truncated one leave the loaded network in place
+		success &= !nnue::load(tempPath("chess_nnue_missing.bin"));
+		std::filesystem::resize_file(path, 1000);
+		success &= !nnue::load(path);
+		std::ofstream(path, std::ios::binary) << "not a network";
+		success &= !nnue::load(path);
+		success &= (nnue::isLoaded() && nnue::evaluateScalar(pos) == original);
+
+		std::remove(path.c_str());
+		report("Network file round trip", success);
+	}
+
+	// Test the incremental accumulator against full refreshes along random games with captures,
+	// castling, promotions, king moves, null moves and plies that are not evaluated
+	void testIncrementalAccumulator() {
+		bool success = true;
+		nnue::randomize(3);
+		std::mt19937 rng(7);
+
+		const std::vector<std::string> fens = {
+			START_FEN,
+			"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+			"n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+			"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+		};
+		for (const std::string& fen : fens) {
+			Position pos;
+			pos.set(fen);
+			std::vector<StateInfo> states(80);
+			std::vector<Move> played;
+			for (int ply = 0; ply < static_cast<int>(states.size()); ++ply) {
+				MoveList moves;
+				generate<LEGAL>(pos, moves);
+				if (moves.size() == 0)
+					break;
+
+				if (!pos.checkers() && rng() % 8 == 0) {
+					pos.doNullMove(states[ply]);
+					played.push_back(Move::none());
+				}
+				else {
+					const Move m = moves[static_cast<int>(rng() % moves.size())];
+					pos.doMove(m, states[ply]);
+					played.push_back(m);
+				}
+				if (rng() % 3 != 0)
+					success &= (nnue::evaluate(pos) == nnue::evaluateScalar(pos));
+			}
+
+			// Taking moves back reaches states whose accumulators were computed before
+			while (!played.empty()) {
+				const Move m = played.back();
+				played.pop_back();
+				if (m == Move::none())
+					pos.undoNullMove();
+				else
+					pos.undoMove(m);
+				success &= (nnue::evaluate(pos) == nnue::evaluateScalar(pos));
+			}
+		}
+
+		nnue::unload();
+		report("Incremental accumulator", success);
+	}
+
+	// Test that the static evaluation switches to the network while one is loaded
+	void testEvaluationSwitch() {
+		bool success = true;
+		Position pos;
+		pos.set("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4");
+		eval::Caches caches;
+
+		const Value handCrafted = eval::evaluate(pos, caches);
+		nnue::randomize(4);
+		const Value network = nnue::evaluate(pos);
+		success &= (eval::evaluate(pos, caches) == network);
+
+		// Known endgames keep their specialised evaluation
+		pos.set("8/8/8/4k3/8/8/8/3QK3 w - - 0 1");
+		success &= (eval::evaluate(pos, caches) > VALUE_DRAW + QueenValue);
+
+		nnue::unload();
+		pos.set("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4");
+		success &= (!nnue::isLoaded() && eval::evaluate(pos, caches) == handCrafted);
+
+		report("Evaluation switch", success);
+	}
+
+	void runAllNnueTests() {
+		std::cout << "Running Nnue tests...\n" << "\n";
+
+		testNetworkFile();
+		testIncrementalAccumulator();
+		testEvaluationSwitch();
+
+		std::cout << "\nNnue tests completed." << "\n";
+	}
+}
@@ -0,0 +1,153 @@
+#include "PackedPosition.h"
+#include <string>
+#include "BitBoard.h"
+#include "Epd.h"
+
+// PackedPosition.cpp - Fixed-size binary encoding of a position for training data
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// Nibble indices stay below 32 as the occupancy is checked first
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+#pragma warning(disable: 26482)
+
+namespace chess {
+
+	namespace {
+		constexpr uint8_t EP_PAWN = 12;
+		constexpr uint8_t CASTLING_ROOK[COLOR_NB] = { 13, 14 };
+		constexpr uint8_t BLACK_KING_TO_MOVE = 15;
+		constexpr size_t PIECES_OFFSET = 8;
+		constexpr size_t RULE50_OFFSET = 24;
+		constexpr size_t PLY_OFFSET = 25;
+
+		uint8_t pieceCode(const Piece pc) {
+			return static_cast<uint8_t>(colorOf(pc) * 6 + typeOf(pc) - PAWN);
+		}
+
+		// Castling right of the rook on square, none if it is not in a corner with its right
+		CastlingRights rookRight(const Position& pos, const Color c, const Square square) {
+			const CastlingRights kingSide = c == WHITE ? WHITE_OO : BLACK_OO;
+			const CastlingRights queenSide = c == WHITE ? WHITE_OOO : BLACK_OOO;
+			if (square == relativeSquare(c, H1) && pos.canCastle(kingSide))
+				return kingSide;
+			if (square == relativeSquare(c, A1) && pos.canCastle(queenSide))
+				return queenSide;
+			return NO_CASTLING;
+		}
+	}
+
+	PackedPosition pack(const Position& pos) {
+		PackedPosition packed;
+		const Bitboard occupied = pos.pieces();
+		for (size_t i = 0; i < 8; ++i)
+			packed.bytes[i] = static_cast<uint8_t>(occupied >> (8 * i));
+
+		const Color us = pos.sideToMove();
+		const Square epPawn = pos.epSquare() != NO_SQUARE ? pos.epSquare() - pawnPush(us) : NO_SQUARE;
+		size_t n = 0;
+		for (Bitboard b = occupied; b; ++n) {
+			const Square square = popLsb(b);
+			const Piece pc = pos.pieceOn(square);
+			uint8_t code = pieceCode(pc);
+			if (square == epPawn)
+				code = EP_PAWN;
+			else if (typeOf(pc) == ROOK && rookRight(pos, colorOf(pc), square) != NO_CASTLING)
+				code = CASTLING_ROOK[colorOf(pc)];
+			else if (pc == B_KING && us == BLACK)
+				code = BLACK_KING_TO_MOVE;
+			packed.bytes[PIECES_OFFSET + n / 2] |= static_cast<uint8_t>(code << (4 * (n & 1)));
+		}
+
+		packed.bytes[RULE50_OFFSET] = static_cast<uint8_t>(std::min(pos.rule50Count(), 255));
+		const int ply = std::min(pos.gamePly(), 0xFFFF);
+		packed.bytes[PLY_OFFSET] = static_cast<uint8_t>(ply);
+		packed.bytes[PLY_OFFSET + 1] = static_cast<uint8_t>(ply >> 8);
+		return packed;
+	}
+
+	bool unpack(const PackedPosition& packed, Position& pos) {
+		Bitboard occupied = 0;
+		for (size_t i = 0; i < 8; ++i)
+			occupied |= static_cast<Bitboard>(packed.bytes[i]) << (8 * i);
+		if (popCount(occupied) > 32)
+			return false;
+
+		// Board, castling and en passant from the piece codes
+		constexpr std::string_view PIECE_CHARS = "PNBRQKpnbrqk";
+		std::array<char, SQUARE_NB> board;
+		board.fill(' ');
+		Color sideToMove = WHITE;
+		std::string castling;
+		std::string ep = "-";
+		size_t n = 0;
+		for (Bitboard b = occupied; b; ++n) {
+			const Square square = popLsb(b);
+			const uint8_t code = (packed.bytes[PIECES_OFFSET + n / 2] >> (4 * (n & 1))) & 0xF;
+			if (code < EP_PAWN)
+				board[square] = PIECE_CHARS[code];
+			else if (code == EP_PAWN) {
+				const bool white = rankOf(square) == RANK_4;
+				if (!white && rankOf(square) != RANK_5)
+					return false;
+				board[square] = white ? 'P' : 'p';
+				ep = std::string{ static_cast<char>('a' + fileOf(square)), white ? '3' : '6' };
+			}
+			else if (code == BLACK_KING_TO_MOVE) {
+				board[square] = 'k';
+				sideToMove = BLACK;
+			}
+			else {
+				const Color c = code == CASTLING_ROOK[WHITE] ? WHITE : BLACK;
+				board[square] = c == WHITE ? 'R' : 'r';
+				if (square == relativeSquare(c, H1))
+					castling += c == WHITE ? 'K' : 'k';
+				else if (square == relativeSquare(c, A1))
+					castling += c == WHITE ? 'Q' : 'q';
+				else
+					return false;
+			}
+		}
+		if (ep != "-" && (ep[1] == '3') != (sideToMove == BLACK))
+			return false;
+
+		// Castling letters in FEN order, KQkq
+		std::string orderedCastling;
+		for (const char c : std::string_view("KQkq"))
+			if (castling.find(c) != std::string::npos)
+				orderedCastling += c;
+
+		std::string fen;
+		for (int r = RANK_8; r >= RANK_1; --r) {
+			int emptyCount = 0;
+			for (int f = FILE_A; f <= FILE_H; ++f) {
+				const char c = board[makeSquare(static_cast<File>(f), static_cast<Rank>(r))];
+				if (c == ' ') {
+					++emptyCount;
+					continue;
+				}
+				if (emptyCount)
+					fen += static_cast<char>('0' + emptyCount);
+				emptyCount = 0;
+				fen += c;
+			}
+			if (emptyCount)
+				fen += static_cast<char>('0' + emptyCount);
+			if (r > RANK_1)
+				fen += '/';
+		}
+		const int ply = packed.bytes[PLY_OFFSET] | (packed.bytes[PLY_OFFSET + 1] << 8);
+		fen.append(sideToMove == WHITE ? " w " : " b ").append(orderedCastling.empty() ? "-" : orderedCastling)
+			.append(" ").append(ep).append(" ").append(std::to_string(packed.bytes[RULE50_OFFSET]))
+			.append(" ").append(std::to_string(ply / 2 + 1));
+
+		epd::Record record;
+		if (!epd::parse(fen, record))
+			return false;
+		pos.set(record.fen);
+		return true;
+	}
+}
+#pragma warning(pop)
@@ -0,0 +1,27 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "Position.h"
+
+// PackedPosition.h - Fixed-size binary encoding of a position for training data
+
+namespace chess {
+
+	// Occupancy bitboard (8 bytes, little-endian), one 4-bit code per occupied square from A1 up
+	// (16 bytes, low nibble first), the halfmove clock (1 byte) and the game ply (2 bytes).
+	// Codes 0-5 and 6-11 are the white and black pieces pawn to king; 12 is a pawn that may be taken
+	// en passant, 13 and 14 a white and a black rook with its castling right and 15 the black king
+	// with black to move, so side to move, castling and en passant need no bytes of their own
+	struct PackedPosition {
+		static constexpr size_t SIZE = 27;
+		std::array<uint8_t, SIZE> bytes{};
+
+		bool operator==(const PackedPosition& other) const { return bytes == other.bytes; }
+	};
+
+	[[nodiscard]] PackedPosition pack(const Position& pos);
+
+	// Sets pos to the packed position, false (pos unchanged) if the bytes cannot be one. Uses
+	// Position::set, so replaying moves from one unpacked position is much faster than unpacking each
+	bool unpack(const PackedPosition& packed, Position& pos);
+}
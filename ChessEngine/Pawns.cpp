@@ -0,0 +1,157 @@
+#include "Pawns.h"
+#include <algorithm>
+#include "BitBoard.h"
+
+// Pawns.cpp - Pawn structure evaluation cached in a per-thread hash table keyed by the pawn key
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// Colors, ranks and table indices are in range by construction,
+// the table index is masked by the power of two table size
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+#pragma warning(disable: 26482)
+
+namespace chess::pawns {
+
+	namespace {
+		// Structure penalties
+		constexpr Score ISOLATED = makeScore(5, 15);
+		constexpr Score DOUBLED = makeScore(11, 56);
+		constexpr Score BACKWARD = makeScore(9, 24);
+
+		// Passed pawn bonus by relative rank
+		constexpr std::array<Score, RANK_NB> PASSED_RANK = {
+			makeScore(0, 0), makeScore(10, 28), makeScore(17, 33), makeScore(15, 41),
+			makeScore(62, 72), makeScore(168, 177), makeScore(276, 260), makeScore(0, 0)
+		};
+
+		// Shield bonus by relative rank of the closest friendly pawn on a file next to the king, RANK_1 if there is none
+		constexpr std::array<int, RANK_NB> SHIELD = { -30, 40, 25, 8, 0, 0, 0, 0 };
+
+		// Storm penalty by relative rank of the closest enemy pawn on a file next to the king, RANK_1 if there is none
+		constexpr std::array<int, RANK_NB> STORM = { 0, 0, 60, 40, 15, 0, 0, 0 };
+		constexpr int BLOCKED_STORM = 10;
+
+		// Endgame penalty per square between the king and its closest pawn
+		constexpr int PAWN_DISTANCE = 16;
+
+		template<Color Us>
+		Score evaluateSide(const Position& pos, Entry& e) {
+			constexpr Color Them = ~Us;
+			const Bitboard ours = pos.pieces(Us, PAWN);
+			const Bitboard theirs = pos.pieces(Them, PAWN);
+
+			e.pawnAttacks[Us] = pawnAttacksBB<Us>(ours);
+			e.pawnAttacksSpan[Us] = pawnAttackSpans<Us>(ours);
+
+			const Bitboard files = fileFill(ours);
+			const Bitboard isolated = ours & ~(shift<EAST>(files) | shift<WEST>(files));
+			const Bitboard doubled = ours & rearSpans<Us>(ours);
+
+			// Backward: the stop square is attacked by an enemy pawn and no friendly pawn can ever defend it
+			const Bitboard stops = shift<pawnPush(Us)>(ours);
+			const Bitboard backward = shift<pawnPush(Them)>(stops & pawnAttacksBB<Them>(theirs) & ~e.pawnAttacksSpan[Us])
+				& ~isolated;
+
+			// Passed: no enemy pawn in front or able to capture on the way, the rear pawn of a doubled pair doesn't count
+			e.passedPawns[Us] = ours & ~(frontSpans<Them>(theirs) | pawnAttackSpans<Them>(theirs) | rearSpans<Us>(ours));
+
+			Score score = SCORE_ZERO;
+			score -= ISOLATED * popCount(isolated);
+			score -= DOUBLED * popCount(doubled);
+			score -= BACKWARD * popCount(backward);
+			for (Bitboard b = e.passedPawns[Us]; b; )
+				score += PASSED_RANK[relativeRank(Us, popLsb(b))];
+			return score;
+		}
+
+		// Shield and storm on the king file and its neighbours for a king on ksq, midgame only
+		template<Color Us>
+		Score shelter(const Position& pos, const Square ksq) {
+			constexpr Color Them = ~Us;
+
+			// Pawns behind the king neither shield nor storm it
+			const Bitboard inFront = forwardFill<Us>(RANK_MASK_1 << (8 * rankOf(ksq)));
+			const Bitboard ours = pos.pieces(Us, PAWN) & inFront;
+			const Bitboard theirs = pos.pieces(Them, PAWN) & inFront;
+
+			int bonus = 0;
+			const File center = std::clamp(fileOf(ksq), FILE_B, FILE_G);
+			for (File f = static_cast<File>(center - 1); f <= center + 1; ++f) {
+				const Bitboard file = FILE_MASK_A << f;
+				const Bitboard b = ours & file;
+				const Bitboard t = theirs & file;
+				const Rank ourRank = b ? relativeRank(Us, Us == WHITE ? lsb(b) : msb(b)) : RANK_1;
+				const Rank theirRank = t ? relativeRank(Us, Us == WHITE ? lsb(t) : msb(t)) : RANK_1;
+
+				bonus += SHIELD[ourRank];
+				bonus -= ourRank != RANK_1 && ourRank + 1 == theirRank ? BLOCKED_STORM : STORM[theirRank];
+			}
+			return makeScore(bonus, 0);
+		}
+
+		template<Color Us>
+		Score kingSafety(const Position& pos, const Square ksq, const CastlingRights rights) {
+			// With castling rights left, the king may still reach the better shelter
+			Score score = shelter<Us>(pos, ksq);
+			if (rights & KING_SIDE) {
+				const Score castled = shelter<Us>(pos, relativeSquare(Us, G1));
+				if (mgValue(castled) > mgValue(score))
+					score = castled;
+			}
+			if (rights & QUEEN_SIDE) {
+				const Score castled = shelter<Us>(pos, relativeSquare(Us, C1));
+				if (mgValue(castled) > mgValue(score))
+					score = castled;
+			}
+
+			// In the endgame the king should stay close to its pawns
+			int minDistance = 0;
+			Bitboard pawns = pos.pieces(Us, PAWN);
+			if (pawns) {
+				minDistance = 8;
+				while (pawns)
+					minDistance = std::min(minDistance, distance<Square>(ksq, popLsb(pawns)));
+			}
+			return score - makeScore(0, PAWN_DISTANCE * minDistance);
+		}
+	}
+
+	Score Entry::kingSafety(const Position& pos, const Color c) {
+		const Square ksq = pos.kingSquare(c);
+		const auto rights = static_cast<CastlingRights>(pos.castlingRights() & (c == WHITE ? WHITE_CASTLING : BLACK_CASTLING));
+		if (kingSquares[c] != ksq || kingCastling[c] != rights) {
+			kingSquares[c] = ksq;
+			kingCastling[c] = rights;
+			shelters[c] = c == WHITE ? pawns::kingSafety<WHITE>(pos, ksq, rights) : pawns::kingSafety<BLACK>(pos, ksq, rights);
+		}
+		return shelters[c];
+	}
+
+	Entry* Table::probe(const Position& pos) {
+		const HashKey key = pos.pawnKey();
+		Entry* entry = &m_entries[key & (SIZE - 1)];
+		++m_probes;
+		if (entry->key == key) {
+			++m_hits;
+			return entry;
+		}
+		entry->key = key;
+		evaluate(pos, *entry);
+		return entry;
+	}
+
+	void Table::clear() {
+		std::fill(m_entries.begin(), m_entries.end(), Entry{});
+		m_probes = m_hits = 0;
+	}
+
+	void evaluate(const Position& pos, Entry& entry) {
+		entry.scores[WHITE] = evaluateSide<WHITE>(pos, entry);
+		entry.scores[BLACK] = evaluateSide<BLACK>(pos, entry);
+		entry.kingSquares = { NO_SQUARE, NO_SQUARE };
+	}
+}
+#pragma warning(pop)
@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Position.h"
+#include "Types.h"
+
+// Pawns.h - Pawn structure evaluation cached in a per-thread hash table keyed by the pawn key
+
+namespace chess::pawns {
+
+	// Pawn structure terms of one pawn configuration for both colors
+	struct Entry {
+		HashKey key = 0;
+		std::array<Score, COLOR_NB> scores{};             // Passed, isolated, doubled and backward pawns
+		std::array<Bitboard, COLOR_NB> passedPawns{};
+		std::array<Bitboard, COLOR_NB> pawnAttacks{};     // Squares attacked by pawns now
+		std::array<Bitboard, COLOR_NB> pawnAttacksSpan{}; // Squares pawns attack now or after advancing
+
+		// The king shelter depends on the king square and castling rights as well, so it is cached
+		// for the last ones seen and recomputed when they change
+		std::array<Square, COLOR_NB> kingSquares{ NO_SQUARE, NO_SQUARE };
+		std::array<CastlingRights, COLOR_NB> kingCastling{ NO_CASTLING, NO_CASTLING };
+		std::array<Score, COLOR_NB> shelters{};
+
+		// Pawn shield and pawn storm in front of the king of color c
+		[[nodiscard]] Score kingSafety(const Position& pos, Color c);
+	};
+
+	// Hash table of pawn entries, each search thread owns one so there is no locking
+	class Table {
+	public:
+		static constexpr size_t SIZE = 16384;  // Power of two
+
+		Table() : m_entries(SIZE) {}
+
+		// Entry for the pawn structure of the position, evaluated on a miss
+		[[nodiscard]] Entry* probe(const Position& pos);
+		void clear();
+
+		[[nodiscard]] uint64_t probes() const { return m_probes; }
+		[[nodiscard]] uint64_t hits() const { return m_hits; }
+		[[nodiscard]] double hitRate() const { return m_probes ? static_cast<double>(m_hits) / static_cast<double>(m_probes) : 0.0; }
+
+	private:
+		std::vector<Entry> m_entries;
+		uint64_t m_probes = 0;
+		uint64_t m_hits = 0;
+	};
+
+	// Evaluates the pawn structure of the position into the entry from scratch
+	void evaluate(const Position& pos, Entry& entry);
+}
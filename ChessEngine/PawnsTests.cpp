@@ -0,0 +1,162 @@
+#include "PawnsTests.h"
+#include <cctype>
+#include <iostream>
+#include <string>
+
+#include "BitBoard.h"
+#include "Pawns.h"
+#include "Position.h"
+#include "Types.h"
+
+// PawnsTests.cpp - Tests for the pawn structure evaluation and pawn hash
+
+namespace chess::tests
+{
+	namespace {
+		// The position with colors swapped and the board flipped vertically
+		std::string mirrorFen(const std::string& fen) {
+			const size_t boardEnd = fen.find(' ');
+			std::string board = fen.substr(0, boardEnd);
+			std::string ranks[8];
+			int rank = 0;
+			for (const char c : board) {
+				if (c == '/')
+					++rank;
+				else
+					ranks[rank] += std::isalpha(static_cast<unsigned char>(c)) ? static_cast<char>(c ^ 0x20) : c;
+			}
+			std::string mirrored;
+			for (int r = 7; r >= 0; --r)
+				mirrored += ranks[r] + (r ? "/" : "");
+			const char side = fen[boardEnd + 1] == 'w' ? 'b' : 'w';
+			return mirrored + " " + side + " - - 0 1";
+		}
+	}
+
+	// Test passed pawn detection, including a doubled pair and a pawn stopped by an attack span
+	void testPassedPawns() {
+		bool success = true;
+		Position pos;
+		pawns::Entry entry;
+
+		// b3 is passed, b2 is behind it, e2 would have to pass d5's attacks and d5 e2's
+		pos.set("4k3/8/8/3p4/8/1P6/1P2P3/4K3 w - - 0 1");
+		pawns::evaluate(pos, entry);
+		success &= (entry.passedPawns[WHITE] == squareToBB(B3));
+		success &= (entry.passedPawns[BLACK] == 0);
+		success &= (entry.pawnAttacks[WHITE] == (squareToBB(A4) | squareToBB(C4) | squareToBB(A3) | squareToBB(C3)
+			| squareToBB(D3) | squareToBB(F3)));
+
+		// Blocked pawns on the same file are never passed, an outside pawn is
+		pos.set("4k3/p7/8/4p3/4P3/8/8/4K3 w - - 0 1");
+		pawns::evaluate(pos, entry);
+		success &= (entry.passedPawns[WHITE] == 0);
+		success &= (entry.passedPawns[BLACK] == squareToBB(A7));
+
+		report("Passed pawns", success);
+	}
+
+	// Test that weak pawns cost and the evaluation is symmetric between the colors
+	void testPawnStructureScores() {
+		bool success = true;
+		Position pos;
+		pawns::Entry entry;
+		pawns::Entry mirrored;
+
+		const std::string fens[] = {
+			"4k3/8/8/3p4/8/1P6/1P2P3/4K3 w - - 0 1",
+			"r1bqkb1r/pp3ppp/2n1pn2/3p4/2PP4/2N2N2/PP3PPP/R1BQKB1R w KQkq - 0 7",
+			"4k3/2p5/1p1p4/8/3P4/2P5/PP6/4K3 b - - 0 1"
+		};
+		for (const std::string& fen : fens) {
+			pos.set(fen);
+			pawns::evaluate(pos, entry);
+			pos.set(mirrorFen(fen));
+			pawns::evaluate(pos, mirrored);
+			success &= (entry.scores[WHITE] == mirrored.scores[BLACK] && entry.scores[BLACK] == mirrored.scores[WHITE]);
+		}
+
+		// Same pawns on connected files versus doubled and isolated
+		pos.set("4k3/8/8/8/8/8/3PP3/4K3 w - - 0 1");
+		pawns::evaluate(pos, entry);
+		const Score healthy = entry.scores[WHITE];
+		pos.set("4k3/8/8/8/8/3P4/3P4/4K3 w - - 0 1");
+		pawns::evaluate(pos, entry);
+		success &= (mgValue(entry.scores[WHITE]) < mgValue(healthy) && egValue(entry.scores[WHITE]) < egValue(healthy));
+
+		// c3 cannot advance safely and has no pawn left that could defend it
+		pos.set("4k3/8/8/3p4/1P6/2P5/8/4K3 w - - 0 1");
+		pawns::evaluate(pos, entry);
+		const Score backward = entry.scores[WHITE];
+		pos.set("4k3/8/8/3p4/8/1PP5/8/4K3 w - - 0 1");
+		pawns::evaluate(pos, entry);
+		success &= (mgValue(backward) < mgValue(entry.scores[WHITE]));
+
+		report("Pawn structure scores", success);
+	}
+
+	// Test that the king shelter prefers an intact shield and is recomputed when the king moves
+	void testKingShelter() {
+		bool success = true;
+		Position pos;
+		pawns::Entry entry;
+
+		pos.set("6k1/5ppp/8/8/8/8/5PPP/6K1 w - - 0 1");
+		pawns::evaluate(pos, entry);
+		const Score intact = entry.kingSafety(pos, WHITE);
+		success &= (entry.kingSafety(pos, WHITE) == intact);
+		success &= (entry.kingSafety(pos, BLACK) == intact);
+
+		pos.set("6k1/5ppp/8/8/8/6P1/5P1P/6K1 w - - 0 1");
+		pawns::evaluate(pos, entry);
+		success &= (mgValue(entry.kingSafety(pos, WHITE)) < mgValue(intact));
+
+		// Same pawns, king walked away from them: shelter and endgame distance both get worse
+		pos.set("6k1/5ppp/8/8/8/8/5PPP/1K6 w - - 0 1");
+		pawns::evaluate(pos, entry);
+		const Score away = entry.kingSafety(pos, WHITE);
+		success &= (mgValue(away) < mgValue(intact) && egValue(away) < egValue(intact));
+
+		report("King shelter", success);
+	}
+
+	// Test that repeated probes of a pawn structure hit and that the hit rate is counted
+	void testPawnTable() {
+		bool success = true;
+		pawns::Table table;
+		Position pos;
+
+		pos.set(START_FEN);
+		const pawns::Entry* first = table.probe(pos);
+		success &= (table.probes() == 1 && table.hits() == 0);
+
+		// A knight move keeps the pawn key
+		StateInfo st;
+		pos.doMove(Move(G1, F3), st);
+		const pawns::Entry* second = table.probe(pos);
+		success &= (second == first && table.hits() == 1);
+		success &= (table.hitRate() == 0.5);
+
+		// The cached entry equals a fresh evaluation
+		pawns::Entry fresh;
+		pawns::evaluate(pos, fresh);
+		success &= (second->scores == fresh.scores && second->passedPawns == fresh.passedPawns
+			&& second->pawnAttacksSpan == fresh.pawnAttacksSpan);
+
+		table.clear();
+		success &= (table.probes() == 0 && table.hits() == 0);
+
+		report("Pawn hash table", success);
+	}
+
+	void runAllPawnsTests() {
+		std::cout << "Running Pawns tests...\n" << "\n";
+
+		testPassedPawns();
+		testPawnStructureScores();
+		testKingShelter();
+		testPawnTable();
+
+		std::cout << "\nPawns tests completed." << "\n";
+	}
+}
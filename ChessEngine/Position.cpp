@@ -1,8 +1,13 @@
 #include "Position.h"
 
+#include <cstddef>
+#include <cstring>
 #include <random>
+#include <sstream>
 
 #include "BitBoard.h"
+#include "MagicBB.h"
+#include "MoveGen.h"
 
 // Position.cpp - Chess position representation and manipulation
 
@@ -37,6 +42,7 @@ namespace chess {
 		epSquare(NO_SQUARE),
 		halfmoveClock(0),
 		fullmoveNumber(1),
+		pliesFromNull(0),
 		capturedPiece(NO_PIECE),
 		repetition(0),
 		previous(nullptr)
@@ -76,6 +82,30 @@ namespace chess {
 
 		// No pawns key (used for pawn hash evaluation)
 		zobrist::g_noPawns = rng();
+
+		psqt::init();
+	}
+
+	Position& Position::operator=(const Position& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		m_board = other.m_board;
+		m_pieceBB = other.m_pieceBB;
+		m_colorBB = other.m_colorBB;
+		m_pieceCount = other.m_pieceCount;
+		m_psq = other.m_psq;
+		m_phase = other.m_phase;
+		m_castlingRightsMask = other.m_castlingRightsMask;
+		m_castlingRookSquare = other.m_castlingRookSquare;
+		m_castlingPath = other.m_castlingPath;
+		m_startState = other.m_startState;
+		m_gamePly = other.m_gamePly;
+
+		// Point at our own copy of the start state, later states are shared read-only
+		m_state = other.m_state == &other.m_startState ? &m_startState : other.m_state;
+		return *this;
 	}
 
 	void Position::clear() noexcept
@@ -85,6 +115,8 @@ namespace chess {
 		std::fill(m_pieceBB.begin(), m_pieceBB.end(), Bitboard{0});
 		std::fill(m_colorBB.begin(), m_colorBB.end(), Bitboard{0});
 		std::fill(m_pieceCount.begin(), m_pieceCount.end(), 0);
+		m_psq = SCORE_ZERO;
+		m_phase = 0;
 
 		// Clear castling data
 		std::fill(m_castlingRightsMask.begin(), m_castlingRightsMask.end(), 0);
@@ -107,9 +139,13 @@ namespace chess {
 		m_state->epSquare = NO_SQUARE;
 		m_state->halfmoveClock = 0;
 		m_state->fullmoveNumber = 1;
+		m_state->pliesFromNull = 0;
 		m_state->capturedPiece = NO_PIECE;
+		m_state->dirtyPiece.count = 0;
+		m_state->accumulator.computed = { false, false };
 		m_state->repetition = 0;
 		m_state->previous = nullptr;
+		m_gamePly = 0;
 	}
 
 	void Position::putPiece(Piece piece, Square square) {
@@ -125,8 +161,11 @@ namespace chess {
 		m_pieceBB[typeOf(piece)] |= squareToBB(square);
 		m_colorBB[colorOf(piece)] |= squareToBB(square);
 
-		// Update piece count
+		// Update piece count, piece-square score, phase and the changes for the network
 		++m_pieceCount[piece];
+		m_state->dirtyPiece.add(piece, NO_SQUARE, square);
+		m_psq += psqt::g_psq[piece][square];
+		m_phase += psqt::PHASE_WEIGHTS[typeOf(piece)];
 	}
 
 	void Position::removePiece(Square square) {
@@ -143,8 +182,11 @@ namespace chess {
 		m_pieceBB[typeOf(piece)] &= ~squareToBB(square);
 		m_colorBB[colorOf(piece)] &= ~squareToBB(square);
 
-		// Update piece count
+		// Update piece count, piece-square score, phase and the changes for the network
 		--m_pieceCount[piece];
+		m_state->dirtyPiece.add(piece, square, NO_SQUARE);
+		m_psq -= psqt::g_psq[piece][square];
+		m_phase -= psqt::PHASE_WEIGHTS[typeOf(piece)];
 	}
 
 	void Position::movePiece(Square from, Square to) {
@@ -163,6 +205,580 @@ namespace chess {
 		m_pieceBB[ALL_PIECES] ^= fromToBB;
 		m_pieceBB[typeOf(piece)] ^= fromToBB;
 		m_colorBB[colorOf(piece)] ^= fromToBB;
+
+		// The phase is unchanged
+		m_psq += psqt::g_psq[piece][to] - psqt::g_psq[piece][from];
+		m_state->dirtyPiece.add(piece, from, to);
+	}
+
+	bool Position::psqConsistent() const {
+		Score psq = SCORE_ZERO;
+		int phase = 0;
+		for (Bitboard b = pieces(); b; ) {
+			const Square square = popLsb(b);
+			psq += psqt::g_psq[pieceOn(square)][square];
+			phase += psqt::PHASE_WEIGHTS[typeOf(pieceOn(square))];
+		}
+		return psq == m_psq && phase == m_phase;
+	}
+
+	// Set up the position from a FEN string
+	Position& Position::set(const std::string& fen) {
+		clear();
+		std::istringstream ss(fen);
+		ss >> std::noskipws;
+		unsigned char token = 0;
+
+		// 1. Piece placement, starting from A8
+		constexpr std::string_view pieceChars(" PNBRQK  pnbrqk");
+		Square square = A8;
+		while ((ss >> token) && !isspace(token)) {
+			if (isdigit(token))
+				square = square + static_cast<Direction>((token - '0') * EAST);
+			else if (token == '/')
+				square = square + static_cast<Direction>(2 * SOUTH);
+			else if (const size_t idx = pieceChars.find(token); idx != std::string_view::npos) {
+				putPiece(static_cast<Piece>(idx), square);
+				++square;
+			}
+		}
+
+		// 2. Side to move
+		ss >> token;
+		m_state->activeColor = (token == 'w' ? WHITE : BLACK);
+		ss >> token;
+
+		// 3. Castling availability (standard chess only, rooks start in the corners)
+		while ((ss >> token) && !isspace(token)) {
+			const Color c = islower(token) ? BLACK : WHITE;
+			token = static_cast<unsigned char>(toupper(token));
+			if (token == 'K')
+				setCastlingRight(c, relativeSquare(c, H1));
+			else if (token == 'Q')
+				setCastlingRight(c, relativeSquare(c, A1));
+		}
+
+		// 4. En passant square, only kept if a pawn can actually capture on it
+		unsigned char col = 0, row = 0;
+		if (((ss >> col) && (col >= 'a' && col <= 'h'))
+			&& ((ss >> row) && (row == '3' || row == '6'))) {
+			const Square ep = makeSquare(static_cast<File>(col - 'a'), static_cast<Rank>(row - '1'));
+			const Color us = sideToMove();
+			if (g_pawnAttacks[~us][ep] & pieces(us, PAWN)
+				&& pieces(~us, PAWN) & squareToBB(ep - pawnPush(us)))
+				m_state->epSquare = ep;
+		}
+
+		// 5-6. Halfmove clock and fullmove number
+		ss >> std::skipws >> m_state->halfmoveClock >> m_state->fullmoveNumber;
+		m_state->fullmoveNumber = std::max(m_state->fullmoveNumber, 1);
+		m_gamePly = 2 * (m_state->fullmoveNumber - 1) + (sideToMove() == BLACK);
+
+		setState();
+		return *this;
+	}
+
+	// Returns the FEN string of the position
+	std::string Position::fen() const {
+		constexpr std::string_view pieceChars(" PNBRQK  pnbrqk");
+		std::ostringstream ss;
+
+		for (Rank r = RANK_8; r >= RANK_1; --r) {
+			for (File f = FILE_A; f <= FILE_H; ++f) {
+				int emptyCount = 0;
+				for (; f <= FILE_H && empty(makeSquare(f, r)); ++f)
+					++emptyCount;
+				if (emptyCount)
+					ss << emptyCount;
+				if (f <= FILE_H)
+					ss << pieceChars[pieceOn(makeSquare(f, r))];
+			}
+			if (r > RANK_1)
+				ss << '/';
+		}
+
+		ss << (sideToMove() == WHITE ? " w " : " b ");
+		if (canCastle(WHITE_OO))  ss << 'K';
+		if (canCastle(WHITE_OOO)) ss << 'Q';
+		if (canCastle(BLACK_OO))  ss << 'k';
+		if (canCastle(BLACK_OOO)) ss << 'q';
+		if (!canCastle(ANY_CASTLING)) ss << '-';
+
+		ss << (epSquare() == NO_SQUARE ? std::string(" - ") : " " + squareToString(epSquare()) + " ")
+			<< m_state->halfmoveClock << " " << m_state->fullmoveNumber;
+		return ss.str();
+	}
+
+	// Register a castling right for the king of color c and the rook on rookFrom
+	void Position::setCastlingRight(const Color c, const Square rookFrom) {
+		const Square kingFrom = kingSquare(c);
+		const bool kingSide = kingFrom < rookFrom;
+		const auto cr = static_cast<CastlingRights>((c == WHITE ? WHITE_CASTLING : BLACK_CASTLING) & (kingSide ? KING_SIDE : QUEEN_SIDE));
+
+		m_state->castlingRights = static_cast<CastlingRights>(m_state->castlingRights | cr);
+		m_castlingRightsMask[kingFrom] |= cr;
+		m_castlingRightsMask[rookFrom] |= cr;
+		m_castlingRookSquare[cr] = rookFrom;
+
+		// Every square the king and rook pass over or land on must be empty
+		const Square kingTo = relativeSquare(c, kingSide ? G1 : C1);
+		const Square rookTo = relativeSquare(c, kingSide ? F1 : D1);
+		m_castlingPath[cr] = (g_betweenBB[rookFrom][rookTo] | g_betweenBB[kingFrom][kingTo]
+			| squareToBB(rookTo) | squareToBB(kingTo)) & ~(squareToBB(kingFrom) | squareToBB(rookFrom));
+	}
+
+	// Compute hash keys, material and check info from scratch
+	void Position::setState() {
+		m_state->positionKey = m_state->materialKey = 0;
+		m_state->pawnKey = zobrist::g_noPawns;
+		m_state->nonPawnMaterial[WHITE] = m_state->nonPawnMaterial[BLACK] = VALUE_ZERO;
+
+		for (Bitboard b = pieces(); b; ) {
+			const Square square = popLsb(b);
+			const Piece piece = pieceOn(square);
+			m_state->positionKey ^= zobrist::g_pieceSq[piece][square];
+			if (typeOf(piece) == PAWN)
+				m_state->pawnKey ^= zobrist::g_pieceSq[piece][square];
+			else if (typeOf(piece) != KING)
+				m_state->nonPawnMaterial[colorOf(piece)] += PieceValues[typeOf(piece)];
+		}
+
+		if (m_state->epSquare != NO_SQUARE)
+			m_state->positionKey ^= zobrist::g_enpassant[fileOf(m_state->epSquare)];
+		if (sideToMove() == BLACK)
+			m_state->positionKey ^= zobrist::g_side;
+		m_state->positionKey ^= zobrist::g_castling[m_state->castlingRights];
+
+		// Material key has one key per piece and count
+		for (Piece piece = W_PAWN; piece < PIECE_NB; ++piece)
+			for (int cnt = 0; cnt < m_pieceCount[piece]; ++cnt)
+				m_state->materialKey ^= zobrist::materialKey(piece, cnt);
+
+		setCheckInfo();
+	}
+
+	// Update checkers, king blockers and pinners for the side to move
+	void Position::setCheckInfo() {
+		m_state->checkersBB = attackersTo(kingSquare(sideToMove())) & pieces(~sideToMove());
+		m_state->blockersForKing[WHITE] = sliderBlockers(pieces(BLACK), kingSquare(WHITE), m_state->pinners[WHITE]);
+		m_state->blockersForKing[BLACK] = sliderBlockers(pieces(WHITE), kingSquare(BLACK), m_state->pinners[BLACK]);
+	}
+
+	// Returns pieces (of both colors) that alone block a slider from attacking square,
+	// sliders of the other color that pin a piece of the square's owner are stored in pinners
+	Bitboard Position::sliderBlockers(const Bitboard sliders, const Square square, Bitboard& pinners) const {
+		Bitboard blockers = 0;
+		pinners = 0;
+
+		// Snipers are sliders that attack the square when all other pieces are removed
+		Bitboard snipers = ((g_pseudoAttacks[ROOK][square] & pieces(QUEEN, ROOK))
+			| (g_pseudoAttacks[BISHOP][square] & pieces(QUEEN, BISHOP))) & sliders;
+		const Bitboard occupancy = pieces() ^ snipers;
+
+		while (snipers) {
+			const Square sniperSq = popLsb(snipers);
+			const Bitboard b = g_betweenBB[square][sniperSq] & occupancy;
+			if (b && !moreThanOne(b)) {
+				blockers |= b;
+				if (b & pieces(colorOf(pieceOn(square))))
+					pinners |= squareToBB(sniperSq);
+			}
+		}
+		return blockers;
+	}
+
+	// Returns all pieces attacking the square with the given occupancy
+	Bitboard Position::attackersTo(const Square square, const Bitboard occupied) const {
+		return (g_pawnAttacks[BLACK][square] & pieces(WHITE, PAWN))
+			| (g_pawnAttacks[WHITE][square] & pieces(BLACK, PAWN))
+			| (g_pseudoAttacks[KNIGHT][square] & pieces(KNIGHT))
+			| (getRookAttacks(square, occupied) & pieces(ROOK, QUEEN))
+			| (getBishopAttacks(square, occupied) & pieces(BISHOP, QUEEN))
+			| (g_pseudoAttacks[KING][square] & pieces(KING));
+	}
+
+	bool Position::isDraw(const int ply) const {
+		// The 50-move rule does not apply if the last move was checkmate
+		if (m_state->halfmoveClock > 99) {
+			if (!checkers())
+				return true;
+			MoveList moves;
+			generate<LEGAL>(*this, moves);
+			if (!moves.empty())
+				return true;
+		}
+
+		// A repetition after the root, or one that had already repeated before (negative distance)
+		return m_state->repetition && m_state->repetition < ply;
+	}
+
+	// Tests whether a pseudo-legal move leaves our king safe
+	bool Position::legal(const Move m) const {
+		assert(m.validMove());
+		const Color us = sideToMove();
+		const Square from = m.fromSq();
+		const Square to = m.toSq();
+		const Square kingSq = kingSquare(us);
+
+		// En passant removes two pieces from the king's lines, check the sliders directly
+		if (m.moveType() == EN_PASSANT) {
+			const Square capSq = to - pawnPush(us);
+			const Bitboard occupied = (pieces() ^ squareToBB(from) ^ squareToBB(capSq)) | squareToBB(to);
+			return !(getRookAttacks(kingSq, occupied) & pieces(~us, QUEEN, ROOK))
+				&& !(getBishopAttacks(kingSq, occupied) & pieces(~us, QUEEN, BISHOP));
+		}
+
+		// Castling is generated only out of check and with an empty path, the king may not cross attacked squares
+		if (m.moveType() == CASTLING) {
+			for (Bitboard path = g_betweenBB[from][to] | squareToBB(to); path; )
+				if (attackersTo(popLsb(path)) & pieces(~us))
+					return false;
+			return true;
+		}
+
+		// King moves must not land on an attacked square (the king itself does not block)
+		if (typeOf(pieceOn(from)) == KING)
+			return !(attackersTo(to, pieces() ^ squareToBB(from)) & pieces(~us));
+
+		// Other pieces may move only if unpinned or along the pin line
+		return !(blockersForKing(us) & squareToBB(from)) || (g_throughBB[from][to] & squareToBB(kingSq));
+	}
+
+	// Moves king and rook for castling (Do = true) or puts them back (Do = false)
+	template<bool Do>
+	void Position::doCastling(const Color us, const Square from, const Square to, Square& rookFrom, Square& rookTo) {
+		const bool kingSide = to > from;
+		rookFrom = m_castlingRookSquare[(us == WHITE ? WHITE_CASTLING : BLACK_CASTLING) & (kingSide ? KING_SIDE : QUEEN_SIDE)];
+		rookTo = relativeSquare(us, kingSide ? F1 : D1);
+
+		removePiece(Do ? from : to);
+		removePiece(Do ? rookFrom : rookTo);
+		putPiece(makePiece(us, KING), Do ? to : from);
+		putPiece(makePiece(us, ROOK), Do ? rookTo : rookFrom);
+	}
+
+	// Approximate key after a move, used to prefetch hash entries. Castling, en passant
+	// and promotions are not accounted for, which only makes the prefetch miss
+	HashKey Position::keyAfter(const Move m) const {
+		const Square from = m.fromSq();
+		const Square to = m.toSq();
+		const Piece piece = pieceOn(from);
+		const Piece captured = pieceOn(to);
+		HashKey k = key() ^ zobrist::g_side ^ zobrist::g_pieceSq[piece][from] ^ zobrist::g_pieceSq[piece][to];
+		if (captured != NO_PIECE && m.moveType() != CASTLING)
+			k ^= zobrist::g_pieceSq[captured][to];
+		if (epSquare() != NO_SQUARE)
+			k ^= zobrist::g_enpassant[fileOf(epSquare())];
+		return k;
+	}
+
+	// Copies the current state into newState and makes it current. The accumulator is left out,
+	// copying it at every move would cost more than updating it when the position is evaluated
+	void Position::copyState(StateInfo& newState) {
+		std::memcpy(static_cast<void*>(&newState), m_state, offsetof(StateInfo, accumulator));
+		newState.previous = m_state;
+		newState.dirtyPiece.count = 0;
+		newState.accumulator.computed = { false, false };
+		m_state = &newState;
+	}
+
+	// Make a move, the new state is linked to the current one
+	void Position::doMove(const Move m, StateInfo& newState) {
+		assert(m.validMove());
+		assert(&newState != m_state);
+
+		copyState(newState);
+		++m_gamePly;
+		++m_state->halfmoveClock;
+		++m_state->pliesFromNull;
+
+		HashKey key = m_state->positionKey ^ zobrist::g_side;
+		const Color us = sideToMove();
+		const Color them = ~us;
+		const Square from = m.fromSq();
+		Square to = m.toSq();
+		const Piece piece = pieceOn(from);
+		Piece captured = m.moveType() == EN_PASSANT ? makePiece(them, PAWN) : pieceOn(to);
+
+		assert(colorOf(piece) == us);
+		assert(captured == NO_PIECE || typeOf(captured) != KING);
+
+		if (m.moveType() == CASTLING) {
+			Square rookFrom, rookTo;
+			doCastling<true>(us, from, to, rookFrom, rookTo);
+			const Piece rook = makePiece(us, ROOK);
+			key ^= zobrist::g_pieceSq[rook][rookFrom] ^ zobrist::g_pieceSq[rook][rookTo];
+			captured = NO_PIECE;
+		}
+
+		if (captured != NO_PIECE) {
+			Square capSq = to;
+			if (typeOf(captured) == PAWN) {
+				if (m.moveType() == EN_PASSANT)
+					capSq = to - pawnPush(us);
+				m_state->pawnKey ^= zobrist::g_pieceSq[captured][capSq];
+			}
+			else
+				m_state->nonPawnMaterial[them] -= PieceValues[typeOf(captured)];
+
+			removePiece(capSq);
+			key ^= zobrist::g_pieceSq[captured][capSq];
+			m_state->materialKey ^= zobrist::materialKey(captured, m_pieceCount[captured]);
+			m_state->halfmoveClock = 0;
+		}
+
+		// Reset en passant square
+		if (m_state->epSquare != NO_SQUARE) {
+			key ^= zobrist::g_enpassant[fileOf(m_state->epSquare)];
+			m_state->epSquare = NO_SQUARE;
+		}
+
+		// Update castling rights if a king or rook moves or a rook is captured
+		if (m_state->castlingRights && (m_castlingRightsMask[from] | m_castlingRightsMask[to])) {
+			key ^= zobrist::g_castling[m_state->castlingRights];
+			m_state->castlingRights = static_cast<CastlingRights>(m_state->castlingRights & ~(m_castlingRightsMask[from] | m_castlingRightsMask[to]));
+			key ^= zobrist::g_castling[m_state->castlingRights];
+		}
+
+		if (m.moveType() != CASTLING)
+			movePiece(from, to);
+		key ^= zobrist::g_pieceSq[piece][from] ^ zobrist::g_pieceSq[piece][to];
+
+		if (typeOf(piece) == PAWN) {
+			// Double push: set en passant square only if an enemy pawn can capture
+			if ((static_cast<int>(to) ^ static_cast<int>(from)) == 16
+				&& (g_pawnAttacks[us][to - pawnPush(us)] & pieces(them, PAWN))) {
+				m_state->epSquare = to - pawnPush(us);
+				key ^= zobrist::g_enpassant[fileOf(m_state->epSquare)];
+			}
+			else if (m.moveType() == PROMOTION) {
+				const Piece promotion = makePiece(us, m.promotionType());
+				removePiece(to);
+				putPiece(promotion, to);
+
+				key ^= zobrist::g_pieceSq[piece][to] ^ zobrist::g_pieceSq[promotion][to];
+				m_state->pawnKey ^= zobrist::g_pieceSq[piece][to];
+				m_state->materialKey ^= zobrist::materialKey(promotion, m_pieceCount[promotion] - 1)
+					^ zobrist::materialKey(piece, m_pieceCount[piece]);
+				m_state->nonPawnMaterial[us] += PieceValues[m.promotionType()];
+			}
+
+			m_state->pawnKey ^= zobrist::g_pieceSq[piece][from] ^ zobrist::g_pieceSq[piece][to];
+			m_state->halfmoveClock = 0;
+		}
+
+		m_state->capturedPiece = captured;
+		m_state->positionKey = key;
+		m_state->activeColor = them;
+		m_state->fullmoveNumber += (us == BLACK);
+
+		setCheckInfo();
+
+		// Repetition: distance to the previous occurrence, negative if it repeated before
+		m_state->repetition = 0;
+		const int end = std::min(m_state->halfmoveClock, m_state->pliesFromNull);
+		if (end >= 4) {
+			const StateInfo* stp = m_state->previous->previous;
+			for (int i = 4; i <= end; i += 2) {
+				stp = stp->previous->previous;
+				if (stp->positionKey == m_state->positionKey) {
+					m_state->repetition = stp->repetition ? -i : i;
+					break;
+				}
+			}
+		}
+	}
+
+	// Unmake a move, restoring the position to its state before doMove
+	void Position::undoMove(const Move m) {
+		assert(m.validMove());
+
+		const Color us = ~sideToMove();
+		const Square from = m.fromSq();
+		const Square to = m.toSq();
+
+		if (m.moveType() == PROMOTION) {
+			assert(typeOf(pieceOn(to)) == m.promotionType());
+			removePiece(to);
+			putPiece(makePiece(us, PAWN), to);
+		}
+
+		if (m.moveType() == CASTLING) {
+			Square rookFrom, rookTo;
+			doCastling<false>(us, from, to, rookFrom, rookTo);
+		}
+		else {
+			movePiece(to, from);
+			if (m_state->capturedPiece != NO_PIECE) {
+				const Square capSq = m.moveType() == EN_PASSANT ? to - pawnPush(us) : to;
+				putPiece(m_state->capturedPiece, capSq);
+			}
+		}
+
+		m_state = m_state->previous;
+		--m_gamePly;
+	}
+
+	// Pass the turn without moving (null move pruning), not allowed in check
+	void Position::doNullMove(StateInfo& newState) {
+		assert(!checkers());
+		assert(&newState != m_state);
+
+		copyState(newState);
+
+		if (m_state->epSquare != NO_SQUARE) {
+			m_state->positionKey ^= zobrist::g_enpassant[fileOf(m_state->epSquare)];
+			m_state->epSquare = NO_SQUARE;
+		}
+		m_state->positionKey ^= zobrist::g_side;
+		++m_state->halfmoveClock;
+		m_state->pliesFromNull = 0;
+		m_state->capturedPiece = NO_PIECE;
+		m_state->repetition = 0;
+		m_state->activeColor = ~m_state->activeColor;
+
+		// The board is unchanged: blockers and pinners stay valid and the opponent was not in check
+		assert(!(attackersTo(kingSquare(sideToMove())) & pieces(~sideToMove())));
+		m_state->checkersBB = 0;
+	}
+
+	void Position::undoNullMove() {
+		assert(!checkers());
+		m_state = m_state->previous;
+	}
+
+	// Tests whether a move (e.g. from the transposition table or a killer slot) is pseudo-legal here
+	bool Position::pseudoLegal(const Move m) const {
+		const Color us = sideToMove();
+		const Square from = m.fromSq();
+		const Square to = m.toSq();
+		const Piece piece = pieceOn(from);
+
+		// Special moves are rare, look them up in the generated list
+		if (m.moveType() != NORMAL) {
+			MoveList moveList;
+			if (checkers())
+				generate<EVASIONS>(*this, moveList);
+			else
+				generate<NON_EVASIONS>(*this, moveList);
+			return moveList.contains(m);
+		}
+
+		// A normal move has no promotion bits set
+		if (m.promotionType() != KNIGHT)
+			return false;
+
+		// The moving piece must be ours and the destination not occupied by our pieces
+		if (piece == NO_PIECE || colorOf(piece) != us || (pieces(us) & squareToBB(to)))
+			return false;
+
+		if (typeOf(piece) == PAWN) {
+			// Moves to the last rank must be promotions
+			if ((RANK_MASK_8 | RANK_MASK_1) & squareToBB(to))
+				return false;
+
+			const bool captureMove = g_pawnAttacks[us][from] & pieces(~us) & squareToBB(to);
+			const bool singlePush = from + pawnPush(us) == to && empty(to);
+			const bool doublePush = from + pawnPush(us) + pawnPush(us) == to && relativeRank(us, from) == RANK_2
+				&& empty(to) && empty(to - pawnPush(us));
+			if (!captureMove && !singlePush && !doublePush)
+				return false;
+		}
+		else if (!(getAttacks(typeOf(piece), from, pieces()) & squareToBB(to)))
+			return false;
+
+		// Evasions: non-king moves must capture or block a single checker, the king must step out of the attack
+		if (checkers()) {
+			if (typeOf(piece) != KING) {
+				if (moreThanOne(checkers()))
+					return false;
+				const Square checkerSq = lsb(checkers());
+				if (!((g_betweenBB[kingSquare(us)][checkerSq] | checkers()) & squareToBB(to)))
+					return false;
+			}
+			else if (attackersTo(to, pieces() ^ squareToBB(from)) & pieces(~us))
+				return false;
+		}
+		return true;
+	}
+
+	// Swap algorithm on the destination square, pinned pieces may not join the exchange
+	bool Position::seeGe(const Move m, const Value threshold) const {
+		assert(m.validMove());
+
+		// Castling, en passant and promotions are treated as neutral
+		if (m.moveType() != NORMAL)
+			return VALUE_ZERO >= threshold;
+
+		const Square from = m.fromSq();
+		const Square to = m.toSq();
+
+		int swap = PieceValues[typeOf(pieceOn(to))] - threshold;
+		if (swap < 0)
+			return false;
+
+		swap = PieceValues[typeOf(pieceOn(from))] - swap;
+		if (swap <= 0)
+			return true;
+
+		Bitboard occupied = pieces() ^ squareToBB(from) ^ squareToBB(to);
+		Color stm = sideToMove();
+		Bitboard attackers = attackersTo(to, occupied);
+		int res = 1;
+
+		while (true) {
+			stm = ~stm;
+			attackers &= occupied;
+
+			Bitboard stmAttackers = attackers & pieces(stm);
+			if (!stmAttackers)
+				break;
+
+			// Pieces pinned to their king may not recapture while the pinner is on the board
+			if (pinners(stm) & occupied)
+				stmAttackers &= ~blockersForKing(stm);
+			if (!stmAttackers)
+				break;
+
+			res ^= 1;
+
+			// Recapture with the least valuable attacker, revealing x-ray attackers behind it
+			Bitboard bb;
+			if ((bb = stmAttackers & pieces(PAWN))) {
+				if ((swap = PawnValue - swap) < res)
+					break;
+				occupied ^= squareToBB(lsb(bb));
+				attackers |= getBishopAttacks(to, occupied) & pieces(BISHOP, QUEEN);
+			}
+			else if ((bb = stmAttackers & pieces(KNIGHT))) {
+				if ((swap = KnightValue - swap) < res)
+					break;
+				occupied ^= squareToBB(lsb(bb));
+			}
+			else if ((bb = stmAttackers & pieces(BISHOP))) {
+				if ((swap = BishopValue - swap) < res)
+					break;
+				occupied ^= squareToBB(lsb(bb));
+				attackers |= getBishopAttacks(to, occupied) & pieces(BISHOP, QUEEN);
+			}
+			else if ((bb = stmAttackers & pieces(ROOK))) {
+				if ((swap = RookValue - swap) < res)
+					break;
+				occupied ^= squareToBB(lsb(bb));
+				attackers |= getRookAttacks(to, occupied) & pieces(ROOK, QUEEN);
+			}
+			else if ((bb = stmAttackers & pieces(QUEEN))) {
+				if ((swap = QueenValue - swap) < res)
+					break;
+				occupied ^= squareToBB(lsb(bb));
+				attackers |= (getBishopAttacks(to, occupied) & pieces(BISHOP, QUEEN))
+					| (getRookAttacks(to, occupied) & pieces(ROOK, QUEEN));
+			}
+			else
+				// The king may only capture if the opponent has no attackers left
+				return (attackers & ~pieces(stm)) ? res ^ 1 : res;
+		}
+		return static_cast<bool>(res);
 	}
 }
 #pragma warning(pop)
\ No newline at end of file
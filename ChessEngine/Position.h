@@ -1,6 +1,12 @@
 #pragma once
 #include "types.h"
+#include <algorithm>
 #include <array>
+#include <string>
+#include "BitBoard.h"
+#include "Move.h"
+#include "Nnue.h"
+#include "Psqt.h"
 
 // Position.h - Chess position representation and manipulation
 
@@ -13,8 +19,15 @@ namespace chess {
 		extern std::array<HashKey, CASTLING_RIGHT_NB> g_castling;			    // Castling rights keys
 		extern HashKey g_side;													// Side to move key
 		extern HashKey g_noPawns;												// No pawns key
+
+		// Material key of the cnt-th piece of a kind, counts index the piece-square keys from the
+		// second rank on since black pawn keys on the first rank are zero
+		inline HashKey materialKey(const Piece piece, const int cnt) { return g_pieceSq[piece][cnt + 8]; }
 	}
 
+	// FEN string of the standard starting position
+	constexpr auto START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
 	struct StateInfo {
 		// Hash keys for various aspects of the position
 		HashKey positionKey;    // Full position hash
@@ -35,14 +48,21 @@ namespace chess {
 		Square epSquare;             // En passant target square
 		int halfmoveClock;           // Halfmove clock for 50-move rule
 		int fullmoveNumber;          // Fullmove counter
+		int pliesFromNull;           // Plies since the last null move (or since the position was set)
 
 		// Previous move information
 		Piece capturedPiece;         // Piece captured in the last move
 		int repetition;              // Position repetition counter
 
+		// Pieces changed by the move that led here
+		nnue::DirtyPiece dirtyPiece;
+
 		// Linked list pointers
 		StateInfo* previous;
 
+		// Network accumulator, must stay the last member: doMove copies the state only up to it
+		nnue::Accumulator accumulator;
+
 		// Constructor declaration
 		StateInfo() noexcept;
 	};
@@ -52,18 +72,104 @@ namespace chess {
 	public:
 
 		Position() = default;
+
+		// Copies share the state list behind the current state with the source, which must outlive the copy
+		Position(const Position& other) noexcept { *this = other; }
+		Position& operator=(const Position& other) noexcept;
+
 		static void init();
 		void clear() noexcept;
 
+		// FEN string input/output
+		Position& set(const std::string& fen);
+		[[nodiscard]] std::string fen() const;
+
+		// Board access
+		[[nodiscard]] Piece pieceOn(const Square square) const { assert(isSquare(square)); return m_board[square]; }
+		[[nodiscard]] bool empty(const Square square) const { return pieceOn(square) == NO_PIECE; }
+		[[nodiscard]] Piece movedPiece(const Move m) const { return pieceOn(m.fromSq()); }
+		[[nodiscard]] Bitboard pieces() const { return m_pieceBB[ALL_PIECES]; }
+		[[nodiscard]] Bitboard pieces(const PieceType pt) const { return m_pieceBB[pt]; }
+		[[nodiscard]] Bitboard pieces(const PieceType pt1, const PieceType pt2) const { return m_pieceBB[pt1] | m_pieceBB[pt2]; }
+		[[nodiscard]] Bitboard pieces(const Color c) const { return m_colorBB[c]; }
+		[[nodiscard]] Bitboard pieces(const Color c, const PieceType pt) const { return m_colorBB[c] & m_pieceBB[pt]; }
+		[[nodiscard]] Bitboard pieces(const Color c, const PieceType pt1, const PieceType pt2) const { return m_colorBB[c] & pieces(pt1, pt2); }
+		[[nodiscard]] int count(const Piece piece) const { return m_pieceCount[piece]; }
+		[[nodiscard]] int count(const Color c, const PieceType pt) const { return m_pieceCount[makePiece(c, pt)]; }
+		[[nodiscard]] Square kingSquare(const Color c) const { return lsb(pieces(c, KING)); }
+
+		// Game state access
+		[[nodiscard]] Color sideToMove() const { return m_state->activeColor; }
+		[[nodiscard]] Square epSquare() const { return m_state->epSquare; }
+		[[nodiscard]] CastlingRights castlingRights() const { return m_state->castlingRights; }
+		[[nodiscard]] bool canCastle(const CastlingRights cr) const { return m_state->castlingRights & cr; }
+		[[nodiscard]] bool castlingImpeded(const CastlingRights cr) const { return pieces() & m_castlingPath[cr]; }
+		[[nodiscard]] Square castlingRookSquare(const CastlingRights cr) const { return m_castlingRookSquare[cr]; }
+		[[nodiscard]] HashKey key() const { return m_state->positionKey; }
+		[[nodiscard]] HashKey keyAfter(Move m) const;
+		[[nodiscard]] HashKey materialKey() const { return m_state->materialKey; }
+		[[nodiscard]] HashKey pawnKey() const { return m_state->pawnKey; }
+		[[nodiscard]] Value nonPawnMaterial(const Color c) const { return m_state->nonPawnMaterial[c]; }
+		[[nodiscard]] Bitboard checkers() const { return m_state->checkersBB; }
+		[[nodiscard]] Bitboard blockersForKing(const Color c) const { return m_state->blockersForKing[c]; }
+		[[nodiscard]] Bitboard pinners(const Color c) const { return m_state->pinners[c]; }
+		[[nodiscard]] Piece capturedPiece() const { return m_state->capturedPiece; }
+		[[nodiscard]] int rule50Count() const { return m_state->halfmoveClock; }
+		[[nodiscard]] int gamePly() const { return m_gamePly; }
+		[[nodiscard]] StateInfo* state() const { return m_state; }
+
+		// Piece-square score of the board from white's point of view and the game phase, both
+		// kept up to date by putPiece, removePiece and movePiece
+		[[nodiscard]] Score psqScore() const { return m_psq; }
+		[[nodiscard]] int gamePhase() const { return std::min(m_phase, psqt::PHASE_TOTAL) * PHASE_MIDGAME / psqt::PHASE_TOTAL; }
+
+		// Debug check of the running piece-square score and phase against a recomputation from scratch
+		[[nodiscard]] bool psqConsistent() const;
+
+		// Draw by the 50-move rule or by repetition (a single repetition inside the search tree counts)
+		[[nodiscard]] bool isDraw(int ply) const;
+
+		// Attacks to a square by pieces of both colors
+		[[nodiscard]] Bitboard attackersTo(Square square, Bitboard occupied) const;
+		[[nodiscard]] Bitboard attackersTo(const Square square) const { return attackersTo(square, pieces()); }
+
+		// Move properties
+		[[nodiscard]] bool legal(Move m) const;
+		[[nodiscard]] bool pseudoLegal(Move m) const;
+		[[nodiscard]] bool capture(const Move m) const {
+			return (!empty(m.toSq()) && m.moveType() != CASTLING) || m.moveType() == EN_PASSANT;
+		}
+		[[nodiscard]] bool captureOrPromotion(const Move m) const { return capture(m) || m.moveType() == PROMOTION; }
+
+		// Static exchange evaluation: does the move win at least threshold material on its square
+		[[nodiscard]] bool seeGe(Move m, Value threshold) const;
+
+		// Making and unmaking moves, newState must outlive the move
+		void doMove(Move m, StateInfo& newState);
+		void undoMove(Move m);
+		void doNullMove(StateInfo& newState);
+		void undoNullMove();
+
 		void putPiece(Piece piece, Square square);
 		void removePiece(Square square);
 		void movePiece(Square from, Square to);
 	private:
+		// Helpers for setting up state
+		void setState();
+		void setCheckInfo();
+		void setCastlingRight(Color c, Square rookFrom);
+		Bitboard sliderBlockers(Bitboard sliders, Square square, Bitboard& pinners) const;
+		template<bool Do>
+		void doCastling(Color us, Square from, Square to, Square& rookFrom, Square& rookTo);
+		void copyState(StateInfo& newState);
+
 		// Board representation using bitboards
 		std::array <Piece, SQUARE_NB> m_board{};			// Whole board
 		std::array <Bitboard, PIECE_TYPE_NB> m_pieceBB{};	// Pieces by type
 		std::array <Bitboard, COLOR_NB> m_colorBB{};		// Pieces by color
 		std::array<int, PIECE_NB> m_pieceCount{};           // Number of each piece
+		Score m_psq = SCORE_ZERO;                           // Sum of the piece-square table over the board
+		int m_phase = 0;                                    // Sum of the phase weights of the pieces
 
 		// Castling arrays
 		std::array<int, SQUARE_NB> m_castlingRightsMask{};
@@ -73,6 +179,7 @@ namespace chess {
 		// Game state
 		StateInfo* m_state;
 		StateInfo m_startState;
+		int m_gamePly = 0;
 
 	};
-}
\ No newline at end of file
+}
@@ -3,6 +3,7 @@
 #include <set>
 
 #include "BitBoard.h"
+#include "MoveGen.h"
 #include "Position.h"
 #include "Types.h"
 
@@ -110,6 +111,104 @@ namespace chess::tests
 		report("Key uniqueness test", success);
 	}
 
+	// Test that FEN strings survive a set/fen round trip
+	void testFenRoundTrip() {
+		bool success = true;
+		for (const std::string& fen : { std::string(START_FEN),
+			std::string("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+			std::string("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"),
+			std::string("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 b - - 12 40") }) {
+			Position pos;
+			pos.set(fen);
+			if (pos.fen() != fen) {
+				std::cout << "FEN mismatch: " << pos.fen() << " != " << fen << "\n";
+				success = false;
+			}
+		}
+		report("FEN round trip", success);
+	}
+
+	// Test that incrementally updated keys match keys computed from scratch and undo restores them
+	void testIncrementalKeys() {
+		Position pos;
+		pos.set("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+		const HashKey rootKey = pos.key();
+		const std::string rootFen = pos.fen();
+
+		bool success = true;
+		MoveList moves;
+		generate<LEGAL>(pos, moves);
+		for (const ScoredMove& sm : moves) {
+			StateInfo st;
+			pos.doMove(sm.move(), st);
+			Position fresh;
+			fresh.set(pos.fen());
+			success &= fresh.key() == pos.key() && fresh.pawnKey() == pos.pawnKey()
+				&& fresh.materialKey() == pos.materialKey()
+				&& fresh.nonPawnMaterial(WHITE) == pos.nonPawnMaterial(WHITE)
+				&& fresh.nonPawnMaterial(BLACK) == pos.nonPawnMaterial(BLACK);
+			pos.undoMove(sm.move());
+		}
+		success &= pos.key() == rootKey && pos.fen() == rootFen;
+		report("Incremental keys match recomputed keys", success);
+	}
+
+	// Test that the incrementally updated piece-square score and phase match a recomputation
+	// through captures, promotions, castling and en passant, and that undo restores them
+	void testIncrementalPsq() {
+		Position pos;
+		pos.set(START_FEN);
+		bool success = pos.psqScore() == SCORE_ZERO && pos.gamePhase() == PHASE_MIDGAME;
+
+		pos.set("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+		const Score rootPsq = pos.psqScore();
+		MoveList moves;
+		generate<LEGAL>(pos, moves);
+		for (const ScoredMove& sm : moves) {
+			StateInfo st;
+			pos.doMove(sm.move(), st);
+			success &= pos.psqConsistent();
+			MoveList replies;
+			generate<LEGAL>(pos, replies);
+			for (const ScoredMove& reply : replies) {
+				StateInfo st2;
+				pos.doMove(reply.move(), st2);
+				success &= pos.psqConsistent();
+				pos.undoMove(reply.move());
+			}
+			pos.undoMove(sm.move());
+			success &= pos.psqConsistent();
+		}
+		success &= pos.psqScore() == rootPsq;
+		report("Incremental piece-square score and phase", success);
+	}
+
+	// Test repetition detection through the state list
+	void testRepetition() {
+		Position pos;
+		pos.set(START_FEN);
+		const Move cycle[] = { Move(G1, F3), Move(G8, F6), Move(F3, G1), Move(F6, G8) };
+		std::array<StateInfo, 8> states;
+		for (int i = 0; i < 8; ++i)
+			pos.doMove(cycle[i % 4], states[i]);
+		report("Repetition detection", pos.state()->repetition == -4 && states[3].repetition == 4);
+	}
+
+	// Test that a null move only flips the side to move and clears en passant
+	void testNullMove() {
+		Position pos;
+		pos.set("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
+		const HashKey key = pos.key();
+		StateInfo st;
+		pos.doNullMove(st);
+		Position expected;
+		expected.set("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR b KQkq - 1 3");
+		bool success = pos.key() == expected.key() && pos.sideToMove() == BLACK && !pos.checkers();
+		pos.undoNullMove();
+		success &= pos.key() == key && pos.sideToMove() == WHITE && pos.epSquare() == F6;
+		report("Null move", success);
+	}
+
 	// Run all Position tests
 	void runAllPositionTests() {
 		std::cout << "Running Position tests...\n" << "\n";
@@ -119,6 +218,11 @@ namespace chess::tests
 		testCastlingKeys();
 		testMiscKeys();
 		testKeyUniqueness();
+		testFenRoundTrip();
+		testIncrementalKeys();
+		testIncrementalPsq();
+		testRepetition();
+		testNullMove();
 
 		std::cout << "\nPosition tests completed." << "\n";
 	}
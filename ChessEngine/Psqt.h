@@ -0,0 +1,18 @@
+#pragma once
+#include <array>
+#include "Types.h"
+
+// Psqt.h - Tapered piece-square tables including the piece values
+
+namespace chess::psqt {
+
+	// Piece value plus square bonus for every piece and square, the black entries are the white ones
+	// mirrored and negated so the sum over the board is from white's point of view
+	extern std::array<std::array<Score, SQUARE_NB>, PIECE_NB> g_psq;
+
+	// Game phase weight of each piece type, the pieces of the start position add up to PHASE_TOTAL
+	constexpr std::array<int, PIECE_TYPE_NB> PHASE_WEIGHTS = { 0, 0, 1, 1, 2, 4, 0, 0 };
+	constexpr int PHASE_TOTAL = 24;
+
+	void init();
+}
@@ -0,0 +1,708 @@
+#include "Search.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#include "Evaluate.h"
+#include "MoveGen.h"
+#include "Tablebases.h"
+#include "ThreadPool.h"
+#include "Uci.h"
+
+// Search.cpp - Principal variation search with iterative deepening
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// Per-ply tables are indexed with ply < MAX_GAME_LENGTH, which
+// the search checks before going deeper
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+#pragma warning(disable: 26482)
+
+namespace chess::search {
+
+	namespace {
+		// Initial half-width of the aspiration window around the previous score
+		constexpr Value ASPIRATION_DELTA = 24;
+
+		// Helper threads skip iterations in blocks of SKIP_SIZE depths, shifted by SKIP_PHASE, so that
+		// threads spread over different depths instead of searching the same tree in lockstep
+		constexpr int SKIP_PATTERNS = 20;
+		constexpr std::array<int, SKIP_PATTERNS> SKIP_SIZE = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+		constexpr std::array<int, SKIP_PATTERNS> SKIP_PHASE = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+		// Depth of quiescence search results in the transposition table
+		constexpr int DEPTH_QS = 0;
+
+		// Safety margin of delta pruning on top of the captured piece's value
+		constexpr Value DELTA_MARGIN = PawnValue;
+
+		// History bonus of a quiet move that caused a cutoff and malus of the quiets tried before it
+		int historyBonus(const int depth) { return std::min(24 * depth * depth + 32 * depth, 2400); }
+
+		// Quiet moves remembered per node for the history malus
+		constexpr int MAX_QUIETS_SEARCHED = 64;
+
+		// Mate scores are stored relative to the node instead of the root
+		Value valueToTT(const Value v, const int ply) {
+			assert(v != VALUE_NONE);
+			return v >= VALUE_MATE_IN_MAX_PLY ? v + ply : v <= VALUE_MATED_IN_MAX_PLY ? v - ply : v;
+		}
+
+		Value valueFromTT(const Value v, const int ply) {
+			if (v == VALUE_NONE)
+				return VALUE_NONE;
+			return v >= VALUE_MATE_IN_MAX_PLY ? v - ply : v <= VALUE_MATED_IN_MAX_PLY ? v + ply : v;
+		}
+	}
+
+	void Searcher::setParams(const Params& params) {
+		m_params = params;
+		for (int d = 1; d < LMR_TABLE_SIZE; ++d)
+			for (int m = 1; m < LMR_TABLE_SIZE; ++m) {
+				const double r = params.lmrBase + std::log(d) * std::log(m) / params.lmrDivisor;
+				m_reductions[d][m] = static_cast<int8_t>(std::clamp(r, 0.0, 63.0));
+			}
+	}
+
+	void Searcher::clearHistory() noexcept {
+		m_previousMoveScore = VALUE_NONE;
+		m_killers = {};
+		m_history = {};
+		m_counterMoves = {};
+		m_continuationHistory = {};
+	}
+
+	Result Searcher::think(const Position& pos, const Limits& limits) {
+		m_pos = pos;
+		m_limits = limits;
+		m_startTime = std::chrono::steady_clock::now();
+		m_timeManager.init(limits, pos.sideToMove(), pos.gamePly());
+		m_bestMoveChanges = 0.0;
+		m_iterationScores.fill(VALUE_NONE);
+		m_nodes.store(0, std::memory_order_relaxed);
+		m_qnodes.store(0, std::memory_order_relaxed);
+		m_tbHits.store(0, std::memory_order_relaxed);
+		m_selDepth = 0;
+		m_nmpMinPly = 0;
+		m_killers = {};
+		m_continuationStack[0] = m_continuationStack[1] = &m_continuationHistory[NO_PIECE][0];
+		SEARCH_STAT(m_stats.clear());
+
+		// A thread pool resets the stop flags and ages the shared table for all its threads before starting them
+		if (!m_pool) {
+			m_stop.store(false, std::memory_order_relaxed);
+			m_tt.newSearch();
+		}
+
+		// Root moves, searched in the order of the previous iteration
+		m_rootMoves.clear();
+		MoveList legalMoves;
+		generate<LEGAL>(m_pos, legalMoves);
+		for (const ScoredMove& sm : legalMoves)
+			m_rootMoves.emplace_back(sm.move());
+
+		Result result;
+		if (m_rootMoves.empty()) {
+			result.score = m_pos.checkers() ? matedIn(0) : VALUE_DRAW;
+			return result;
+		}
+		filterTablebaseRootMoves();
+
+		// Lines searched in turn every iteration, each without the moves of the lines before it
+		const size_t multiPV = std::min(static_cast<size_t>(std::max(limits.multiPV, 1)), m_rootMoves.size());
+		const int maxDepth = limits.depth > 0 ? std::min(limits.depth, MAX_GAME_LENGTH - 1) : MAX_GAME_LENGTH - 1;
+		Value previousScore = VALUE_ZERO;
+		int iterations = 0;
+
+		SEARCH_STAT(int64_t iterationStart = 0);
+		for (int depth = 1; depth <= maxDepth && !m_stop.load(std::memory_order_relaxed); ++depth) {
+			if (m_threadId > 0) {
+				const int i = (m_threadId - 1) % SKIP_PATTERNS;
+				if (((depth + m_pos.gamePly() + SKIP_PHASE[i]) / SKIP_SIZE[i]) % 2)
+					continue;
+			}
+
+			for (RootMove& rm : m_rootMoves) {
+				rm.previousScore = rm.score;
+				rm.score = -VALUE_INFINITE;
+			}
+
+			Value alpha = -VALUE_INFINITE;
+			Value beta = VALUE_INFINITE;
+			for (m_pvIdx = 0; m_pvIdx < multiPV && !m_stop.load(std::memory_order_relaxed); ++m_pvIdx) {
+				m_selDepth = 0;
+
+				// Aspiration window around the last score of the line, widened on every fail
+				const Value lineScore = m_pvIdx == 0 ? previousScore : m_rootMoves[m_pvIdx].previousScore;
+				Value delta = ASPIRATION_DELTA + std::abs(lineScore) / 64;
+				alpha = -VALUE_INFINITE;
+				beta = VALUE_INFINITE;
+				if (depth >= 4 && lineScore != -VALUE_INFINITE) {
+					alpha = std::max(lineScore - delta, -VALUE_INFINITE);
+					beta = std::min(lineScore + delta, VALUE_INFINITE);
+				}
+
+				while (true) {
+					const Value value = search<ROOT>(alpha, beta, depth, 0);
+					std::stable_sort(m_rootMoves.begin() + static_cast<std::ptrdiff_t>(m_pvIdx), m_rootMoves.end());
+					if (m_stop.load(std::memory_order_relaxed))
+						break;
+
+					if (value <= alpha) {
+						beta = (alpha + beta) / 2;
+						alpha = std::max(value - delta, -VALUE_INFINITE);
+					}
+					else if (value >= beta)
+						beta = std::min(value + delta, VALUE_INFINITE);
+					else
+						break;
+					delta += delta / 2;
+				}
+
+				// A later line may end up better than an earlier one searched with another window
+				std::stable_sort(m_rootMoves.begin(), m_rootMoves.begin() + static_cast<std::ptrdiff_t>(m_pvIdx) + 1);
+			}
+
+			// An interrupted iteration only counts if its first move was searched completely
+			if (!m_stop.load(std::memory_order_relaxed) || m_rootMoves[0].score != -VALUE_INFINITE) {
+				result.depth = m_stop.load(std::memory_order_relaxed) ? result.depth : depth;
+				SEARCH_STAT(m_stats.iterations.push_back({ depth, nodes(), elapsed(), elapsed() - iterationStart }));
+				SEARCH_STAT(iterationStart = elapsed());
+				previousScore = m_rootMoves[0].score;
+				if (!m_silent)
+					reportIteration(depth, multiPV, alpha, beta);
+				if (m_iterationCallback)
+					m_iterationCallback({ depth, m_rootMoves[0].pv[0], previousScore, totalNodes(), elapsed() });
+				if (!m_stop.load(std::memory_order_relaxed))
+					checkIterationTime(iterations++, previousScore);
+			}
+		}
+
+		const RootMove& best = m_rootMoves[0];
+		result.bestMove = best.pv[0];
+		result.ponderMove = best.pv.size() > 1 ? best.pv[1] : Move::none();
+		result.score = best.score != -VALUE_INFINITE ? best.score : best.previousScore;
+		result.nodes = nodes();
+		result.qnodes = qnodes();
+		result.tbHits = tbHits();
+		m_previousMoveScore = result.score;
+		return result;
+	}
+
+	// Keeps the root moves that preserve the tablebase result. DTZ tables also tell the way to make
+	// progress, so the search stops probing; with WDL tables only it probes to find the win
+	void Searcher::filterTablebaseRootMoves() {
+		m_tbCardinality = std::min(m_params.tbProbeLimit, tablebases::maxCardinality());
+		if (popCount(m_pos.pieces()) > m_tbCardinality || m_pos.canCastle(ANY_CASTLING))
+			return;
+
+		std::vector<Move> moves;
+		for (const RootMove& rm : m_rootMoves)
+			moves.push_back(rm.pv[0]);
+		const bool dtz = tablebases::filterRootMoves(m_pos, moves);
+		if (!dtz && !tablebases::filterRootMovesWdl(m_pos, moves))
+			return;
+
+		countTbHits(m_rootMoves.size());
+		m_rootMoves.clear();
+		for (const Move m : moves)
+			m_rootMoves.emplace_back(m);
+		if (dtz)
+			m_tbCardinality = 0;
+	}
+
+	template<Searcher::NodeType NT>
+	Value Searcher::search(Value alpha, Value beta, const int depth, const int ply) {
+		constexpr bool rootNode = NT == ROOT;
+		constexpr bool pvNode = NT != NON_PV;
+		assert(-VALUE_INFINITE <= alpha && alpha < beta && beta <= VALUE_INFINITE);
+		assert(pvNode || alpha == beta - 1);
+
+		// Horizon: resolve captures before trusting the static evaluation
+		if (depth <= 0)
+			return qsearch<pvNode ? PV : NON_PV>(alpha, beta, ply);
+
+		m_pvLength[ply] = ply;
+		SEARCH_STAT(++m_stats.nodesPerPly[ply]);
+
+		if (pvNode)
+			m_selDepth = std::max(m_selDepth, ply + 1);
+
+		if constexpr (!rootNode) {
+			if (m_stop.load(std::memory_order_relaxed) || m_pos.isDraw(ply))
+				return VALUE_DRAW;
+			if (ply >= MAX_GAME_LENGTH - 1)
+				return m_pos.checkers() ? VALUE_DRAW : eval::evaluate(m_pos, m_evalCaches);
+
+			// Mate distance pruning: even mating right now cannot beat a shorter mate found elsewhere
+			alpha = std::max(matedIn(ply), alpha);
+			beta = std::min(mateIn(ply + 1), beta);
+			if (alpha >= beta)
+				return alpha;
+		}
+
+		// Transposition table lookup, non-PV nodes return early on a sufficient bound
+		TTData tt;
+		const HashKey posKey = m_pos.key();
+		const bool ttHit = m_tt.probe(posKey, tt);
+		const Value ttValue = ttHit ? valueFromTT(tt.value, ply) : VALUE_NONE;
+		SEARCH_STAT(++m_stats.ttProbes);
+		SEARCH_STAT(m_stats.ttHits += ttHit);
+		const Move ttMove = rootNode ? m_rootMoves[m_pvIdx].pv[0] : ttHit ? tt.move : Move::none();
+
+		if (!pvNode && ttHit && tt.depth >= depth && ttValue != VALUE_NONE
+			&& (tt.bound & (ttValue >= beta ? BOUND_LOWER : BOUND_UPPER))) {
+			SEARCH_STAT(++m_stats.ttCuts);
+			return ttValue;
+		}
+
+		// Tablebase probe right after a capture or pawn move, when the position is new to the tables.
+		// Wins and losses are scored just below mates and cut off when they are good enough, otherwise
+		// they bound the searched value of PV nodes. Cursed wins and blessed losses are draws under the
+		// 50-move rule and scored as such, a little off zero
+		Value tbLower = -VALUE_INFINITE;
+		Value tbUpper = VALUE_INFINITE;
+		if constexpr (!rootNode) {
+			const int pieceCount = popCount(m_pos.pieces());
+			if (pieceCount <= m_tbCardinality && (pieceCount < m_tbCardinality || depth >= m_params.tbProbeDepth)
+				&& m_pos.rule50Count() == 0 && !m_pos.canCastle(ANY_CASTLING)) {
+				tablebases::ProbeState state;
+				const tablebases::WDLScore wdl = tablebases::probeWdl(m_pos, state);
+				if (state != tablebases::PROBE_FAIL) {
+					countTbHits(1);
+					const Value value = wdl < tablebases::WDL_BLESSED_LOSS ? -VALUE_MATE_IN_MAX_PLY + ply + 1
+						: wdl > tablebases::WDL_CURSED_WIN ? VALUE_MATE_IN_MAX_PLY - ply - 1
+						: VALUE_DRAW + 2 * wdl;
+					const Bound bound = wdl < tablebases::WDL_BLESSED_LOSS ? BOUND_UPPER
+						: wdl > tablebases::WDL_CURSED_WIN ? BOUND_LOWER : BOUND_EXACT;
+					if (bound == BOUND_EXACT || (bound == BOUND_LOWER ? value >= beta : value <= alpha)) {
+						m_tt.store(posKey, valueToTT(value, ply), bound, std::min(MAX_GAME_LENGTH - 1, depth + 6),
+							Move::none(), VALUE_NONE);
+						return value;
+					}
+					if (pvNode)
+						(bound == BOUND_LOWER ? tbLower : tbUpper) = value;
+				}
+			}
+		}
+
+		const Color us = m_pos.sideToMove();
+		const bool inCheck = m_pos.checkers();
+		m_killers[ply + 2] = {};
+
+		// Static evaluation for the pruning decisions, reused from the table when possible
+		Value staticEval = VALUE_NONE;
+		if (!inCheck)
+			staticEval = ttHit && tt.eval != VALUE_NONE ? tt.eval : eval::evaluate(m_pos, m_evalCaches);
+
+		if (!pvNode && !inCheck) {
+			// Reverse futility pruning: far enough above beta the opponent will not get back in a few plies
+			if (m_params.reverseFutility && depth <= m_params.rfpMaxDepth
+				&& staticEval - m_params.rfpMargin * depth >= beta && staticEval < VALUE_MATE_IN_MAX_PLY)
+				return staticEval;
+
+			// Null move pruning: if passing still fails high, a real move very likely does as well.
+			// Without non-pawn material passing is often the best move (zugzwang), so it is not tried
+			// at all in pawn endings and verified with a normal search when material is low
+			if (m_params.nullMove && depth >= m_params.nullMoveMinDepth && ply >= m_nmpMinPly
+				&& m_currentMove[ply - 1] != Move::null() && staticEval >= beta && m_pos.nonPawnMaterial(us)) {
+				const int r = m_params.nullMoveReduction + depth / m_params.nullMoveDepthDivisor;
+				SEARCH_STAT(++m_stats.nullMoveTries);
+
+				m_currentMove[ply] = Move::null();
+				m_continuationStack[ply + 2] = &m_continuationHistory[NO_PIECE][0];
+				m_pos.doNullMove(m_states[ply]);
+				countNode();
+				Value nullValue = -search<NON_PV>(-beta, -beta + 1, depth - r, ply + 1);
+				m_pos.undoNullMove();
+
+				if (m_stop.load(std::memory_order_relaxed))
+					return VALUE_ZERO;
+
+				if (nullValue >= beta) {
+					SEARCH_STAT(++m_stats.nullMoveCutoffs);
+
+					// Unproven mates are not returned
+					if (nullValue >= VALUE_MATE_IN_MAX_PLY)
+						nullValue = beta;
+					// Inside a verification search the cutoff is trusted, a nested one would lift the
+					// outer null move ban when it resets m_nmpMinPly
+					if (m_pos.nonPawnMaterial(us) >= m_params.nullMoveVerifyMaterial || m_nmpMinPly)
+						return nullValue;
+
+					// Verification search with null moves disabled for the next plies
+					m_nmpMinPly = ply + 3 * (depth - r) / 4;
+					const Value verified = search<NON_PV>(beta - 1, beta, depth - r, ply);
+					m_nmpMinPly = 0;
+					SEARCH_STAT(++m_stats.nullMoveVerifications);
+					if (verified >= beta)
+						return nullValue;
+					SEARCH_STAT(++m_stats.nullMoveVerifyFails);
+				}
+			}
+		}
+
+		const Value oldAlpha = alpha;
+		Value bestValue = -VALUE_INFINITE;
+		Move bestMove = Move::none();
+		int moveCount = 0;
+		bool skipQuiets = false;
+		std::array<Move, MAX_QUIETS_SEARCHED> quietsSearched;
+		int quietCount = 0;
+
+		MovePicker picker(m_pos, ttMove, depth, histories(ply), m_killers[ply], &m_pickerStats);
+		const int rootMoveCount = static_cast<int>(m_rootMoves.size() - m_pvIdx);
+
+		while (true) {
+			// The root iterates its sorted root moves instead of a move picker
+			Move m;
+			if constexpr (rootNode) {
+				if (moveCount >= rootMoveCount)
+					break;
+				m = m_rootMoves[m_pvIdx + static_cast<size_t>(moveCount)].pv[0];
+			}
+			else {
+				m = picker.nextMove(skipQuiets);
+				if (!m)
+					break;
+				if (!m_pos.legal(m))
+					continue;
+			}
+
+			const bool quiet = !m_pos.captureOrPromotion(m);
+			if (skipQuiets && quiet)
+				continue;
+			++moveCount;
+
+			// Late move pruning: at low depth, quiet moves this late in the ordering rarely matter
+			if (!rootNode && !inCheck && m_params.lateMovePruning && depth <= m_params.lmpMaxDepth
+				&& bestValue > VALUE_MATED_IN_MAX_PLY && moveCount >= m_params.lmpBase + depth * depth)
+				skipQuiets = true;
+
+			// Start loading the child's bucket while the move is made
+			m_tt.prefetch(m_pos.keyAfter(m));
+			m_currentMove[ply] = m;
+			m_continuationStack[ply + 2] = &m_continuationHistory[m_pos.movedPiece(m)][m.toSq()];
+			const uint64_t nodesBefore = rootNode ? nodes() : 0;
+			m_pos.doMove(m, m_states[ply]);
+			countNode();
+
+			// Principal variation search: full window for the first move, null window for the rest.
+			// Late quiet moves are first searched with reduced depth
+			const int newDepth = depth - 1;
+			Value value;
+			if (moveCount == 1)
+				value = -search<pvNode ? PV : NON_PV>(-beta, -alpha, newDepth, ply + 1);
+			else {
+				bool fullDepth = true;
+				if (m_params.lateMoveReductions && depth >= m_params.lmrMinDepth && moveCount > 1 + pvNode
+					&& quiet && !inCheck && !m_pos.checkers()) {
+					int r = m_reductions[std::min(depth, LMR_TABLE_SIZE - 1)][std::min(moveCount, LMR_TABLE_SIZE - 1)];
+					r -= pvNode;
+					r -= m == m_killers[ply][0] || m == m_killers[ply][1];
+					const int reducedDepth = std::clamp(newDepth - r, 1, newDepth);
+					value = -search<NON_PV>(-alpha - 1, -alpha, reducedDepth, ply + 1);
+					fullDepth = value > alpha && reducedDepth < newDepth;
+					SEARCH_STAT(++m_stats.lmrSearches);
+					SEARCH_STAT(m_stats.lmrResearches += fullDepth);
+				}
+				if (fullDepth)
+					value = -search<NON_PV>(-alpha - 1, -alpha, newDepth, ply + 1);
+				if (pvNode && value > alpha && value < beta) {
+					SEARCH_STAT(++m_stats.pvsResearches);
+					value = -search<PV>(-beta, -alpha, newDepth, ply + 1);
+				}
+			}
+
+			m_pos.undoMove(m);
+
+			if (m_stop.load(std::memory_order_relaxed))
+				return VALUE_ZERO;
+
+			if constexpr (rootNode) {
+				RootMove& rm = m_rootMoves[m_pvIdx + static_cast<size_t>(moveCount - 1)];
+				rm.nodes += nodes() - nodesBefore;
+				if (moveCount > 1 && value > alpha && m_pvIdx == 0)
+					m_bestMoveChanges += 1.0;
+				if (moveCount == 1 || value > alpha) {
+					rm.score = value;
+					rm.selDepth = m_selDepth;
+					rm.pv.assign(1, m);
+					for (int i = ply + 1; i < m_pvLength[ply + 1]; ++i)
+						rm.pv.push_back(m_pvTable[ply + 1][i]);
+				}
+				else
+					// Only an upper bound is known for the other moves
+					rm.score = -VALUE_INFINITE;
+			}
+
+			if (value > bestValue) {
+				bestValue = value;
+				if (value > alpha) {
+					bestMove = m;
+					if (pvNode)
+						updatePv(ply, m);
+					if (value >= beta) {
+						SEARCH_STAT(++m_stats.betaCutoffs);
+						SEARCH_STAT(m_stats.firstMoveCutoffs += moveCount == 1);
+						if (quiet)
+							updateQuietStats(ply, m, depth, quietsSearched.data(), quietCount);
+						break;
+					}
+					alpha = value;
+				}
+			}
+
+			if (quiet && quietCount < MAX_QUIETS_SEARCHED)
+				quietsSearched[quietCount++] = m;
+		}
+
+		// No legal moves: checkmate or stalemate
+		if (!moveCount)
+			bestValue = m_pos.checkers() ? matedIn(ply) : VALUE_DRAW;
+		if (pvNode)
+			bestValue = std::clamp(bestValue, tbLower, tbUpper);
+
+		// The root of a later MultiPV line leaves out the best moves, its value is not the position's
+		if (!rootNode || m_pvIdx == 0) {
+			const Bound bound = bestValue >= beta ? BOUND_LOWER : pvNode && bestValue > oldAlpha ? BOUND_EXACT : BOUND_UPPER;
+			m_tt.store(posKey, valueToTT(bestValue, ply), bound, depth, bestMove, staticEval);
+		}
+		return bestValue;
+	}
+
+	// Quiescence search: only captures and queen promotions, or all evasions when in check,
+	// until the position is quiet enough for the static evaluation
+	template<Searcher::NodeType NT>
+	Value Searcher::qsearch(Value alpha, const Value beta, const int ply) {
+		constexpr bool pvNode = NT == PV;
+		assert(-VALUE_INFINITE <= alpha && alpha < beta && beta <= VALUE_INFINITE);
+		assert(pvNode || alpha == beta - 1);
+
+		m_pvLength[ply] = ply;
+		SEARCH_STAT(++m_stats.qnodesPerPly[ply]);
+		if (pvNode)
+			m_selDepth = std::max(m_selDepth, ply + 1);
+
+		const bool inCheck = m_pos.checkers();
+		if (m_stop.load(std::memory_order_relaxed) || m_pos.isDraw(ply))
+			return VALUE_DRAW;
+		if (ply >= MAX_GAME_LENGTH - 1)
+			return inCheck ? VALUE_DRAW : eval::evaluate(m_pos, m_evalCaches);
+
+		TTData tt;
+		const HashKey posKey = m_pos.key();
+		const bool ttHit = m_tt.probe(posKey, tt);
+		const Value ttValue = ttHit ? valueFromTT(tt.value, ply) : VALUE_NONE;
+
+		if (!pvNode && ttHit && tt.depth >= DEPTH_QS && ttValue != VALUE_NONE
+			&& (tt.bound & (ttValue >= beta ? BOUND_LOWER : BOUND_UPPER)))
+			return ttValue;
+
+		// Stand pat: the side to move can usually do at least as well as the static evaluation,
+		// except in check where every evasion has to be searched
+		Value standPat = VALUE_NONE;
+		Value bestValue = -VALUE_INFINITE;
+		if (!inCheck) {
+			standPat = ttHit && tt.eval != VALUE_NONE ? tt.eval : eval::evaluate(m_pos, m_evalCaches);
+			bestValue = standPat;
+
+			// A TT bound in the right direction is a better estimate
+			if (ttValue != VALUE_NONE && (tt.bound & (ttValue > bestValue ? BOUND_LOWER : BOUND_UPPER)))
+				bestValue = ttValue;
+
+			if (bestValue >= beta) {
+				if (!ttHit)
+					m_tt.store(posKey, valueToTT(bestValue, ply), BOUND_LOWER, DEPTH_QS, Move::none(), standPat);
+				return bestValue;
+			}
+			alpha = std::max(alpha, bestValue);
+		}
+
+		const Value oldAlpha = alpha;
+		Move bestMove = Move::none();
+		MovePicker picker(m_pos, ttHit ? tt.move : Move::none(), &m_history, &m_pickerStats);
+
+		while (const Move m = picker.nextMove()) {
+			if (!m_pos.legal(m))
+				continue;
+
+			if (!inCheck) {
+				// Delta pruning: even winning the captured piece for free cannot raise alpha
+				if (m.moveType() != PROMOTION) {
+					const Value captured = m.moveType() == EN_PASSANT ? PawnValue : PieceValues[typeOf(m_pos.pieceOn(m.toSq()))];
+					const Value futilityValue = standPat + captured + DELTA_MARGIN;
+					if (futilityValue <= alpha) {
+						bestValue = std::max(bestValue, futilityValue);
+						continue;
+					}
+				}
+
+				// Losing captures
+				if (!m_pos.seeGe(m, VALUE_ZERO))
+					continue;
+			}
+
+			m_tt.prefetch(m_pos.keyAfter(m));
+			m_pos.doMove(m, m_states[ply]);
+			countNode();
+			m_qnodes.store(m_qnodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			const Value value = -qsearch<NT>(-beta, -alpha, ply + 1);
+			m_pos.undoMove(m);
+
+			if (m_stop.load(std::memory_order_relaxed))
+				return VALUE_ZERO;
+
+			if (value > bestValue) {
+				bestValue = value;
+				if (value > alpha) {
+					bestMove = m;
+					if (pvNode)
+						updatePv(ply, m);
+					if (value >= beta)
+						break;
+					alpha = value;
+				}
+			}
+		}
+
+		// All evasions were searched, none was legal
+		if (inCheck && bestValue == -VALUE_INFINITE)
+			return matedIn(ply);
+
+		const Bound bound = bestValue >= beta ? BOUND_LOWER : pvNode && bestValue > oldAlpha ? BOUND_EXACT : BOUND_UPPER;
+		m_tt.store(posKey, valueToTT(bestValue, ply), bound, DEPTH_QS, bestMove, standPat);
+		return bestValue;
+	}
+
+	// Prepends m to the child's line in the triangular PV table
+	void Searcher::updatePv(const int ply, const Move m) {
+		m_pvTable[ply][ply] = m;
+		for (int i = ply + 1; i < m_pvLength[ply + 1]; ++i)
+			m_pvTable[ply][i] = m_pvTable[ply + 1][i];
+		m_pvLength[ply] = std::max(m_pvLength[ply + 1], ply + 1);
+	}
+
+	// History tables for ordering the quiet moves at ply
+	MoveHistories Searcher::histories(const int ply) const {
+		MoveHistories h;
+		h.butterfly = &m_history;
+		h.continuation = { m_continuationStack[ply + 1], m_continuationStack[ply] };
+		if (ply > 0 && m_currentMove[ply - 1].validMove()) {
+			const Square prevSq = m_currentMove[ply - 1].toSq();
+			h.counterMove = m_counterMoves[m_pos.pieceOn(prevSq)][prevSq];
+		}
+		return h;
+	}
+
+	// A quiet move caused a cutoff: remember it as killer and counter move, raise its history
+	// and lower the history of the quiet moves searched before it
+	void Searcher::updateQuietStats(const int ply, const Move best, const int depth, const Move* quiets, const int quietCount) {
+		KillerMoves& killers = m_killers[ply];
+		if (killers[0] != best) {
+			killers[1] = killers[0];
+			killers[0] = best;
+		}
+
+		if (ply > 0 && m_currentMove[ply - 1].validMove()) {
+			const Square prevSq = m_currentMove[ply - 1].toSq();
+			m_counterMoves[m_pos.pieceOn(prevSq)][prevSq] = best;
+		}
+
+		const Color us = m_pos.sideToMove();
+		const PieceToHistory* sentinel = &m_continuationHistory[NO_PIECE][0];
+		const auto update = [&](const Move m, const int bonus) {
+			updateHistory(m_history[us][m.fromToSq()], bonus);
+			const Piece piece = m_pos.movedPiece(m);
+			for (PieceToHistory* continuation : { m_continuationStack[ply + 1], m_continuationStack[ply] })
+				if (continuation != sentinel)
+					updateHistory((*continuation)[piece][m.toSq()], bonus);
+		};
+
+		const int bonus = historyBonus(depth);
+		update(best, bonus);
+		for (int i = 0; i < quietCount; ++i)
+			update(quiets[i], -bonus);
+	}
+
+	// Any thread that reaches a limit stops the whole pool
+	void Searcher::checkLimits() {
+		const bool timed = m_timeManager.timed() && !(m_pool && m_pool->pondering());
+		if ((m_limits.nodes && totalNodes() >= m_limits.nodes) || (timed && elapsed() >= m_timeManager.maximum()))
+			stopSearch();
+	}
+
+	void Searcher::stopSearch() {
+		if (m_pool)
+			m_pool->stop();
+		else
+			stop();
+	}
+
+	// The main thread decides after each iteration whether the next one is worth starting: the optimum
+	// time grows while the best move is unstable, the score falls or other moves take much of the effort
+	void Searcher::checkIterationTime(const int iteration, const Value score) {
+		const size_t slot = static_cast<size_t>(iteration) % m_iterationScores.size();
+		const Value earlierScore = m_iterationScores[slot];
+		m_iterationScores[slot] = score;
+		if (!isMain() || !m_timeManager.fromClock() || (m_pool && m_pool->pondering()))
+			return;
+
+		const uint64_t searched = nodes();
+		const double bestMoveNodes = searched ? static_cast<double>(m_rootMoves[0].nodes) / static_cast<double>(searched) : 0.0;
+		const double factor = TimeManager::scale(m_bestMoveChanges, bestMoveNodes, m_previousMoveScore, earlierScore, score);
+		m_bestMoveChanges /= 2;
+		if (m_timeManager.stopAfterIteration(elapsed(), factor))
+			stopSearch();
+	}
+
+	uint64_t Searcher::totalNodes() const noexcept {
+		return m_pool ? m_pool->nodes() : nodes();
+	}
+
+	int64_t Searcher::elapsed() const {
+		return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_startTime).count();
+	}
+
+	// Prints the UCI "info" lines of a finished iteration without building strings, one per MultiPV line.
+	// Only the line searched last can have ended on a bound
+	void Searcher::reportIteration(const int depth, const size_t multiPV, const Value alpha, const Value beta) const {
+		const int64_t time = elapsed();
+		const uint64_t nodes = totalNodes();
+		const uint64_t nps = nodes * 1000 / static_cast<uint64_t>(std::max<int64_t>(time, 1));
+		const uint64_t hits = m_pool ? m_pool->tbHits() : tbHits();
+		const int hashfull = m_tt.hashfull();
+
+		for (size_t i = 0; i < multiPV; ++i) {
+			const RootMove& rm = m_rootMoves[i];
+			const Value score = rm.score != -VALUE_INFINITE ? rm.score : rm.previousScore;
+			if (score == -VALUE_INFINITE)
+				continue;
+			const bool searchedLast = i + 1 == m_pvIdx;
+
+			char scoreBuffer[16];
+			uci::formatScore(score, scoreBuffer);
+
+			std::ostringstream line;
+			line << "info depth " << depth << " seldepth " << rm.selDepth << " multipv " << i + 1 << " score " << scoreBuffer
+				<< (searchedLast && score >= beta ? " lowerbound" : searchedLast && score <= alpha ? " upperbound" : "")
+				<< " nodes " << nodes << " nps " << nps << " hashfull " << hashfull
+				<< " tbhits " << hits << " time " << time << " pv";
+			for (const Move m : rm.pv) {
+				char moveBuffer[Move::MAX_STRING_LENGTH];
+				m.format(moveBuffer);
+				line << ' ' << moveBuffer;
+			}
+
+			// Whole lines, so an output shared with another thread never splits one
+			if (m_output)
+				m_output(line.str());
+			else
+				std::cout << line.str() << std::endl;
+		}
+	}
+}
+#pragma warning(pop)
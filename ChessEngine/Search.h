@@ -0,0 +1,258 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Evaluate.h"
+#include "History.h"
+#include "MovePicker.h"
+#include "Position.h"
+#include "SearchStats.h"
+#include "TimeManager.h"
+#include "TranspositionTable.h"
+
+// Search.h - Principal variation search with iterative deepening
+
+namespace chess::search {
+
+	class ThreadPool;
+
+	// Limits of one search, zero means no limit
+	struct Limits {
+		int depth = 0;         // Maximum iteration depth
+		uint64_t nodes = 0;    // Maximum number of nodes
+		int64_t moveTime = 0;  // Time for this move in milliseconds
+		bool ponder = false;   // Searching on the opponent's time: a thread pool ignores the time until ponderhit
+
+		// Clock of both sides in milliseconds, used when there is no fixed move time
+		std::array<int64_t, COLOR_NB> time{};
+		std::array<int64_t, COLOR_NB> increment{};
+		int movesToGo = 0;     // Moves to the next time control, 0 for the rest of the game
+
+		int multiPV = 1;       // Best lines searched and reported, the search result is the first
+	};
+
+	// Tunable parameters of the selective search, margins are in internal units (PawnValue = 208)
+	struct Params {
+		// Null move pruning: reduction = nullMoveReduction + depth / nullMoveDepthDivisor.
+		// Pawn endings are never null move pruned, with less non-pawn material than
+		// nullMoveVerifyMaterial a fail high is verified by a reduced search without null moves
+		bool nullMove = true;
+		int nullMoveMinDepth = 3;
+		int nullMoveReduction = 3;
+		int nullMoveDepthDivisor = 4;
+		Value nullMoveVerifyMaterial = RookValue;
+
+		// Late move reductions: lmrBase + ln(depth) * ln(moveNumber) / lmrDivisor plies for late quiet moves
+		bool lateMoveReductions = true;
+		int lmrMinDepth = 3;
+		double lmrBase = 0.75;
+		double lmrDivisor = 2.25;
+
+		// Reverse futility pruning: return the static evaluation if it exceeds beta by rfpMargin per ply
+		bool reverseFutility = true;
+		int rfpMaxDepth = 7;
+		Value rfpMargin = 180;
+
+		// Late move pruning: skip the remaining quiet moves after lmpBase + depth * depth moves
+		bool lateMovePruning = true;
+		int lmpMaxDepth = 8;
+		int lmpBase = 3;
+
+		// Tablebase probes: positions of at most tbProbeLimit pieces right after a capture or pawn move,
+		// those with as many pieces as the largest tables only from tbProbeDepth on
+		int tbProbeDepth = 1;
+		int tbProbeLimit = 7;
+	};
+
+	// A legal root move with the score and principal variation of its last search
+	struct RootMove {
+		explicit RootMove(const Move m) : pv(1, m) {}
+
+		// Sorting puts the best move first, ties keep the previous iteration's order
+		bool operator<(const RootMove& other) const {
+			return score != other.score ? score > other.score : previousScore > other.previousScore;
+		}
+
+		Value score = -VALUE_INFINITE;
+		Value previousScore = -VALUE_INFINITE;
+		int selDepth = 0;
+		uint64_t nodes = 0;    // Nodes searched below the move in this search, for the time manager
+		std::vector<Move> pv;
+	};
+
+	// Outcome of a finished search
+	struct Result {
+		Move bestMove = Move::none();
+		Move ponderMove = Move::none();
+		Value score = VALUE_NONE;
+		int depth = 0;
+		uint64_t nodes = 0;
+		uint64_t qnodes = 0;   // Part of the nodes searched by the quiescence search
+		uint64_t tbHits = 0;   // Successful tablebase probes, root moves included
+	};
+
+	// A completed iteration as seen by the main thread
+	struct Iteration {
+		int depth = 0;
+		Move bestMove = Move::none();
+		Value score = VALUE_NONE;
+		uint64_t nodes = 0;    // Nodes of all threads so far
+		int64_t time = 0;      // Milliseconds since the search started
+	};
+
+	// Runs the search on its own copy of the position with per-ply state, killers, history and PV tables.
+	// The tables are large, so searchers should be allocated on the heap. Searchers of a thread pool
+	// share the transposition table and are cache-line aligned, so their hot data never shares a line
+	class alignas(64) Searcher {
+	public:
+		explicit Searcher(TranspositionTable& tt) : m_tt(tt) { setParams(Params{}); }
+		Searcher(TranspositionTable& tt, ThreadPool& pool, const int threadId)
+			: m_tt(tt), m_pool(&pool), m_threadId(threadId) { setParams(Params{}); }
+		Searcher(const Searcher&) = delete;
+		Searcher& operator=(const Searcher&) = delete;
+
+		// Iterative deepening from pos until a limit is reached or stop() is called
+		Result think(const Position& pos, const Limits& limits);
+
+		// Requests the running search to stop as soon as possible (callable from any thread)
+		void stop() noexcept { m_stop.store(true, std::memory_order_relaxed); }
+
+		// Clears the stop flag and node counts, done by a thread pool for all threads before starting any
+		void reset() noexcept {
+			m_stop.store(false, std::memory_order_relaxed);
+			m_nodes.store(0, std::memory_order_relaxed);
+			m_qnodes.store(0, std::memory_order_relaxed);
+			m_tbHits.store(0, std::memory_order_relaxed);
+		}
+
+		// Suppresses the "info" lines printed after every iteration
+		void setSilent(const bool silent) noexcept { m_silent = silent; }
+
+		// Receives the "info" lines one whole line at a time, without the newline; std::cout when empty
+		void setOutput(std::function<void(const std::string&)> output) { m_output = std::move(output); }
+
+		// Called on the searching thread after every iteration that counts, silent or not; none when empty
+		void setIterationCallback(std::function<void(const Iteration&)> callback) { m_iterationCallback = std::move(callback); }
+
+		// Caches static evaluations in cache, which may be shared with other searchers; none when null
+		void setEvalCache(EvalCache* cache) noexcept { m_evalCaches.evalCache = cache; }
+
+		// Forgets killers, history, counter moves and continuation history (e.g. for a new game)
+		void clearHistory() noexcept;
+
+		// Sets the selective search parameters, must not be called while searching
+		void setParams(const Params& params);
+		[[nodiscard]] const Params& params() const noexcept { return m_params; }
+
+		// Node count of the running or last search, safe to read from other threads
+		[[nodiscard]] uint64_t nodes() const noexcept { return m_nodes.load(std::memory_order_relaxed); }
+		[[nodiscard]] uint64_t qnodes() const noexcept { return m_qnodes.load(std::memory_order_relaxed); }
+		[[nodiscard]] uint64_t tbHits() const noexcept { return m_tbHits.load(std::memory_order_relaxed); }
+		[[nodiscard]] int threadId() const noexcept { return m_threadId; }
+		[[nodiscard]] bool isMain() const noexcept { return m_threadId == 0; }
+		[[nodiscard]] const PickerStats& pickerStats() const noexcept { return m_pickerStats; }
+		[[nodiscard]] const eval::Caches& evalCaches() const noexcept { return m_evalCaches; }
+#ifdef SEARCH_STATS
+		[[nodiscard]] const SearchStats& stats() const noexcept { return m_stats; }
+#endif
+		// Root moves of the last search, sorted best first; the first Limits::multiPV hold the lines
+		[[nodiscard]] const std::vector<RootMove>& rootMoves() const noexcept { return m_rootMoves; }
+
+	private:
+		enum NodeType { ROOT, PV, NON_PV };
+
+		template<NodeType NT>
+		Value search(Value alpha, Value beta, int depth, int ply);
+		template<NodeType NT>
+		Value qsearch(Value alpha, Value beta, int ply);
+
+		// Counts a node, checking the limits every 1024 nodes
+		void countNode() {
+			const uint64_t nodes = m_nodes.load(std::memory_order_relaxed) + 1;
+			m_nodes.store(nodes, std::memory_order_relaxed);
+			if ((nodes & 1023) == 0)
+				checkLimits();
+		}
+
+		void countTbHits(const uint64_t hits) {
+			m_tbHits.store(m_tbHits.load(std::memory_order_relaxed) + hits, std::memory_order_relaxed);
+		}
+
+		void filterTablebaseRootMoves();
+		void updatePv(int ply, Move m);
+		void updateQuietStats(int ply, Move best, int depth, const Move* quiets, int quietCount);
+		[[nodiscard]] MoveHistories histories(int ply) const;
+		void checkLimits();
+		void stopSearch();
+		void checkIterationTime(int iteration, Value score);
+		[[nodiscard]] uint64_t totalNodes() const noexcept;
+		[[nodiscard]] int64_t elapsed() const;
+		void reportIteration(int depth, size_t multiPV, Value alpha, Value beta) const;
+
+		TranspositionTable& m_tt;
+		ThreadPool* m_pool = nullptr;
+		int m_threadId = 0;
+		Position m_pos;
+		Limits m_limits;
+		Params m_params;
+		std::chrono::steady_clock::time_point m_startTime;
+		TimeManager m_timeManager;
+		std::atomic<bool> m_stop{ false };
+		bool m_silent = false;
+		std::function<void(const std::string&)> m_output;
+		std::function<void(const Iteration&)> m_iterationCallback;
+
+		// Only the owning thread writes the counter, so increments need no read-modify-write
+		std::atomic<uint64_t> m_nodes{ 0 };
+		std::atomic<uint64_t> m_qnodes{ 0 };
+		std::atomic<uint64_t> m_tbHits{ 0 };
+		int m_selDepth = 0;
+
+		// Most pieces of positions probed in the tablebases, 0 once the root was ranked by DTZ
+		int m_tbCardinality = 0;
+		std::vector<RootMove> m_rootMoves;
+		size_t m_pvIdx = 0;  // MultiPV line being searched, the root skips the moves before it
+
+		// Time manager inputs: best move changes at the root, halved every iteration, the scores of the
+		// last iterations and the score of the previous search, the last move played in the game
+		double m_bestMoveChanges = 0.0;
+		std::array<Value, 4> m_iterationScores{};
+		Value m_previousMoveScore = VALUE_NONE;
+
+		// Late move reductions by depth and move number, built from the parameters
+		static constexpr int LMR_TABLE_SIZE = 64;
+		std::array<std::array<int8_t, LMR_TABLE_SIZE>, LMR_TABLE_SIZE> m_reductions{};
+
+		// Null moves are not tried before this ply while a null move fail high is verified
+		int m_nmpMinPly = 0;
+
+		// Per-ply data, the root is ply 0
+		std::array<StateInfo, MAX_GAME_LENGTH + 1> m_states;
+		std::array<Move, MAX_GAME_LENGTH + 1> m_currentMove{};
+		std::array<KillerMoves, MAX_GAME_LENGTH + 1> m_killers{};
+
+		// Continuation tables of the moves made on the path, the table of the move at ply is at index
+		// ply + 2 so that the root can refer to the two plies before it (the sentinel table)
+		std::array<PieceToHistory*, MAX_GAME_LENGTH + 3> m_continuationStack{};
+
+		// Move ordering statistics, kept between searches
+		ButterflyHistory m_history{};
+		CounterMoveHistory m_counterMoves{};
+		ContinuationHistory m_continuationHistory{};
+		PickerStats m_pickerStats;
+
+		// Per-thread evaluation hash tables, kept between searches
+		eval::Caches m_evalCaches;
+#ifdef SEARCH_STATS
+		SearchStats m_stats;
+#endif
+
+		// Triangular PV table: row ply holds the best line found from ply, ending at m_pvLength[ply]
+		std::array<std::array<Move, MAX_GAME_LENGTH + 1>, MAX_GAME_LENGTH + 1> m_pvTable;
+		std::array<int, MAX_GAME_LENGTH + 1> m_pvLength{};
+	};
+}
@@ -0,0 +1,88 @@
+#include "SearchStats.h"
+#include <cmath>
+
+// SearchStats.cpp - Optional counters describing the shape of the search tree
+
+namespace chess::search {
+
+	namespace {
+		double rate(const uint64_t part, const uint64_t total) {
+			return total ? static_cast<double>(part) / static_cast<double>(total) : 0.0;
+		}
+
+		// Writes the counters up to the deepest non-zero ply
+		void writePlyArray(std::ostream& os, const std::array<uint64_t, MAX_GAME_LENGTH + 1>& counts) {
+			size_t end = counts.size();
+			while (end > 0 && !counts[end - 1])
+				--end;
+			os << '[';
+			for (size_t i = 0; i < end; ++i)
+				os << (i ? "," : "") << counts[i];
+			os << ']';
+		}
+	}
+
+	void SearchStats::merge(const SearchStats& other) {
+		for (size_t i = 0; i < nodesPerPly.size(); ++i) {
+			nodesPerPly[i] += other.nodesPerPly[i];
+			qnodesPerPly[i] += other.qnodesPerPly[i];
+		}
+		betaCutoffs += other.betaCutoffs;
+		firstMoveCutoffs += other.firstMoveCutoffs;
+		ttProbes += other.ttProbes;
+		ttHits += other.ttHits;
+		ttCuts += other.ttCuts;
+		nullMoveTries += other.nullMoveTries;
+		nullMoveCutoffs += other.nullMoveCutoffs;
+		nullMoveVerifications += other.nullMoveVerifications;
+		nullMoveVerifyFails += other.nullMoveVerifyFails;
+		lmrSearches += other.lmrSearches;
+		lmrResearches += other.lmrResearches;
+		pvsResearches += other.pvsResearches;
+	}
+
+	double SearchStats::effectiveBranchingFactor() const {
+		double logSum = 0.0;
+		int count = 0;
+		for (size_t i = 1; i < iterations.size(); ++i) {
+			const uint64_t previous = iterations[i - 1].nodes;
+			const uint64_t current = iterations[i].nodes - previous;
+			const uint64_t before = i > 1 ? previous - iterations[i - 2].nodes : previous;
+			if (before && current) {
+				logSum += std::log(static_cast<double>(current) / static_cast<double>(before));
+				++count;
+			}
+		}
+		return count ? std::exp(logSum / count) : 0.0;
+	}
+
+	void SearchStats::writeJson(std::ostream& os) const {
+		uint64_t nodes = 0, qnodes = 0;
+		for (size_t i = 0; i < nodesPerPly.size(); ++i) {
+			nodes += nodesPerPly[i];
+			qnodes += qnodesPerPly[i];
+		}
+
+		os << "{\"nodes\":" << nodes << ",\"qnodes\":" << qnodes << ",\"nodesPerPly\":";
+		writePlyArray(os, nodesPerPly);
+		os << ",\"qnodesPerPly\":";
+		writePlyArray(os, qnodesPerPly);
+		os << ",\"betaCutoffs\":" << betaCutoffs
+			<< ",\"firstMoveCutoffRate\":" << rate(firstMoveCutoffs, betaCutoffs)
+			<< ",\"effectiveBranchingFactor\":" << effectiveBranchingFactor()
+			<< ",\"tt\":{\"probes\":" << ttProbes << ",\"hitRate\":" << rate(ttHits, ttProbes)
+			<< ",\"cutRate\":" << rate(ttCuts, ttProbes) << '}'
+			<< ",\"nullMove\":{\"tries\":" << nullMoveTries << ",\"cutoffRate\":" << rate(nullMoveCutoffs, nullMoveTries)
+			<< ",\"verifications\":" << nullMoveVerifications
+			<< ",\"verifyFailRate\":" << rate(nullMoveVerifyFails, nullMoveVerifications) << '}'
+			<< ",\"lmr\":{\"searches\":" << lmrSearches << ",\"researchRate\":" << rate(lmrResearches, lmrSearches) << '}'
+			<< ",\"pvsResearches\":" << pvsResearches
+			<< ",\"iterations\":[";
+		for (size_t i = 0; i < iterations.size(); ++i) {
+			const IterationStats& it = iterations[i];
+			os << (i ? "," : "") << "{\"depth\":" << it.depth << ",\"nodes\":" << it.nodes
+				<< ",\"timeMs\":" << it.timeMs << ",\"durationMs\":" << it.durationMs << '}';
+		}
+		os << "]}";
+	}
+}
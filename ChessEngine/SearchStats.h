@@ -0,0 +1,63 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "Types.h"
+
+// SearchStats.h - Optional counters describing the shape of the search tree
+//
+// Build with SEARCH_STATS defined to collect them. Without it the counters are not members of the
+// searcher and every SEARCH_STAT(...) statement compiles to nothing
+
+#ifdef SEARCH_STATS
+#define SEARCH_STAT(statement) statement
+#else
+#define SEARCH_STAT(statement) ((void)0)
+#endif
+
+namespace chess::search {
+
+	// Result of one completed iteration of iterative deepening
+	struct IterationStats {
+		int depth = 0;
+		uint64_t nodes = 0;      // Nodes of this thread at the end of the iteration
+		int64_t timeMs = 0;      // Time since the search started
+		int64_t durationMs = 0;  // Time spent on this iteration
+	};
+
+	// Plain counters owned by one thread, so counting needs no atomics. Threads are merged after they finished
+	struct SearchStats {
+		std::array<uint64_t, MAX_GAME_LENGTH + 1> nodesPerPly{};
+		std::array<uint64_t, MAX_GAME_LENGTH + 1> qnodesPerPly{};
+
+		uint64_t betaCutoffs = 0;
+		uint64_t firstMoveCutoffs = 0;   // Cutoffs by the first move searched
+
+		uint64_t ttProbes = 0;
+		uint64_t ttHits = 0;
+		uint64_t ttCuts = 0;             // Nodes returning the table value without a search
+
+		uint64_t nullMoveTries = 0;
+		uint64_t nullMoveCutoffs = 0;
+		uint64_t nullMoveVerifications = 0;
+		uint64_t nullMoveVerifyFails = 0; // Verification searches that refuted the null move cutoff
+
+		uint64_t lmrSearches = 0;        // Searches with reduced depth
+		uint64_t lmrResearches = 0;      // Reduced searches that failed high and were repeated at full depth
+		uint64_t pvsResearches = 0;      // Null window searches repeated with the full window
+
+		std::vector<IterationStats> iterations;
+
+		void clear() { *this = SearchStats(); }
+
+		// Adds the counters of another thread, the iterations are kept from this thread
+		void merge(const SearchStats& other);
+
+		// Effective branching factor: geometric mean of the node growth between consecutive iterations
+		[[nodiscard]] double effectiveBranchingFactor() const;
+
+		// Writes all counters and the derived rates as one JSON object
+		void writeJson(std::ostream& os) const;
+	};
+}
@@ -0,0 +1,273 @@
+#include "SearchTests.h"
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Epd.h"
+#include "Position.h"
+#include "Search.h"
+#include "ThreadPool.h"
+#include "TranspositionTable.h"
+#include "Types.h"
+
+// SearchTests.cpp - Tests for the principal variation search
+
+namespace chess::tests
+{
+	namespace {
+		search::Result runSearch(const std::string& fen, const search::Limits& limits) {
+			Position pos;
+			pos.set(fen);
+			TranspositionTable tt;
+			tt.resize(1);
+			const auto searcher = std::make_unique<search::Searcher>(tt);
+			searcher->setSilent(true);
+			return searcher->think(pos, limits);
+		}
+	}
+
+	// Test that mates are found with the correct distance
+	void testFindsMate() {
+		search::Limits limits;
+		limits.depth = 4;
+		const search::Result mateIn1 = runSearch("k7/8/1K6/8/8/8/8/7R w - - 0 1", limits);
+		bool success = mateIn1.bestMove == Move(H1, H8) && mateIn1.score == mateIn(1);
+
+		limits.depth = 5;
+		const search::Result mateIn2 = runSearch("k7/8/2K5/8/8/8/8/7R w - - 0 1", limits);
+		success &= mateIn2.bestMove == Move(C6, B6) && mateIn2.score == mateIn(3);
+
+		// The mated side sees the distance as well
+		const search::Result mated = runSearch("1k6/8/1K6/8/8/8/8/7R b - - 0 1", limits);
+		success &= mated.score == matedIn(4);
+		report("Search finds mates", success);
+	}
+
+	// Test that positions without legal moves are handled at the root
+	void testNoLegalMoves() {
+		search::Limits limits;
+		limits.depth = 3;
+		const search::Result stalemate = runSearch("k7/8/1Q6/8/8/8/8/7K b - - 0 1", limits);
+		bool success = !stalemate.bestMove && stalemate.score == VALUE_DRAW;
+
+		const search::Result checkmate = runSearch("k6R/8/1K6/8/8/8/8/8 b - - 0 1", limits);
+		success &= !checkmate.bestMove && checkmate.score == matedIn(0);
+		report("Search without legal moves", success);
+	}
+
+	// Test that material is won and the principal variation is legal
+	void testWinsMaterial() {
+		search::Limits limits;
+		limits.depth = 4;
+		const std::string fen = "4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1";
+		const search::Result result = runSearch(fen, limits);
+		bool success = result.bestMove == Move(D2, D5) && result.score > RookValue;
+
+		// Replay the principal variation
+		Position pos;
+		pos.set(fen);
+		TranspositionTable tt;
+		tt.resize(1);
+		const auto searcher = std::make_unique<search::Searcher>(tt);
+		searcher->setSilent(true);
+		searcher->think(pos, limits);
+		std::deque<StateInfo> states;
+		for (const Move m : searcher->rootMoves()[0].pv) {
+			success &= pos.pseudoLegal(m) && pos.legal(m);
+			pos.doMove(m, states.emplace_back());
+		}
+		report("Search wins material", success);
+	}
+
+	// Test that the quiescence search sees recaptures behind the horizon
+	void testQuiescence() {
+		search::Limits limits;
+		limits.depth = 1;
+		const search::Result result = runSearch("4k3/8/2p5/3p4/8/8/8/3QK3 w - - 0 1", limits);
+		bool success = result.bestMove && result.bestMove != Move(D1, D5) && result.score < QueenValue;
+		success &= result.qnodes > 0 && result.qnodes < result.nodes;
+
+		// Mate found at the horizon through the evasions of the quiescence search
+		const search::Result mate = runSearch("k7/8/1K6/8/8/8/8/7R w - - 0 1", limits);
+		success &= mate.bestMove == Move(H1, H8) && mate.score == mateIn(1);
+		report("Search quiescence", success);
+	}
+
+	// Test that selective search finds the same mates as the full width search, with fewer nodes
+	void testSelectivity() {
+		search::Params none;
+		none.nullMove = none.lateMoveReductions = none.reverseFutility = none.lateMovePruning = false;
+		TranspositionTable tt;
+		tt.resize(1);
+		const auto searcher = std::make_unique<search::Searcher>(tt);
+		searcher->setSilent(true);
+
+		search::Limits limits;
+		limits.depth = 6;
+		bool success = true;
+		uint64_t selectiveNodes = 0, fullNodes = 0;
+		for (const char* fen : { "k7/8/2K5/8/8/8/8/7R w - - 0 1", "6k1/5ppp/8/8/8/8/r4PPP/1R4K1 w - - 0 1" }) {
+			Position pos;
+			pos.set(fen);
+			tt.clear();
+			searcher->setParams(search::Params{});
+			const search::Result selective = searcher->think(pos, limits);
+			tt.clear();
+			searcher->setParams(none);
+			const search::Result full = searcher->think(pos, limits);
+			success &= selective.bestMove == full.bestMove && selective.score == full.score;
+			selectiveNodes += selective.nodes;
+			fullNodes += full.nodes;
+		}
+		report("Search selectivity", success && selectiveNodes < fullNodes);
+	}
+
+	// Test that the node limit stops the search
+	void testNodeLimit() {
+		search::Limits limits;
+		limits.nodes = 5000;
+		const search::Result result = runSearch(START_FEN, limits);
+		const bool success = result.bestMove && result.nodes >= 5000 && result.nodes < 5000 + 1024;
+		report("Search node limit", success);
+	}
+
+	// Test that several threads on one table agree with the single threaded search
+	void testThreadPool() {
+		TranspositionTable tt;
+		tt.resize(4);
+		search::ThreadPool pool(tt);
+		pool.setThreadCount(4);
+		pool.setSilent(true);
+
+		search::Limits limits;
+		limits.depth = 6;
+		Position pos;
+		pos.set("k7/8/2K5/8/8/8/8/7R w - - 0 1");
+		const search::Result mate = pool.think(pos, limits);
+		bool success = mate.bestMove == Move(C6, B6) && mate.score == mateIn(3);
+
+		// The node limit applies to all threads together
+		limits = {};
+		limits.nodes = 20000;
+		pos.set(START_FEN);
+		const search::Result limited = pool.think(pos, limits);
+		success &= limited.bestMove && limited.nodes >= 20000 && limited.nodes < 20000 + 4 * 1024 * 4;
+		success &= limited.nodes == pool.nodes();
+
+		// Fewer threads reuse the same table
+		pool.setThreadCount(2);
+		limits = {};
+		limits.depth = 5;
+		pos.set("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1");
+		success &= pool.think(pos, limits).bestMove == Move(D2, D5);
+		report("Search thread pool", success);
+	}
+
+	// Test merging of per-thread statistics, the branching factor and the JSON output
+	void testSearchStats() {
+		search::SearchStats a, b;
+		a.nodesPerPly[0] = 1;
+		a.nodesPerPly[1] = 10;
+		a.betaCutoffs = 10;
+		a.firstMoveCutoffs = 9;
+		a.iterations = { { 1, 10, 0, 0 }, { 2, 40, 1, 1 }, { 3, 130, 2, 1 } };
+		b.nodesPerPly[1] = 5;
+		b.betaCutoffs = 10;
+		b.firstMoveCutoffs = 7;
+		a.merge(b);
+
+		// Iterations of 10, 30 and 90 nodes grow by a factor of 3
+		bool success = a.nodesPerPly[1] == 15 && a.betaCutoffs == 20 && a.firstMoveCutoffs == 16 && a.iterations.size() == 3;
+		success &= std::abs(a.effectiveBranchingFactor() - 3.0) < 1e-9;
+
+		std::ostringstream json;
+		a.writeJson(json);
+		success &= json.str().find("\"nodesPerPly\":[1,15]") != std::string::npos
+			&& json.str().find("\"firstMoveCutoffRate\":0.8") != std::string::npos
+			&& json.str().front() == '{' && json.str().back() == '}';
+
+#ifdef SEARCH_STATS
+		// Counting itself is only compiled in with SEARCH_STATS
+		TranspositionTable tt;
+		tt.resize(1);
+		const auto searcher = std::make_unique<search::Searcher>(tt);
+		searcher->setSilent(true);
+		search::Limits limits;
+		limits.depth = 5;
+		Position pos;
+		pos.set(START_FEN);
+		searcher->think(pos, limits);
+		const search::SearchStats& stats = searcher->stats();
+		success &= stats.iterations.size() == 5 && stats.nodesPerPly[0] > 0 && stats.ttProbes >= stats.ttHits;
+#endif
+		report("Search statistics", success);
+	}
+
+	// Test that MultiPV lines hold distinct moves sorted best first, and that asking for more lines
+	// than legal moves searches them all
+	void testMultiPV() {
+		TranspositionTable tt;
+		tt.resize(1);
+		const auto searcher = std::make_unique<search::Searcher>(tt);
+		searcher->setSilent(true);
+		search::Limits limits;
+		limits.depth = 5;
+		limits.multiPV = 3;
+
+		Position pos;
+		pos.set("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+		const search::Result result = searcher->think(pos, limits);
+		const std::vector<search::RootMove>& lines = searcher->rootMoves();
+		bool success = result.depth == 5 && result.bestMove == lines[0].pv[0] && result.score == lines[0].score;
+		for (size_t i = 0; i < 3; ++i) {
+			success &= lines[i].score != -VALUE_INFINITE && !lines[i].pv.empty();
+			success &= i == 0 || (lines[i].score <= lines[i - 1].score && lines[i].pv[0] != lines[i - 1].pv[0]);
+		}
+		success &= lines[0].pv[0] != lines[2].pv[0];
+
+		// Mate in one with the rook, more lines than legal moves give every move an exact score
+		pos.set("k7/8/1K6/8/8/8/8/7R w - - 0 1");
+		limits.multiPV = 40;
+		searcher->think(pos, limits);
+		success &= searcher->rootMoves()[0].pv[0] == Move(H1, H8) && searcher->rootMoves()[0].score == mateIn(1);
+		for (const search::RootMove& rm : searcher->rootMoves())
+			success &= rm.score != -VALUE_INFINITE;
+		report("MultiPV lines", success);
+	}
+
+	// The bench signature only depends on the positions and the search, not on earlier searches
+	void testBenchSignature() {
+		bool success = benchmark::SIGNATURE_FENS.size() >= 50;
+		epd::Record record;
+		for (const std::string& fen : benchmark::SIGNATURE_FENS)
+			success &= epd::parse(fen, record);
+
+		std::ostringstream first, second;
+		const uint64_t signature = benchmark::bench(4, 1, first);
+		success &= signature > 0 && benchmark::bench(4, 1, second) == signature;
+		success &= first.str().find("Nodes searched   : " + std::to_string(signature)) != std::string::npos;
+		report("Bench signature", success);
+	}
+
+	// Run all search tests
+	void runAllSearchTests() {
+		std::cout << "Running search tests...\n" << "\n";
+
+		testFindsMate();
+		testNoLegalMoves();
+		testWinsMaterial();
+		testQuiescence();
+		testSelectivity();
+		testNodeLimit();
+		testThreadPool();
+		testSearchStats();
+		testMultiPV();
+		testBenchSignature();
+
+		std::cout << "\nSearch tests completed." << "\n";
+	}
+}
@@ -0,0 +1,5 @@
+#pragma once
+namespace chess::tests
+{
+	void runAllSearchTests();
+}
@@ -0,0 +1,141 @@
+#include "Suite.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <thread>
+#include "Epd.h"
+#include "Position.h"
+#include "TranspositionTable.h"
+
+// Suite.cpp - EPD test suites with best move (bm) and avoid move (am) operations
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// Position indices are below the number of lines by construction
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+
+namespace chess::suite {
+
+	namespace {
+		struct Task {
+			epd::Record record;
+			bool valid = false;
+		};
+
+		bool isExpected(const Move m, const std::vector<Move>& best, const std::vector<Move>& avoid) {
+			return (best.empty() || std::find(best.begin(), best.end(), m) != best.end())
+				&& std::find(avoid.begin(), avoid.end(), m) == avoid.end();
+		}
+
+		// Searches one position, following the best move of every iteration to find when it settled
+		void runPosition(search::Searcher& searcher, TranspositionTable& tt, const Task& task,
+			const search::Limits& limits, PositionResult& result) {
+			// A board that did not parse leaves no FEN to set up
+			if (!task.valid)
+				return;
+			Position pos;
+			pos.set(task.record.fen);
+			std::vector<Move> best;
+			std::vector<Move> avoid;
+			const std::string* bm = task.record.operation("bm");
+			const std::string* am = task.record.operation("am");
+			result.valid = (bm || am) && (!bm || (epd::parseMoves(pos, *bm, best) && !best.empty()))
+				&& (!am || epd::parseMoves(pos, *am, avoid));
+			if (!result.valid)
+				return;
+
+			tt.clear();
+			searcher.clearHistory();
+			bool settled = false;
+			searcher.setIterationCallback([&](const search::Iteration& it) {
+				if (!isExpected(it.bestMove, best, avoid))
+					settled = false;
+				else if (!settled) {
+					settled = true;
+					result.solveTime = it.time;
+					result.solveNodes = it.nodes;
+					result.solveDepth = it.depth;
+				}
+			});
+			const search::Result searched = searcher.think(pos, limits);
+			searcher.setIterationCallback(nullptr);
+
+			result.bestMove = searched.bestMove;
+			result.depth = searched.depth;
+			result.nodes = searched.nodes;
+			result.solved = settled && isExpected(searched.bestMove, best, avoid);
+		}
+	}
+
+	bool run(const std::string& path, const Options& options, Summary& summary) {
+		std::ifstream in(path);
+		if (!in)
+			return false;
+
+		// Position lines with their ids, blank lines and comments skipped
+		std::vector<Task> tasks;
+		summary = Summary{};
+		size_t number = 0;
+		for (std::string line; std::getline(in, line);) {
+			++number;
+			const size_t first = line.find_first_not_of(" \t\r");
+			if (first == std::string::npos || line[first] == '#')
+				continue;
+			Task& task = tasks.emplace_back();
+			task.valid = epd::parse(line, task.record);
+			const std::string* id = task.record.operation("id");
+			summary.results.emplace_back().id = id ? *id : "line " + std::to_string(number);
+		}
+
+		std::atomic<size_t> next{ 0 };
+		const auto start = std::chrono::steady_clock::now();
+		std::vector<std::thread> threads;
+		for (int t = 0; t < std::max(options.threads, 1); ++t)
+			threads.emplace_back([&] {
+				TranspositionTable tt;
+				tt.resize(options.hashMb);
+				const auto searcher = std::make_unique<search::Searcher>(tt);
+				searcher->setSilent(true);
+				for (size_t i = next.fetch_add(1); i < tasks.size(); i = next.fetch_add(1))
+					runPosition(*searcher, tt, tasks[i], options.limits, summary.results[i]);
+			});
+		for (std::thread& thread : threads)
+			thread.join();
+		summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		int64_t solveTime = 0;
+		for (const PositionResult& r : summary.results) {
+			summary.positions += r.valid;
+			summary.solved += r.solved;
+			summary.nodes += r.nodes;
+			solveTime += r.solved ? r.solveTime : 0;
+		}
+		summary.meanSolveTime = summary.solved ? static_cast<double>(solveTime) / static_cast<double>(summary.solved) : 0.0;
+		return true;
+	}
+
+	void printSummary(const Summary& summary, std::ostream& out) {
+		for (const PositionResult& r : summary.results) {
+			out << std::left << std::setw(24) << r.id << std::right;
+			if (!r.valid) {
+				out << " invalid position or expected moves\n";
+				continue;
+			}
+			char move[Move::MAX_STRING_LENGTH];
+			r.bestMove.format(move);
+			out << (r.solved ? " solved " : " failed ") << std::setw(6) << move << "  depth " << std::setw(3) << r.depth;
+			if (r.solved)
+				out << "  at " << std::setw(7) << r.solveTime << " ms " << std::setw(11) << r.solveNodes << " nodes depth " << r.solveDepth;
+			out << "\n";
+		}
+		out << "Solved " << summary.solved << " of " << summary.positions << ", mean solve time " << std::fixed
+			<< std::setprecision(1) << summary.meanSolveTime << " ms, " << summary.nodes << " nodes, " << std::setprecision(2)
+			<< summary.seconds << " s\n";
+	}
+}
+#pragma warning(pop)
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Move.h"
+#include "Search.h"
+
+// Suite.h - EPD test suites with best move (bm) and avoid move (am) operations
+
+namespace chess::suite {
+
+	struct Options {
+		search::Limits limits;  // Budget of every position, moveTime or nodes
+		int threads = 1;        // Positions searched in parallel, one searcher each
+		size_t hashMb = 16;     // Transposition table of each thread, cleared for every position
+	};
+
+	// Outcome of one position. A position is solved when the search ends on an expected move (one of
+	// bm, none of am); the solve time and nodes are those of the iteration from which on every
+	// iteration's best move was right
+	struct PositionResult {
+		std::string id;         // The id operation, or the line number
+		bool valid = false;     // A legal position with a bm or am operation naming legal moves
+		bool solved = false;
+		Move bestMove = Move::none();
+		int depth = 0;
+		uint64_t nodes = 0;
+		int64_t solveTime = 0;  // Milliseconds
+		uint64_t solveNodes = 0;
+		int solveDepth = 0;
+	};
+
+	struct Summary {
+		size_t positions = 0;   // Valid positions
+		size_t solved = 0;
+		uint64_t nodes = 0;
+		double meanSolveTime = 0.0;  // Milliseconds over the solved positions
+		double seconds = 0.0;
+		std::vector<PositionResult> results;  // In file order, invalid lines included
+	};
+
+	// Runs every position line of the EPD file, false if it cannot be read
+	bool run(const std::string& path, const Options& options, Summary& summary);
+
+	// One line per position and the totals: solved count, mean solve time and nodes
+	void printSummary(const Summary& summary, std::ostream& out);
+}
@@ -0,0 +1,954 @@
+#include "Tablebases.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include "BitBoard.h"
+#include "Endgame.h"
+#include "MappedFile.h"
+#include "MoveGen.h"
+#include "MoveList.h"
+
+// Tablebases.cpp - Syzygy WDL and DTZ tablebase probing from memory-mapped table files
+//
+// Table files hold, per side to move and leading pawn file, a canonical Huffman code over symbols
+// built by recursive pairing, cut into fixed size blocks. A position is turned into an index by
+// grouping its pieces the way the table was generated, mirroring it into a canonical part of the
+// board, and combining the square sets of the groups with binomial coefficients. Only the block
+// holding the index is read, straight from the mapping.
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// and pointer arithmetic warnings (26481). Squares, files and
+// piece counts index fixed tables; the file layout is walked with
+// raw pointers into the mapping
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+#pragma warning(disable: 26481)
+#pragma warning(disable: 26482)
+
+namespace chess::tablebases {
+
+	namespace {
+		// Index encoding tables, see initEncoding
+		std::array<int, SQUARE_NB> g_mapPawns{};
+		std::array<int, SQUARE_NB> g_mapB1H1H7{};
+		std::array<int, SQUARE_NB> g_mapA1D1D4{};
+		std::array<std::array<int, SQUARE_NB>, 10> g_mapKK{};
+		std::array<std::array<uint64_t, SQUARE_NB>, 6> g_binomial{};
+		std::array<std::array<uint64_t, SQUARE_NB>, 6> g_leadPawnIdx{};
+		std::array<std::array<uint64_t, 4>, 6> g_leadPawnsSize{};
+
+		// Table flags of the compressed data of one side and file
+		enum TableFlag : uint8_t { FLAG_STM = 1, FLAG_MAPPED = 2, FLAG_WIN_PLIES = 4, FLAG_LOSS_PLIES = 8, FLAG_WIDE = 16, FLAG_SINGLE_VALUE = 128 };
+
+		// Header flags of the first byte of a file
+		constexpr uint8_t HEADER_SPLIT = 1;
+		constexpr uint8_t HEADER_HAS_PAWNS = 2;
+
+		constexpr std::array<uint8_t, 4> WDL_MAGIC = { 0x71, 0xE8, 0x23, 0x5D };
+		constexpr std::array<uint8_t, 4> DTZ_MAGIC = { 0xD7, 0x66, 0x0C, 0xA5 };
+
+		// Distance of a square from the a1-h8 diagonal, negative below it
+		constexpr int offA1H8(const Square sq) { return static_cast<int>(rankOf(sq)) - static_cast<int>(fileOf(sq)); }
+
+		// Files store numbers in both byte orders, the Huffman data is big endian
+		template<typename T>
+		T readLE(const uint8_t* p) {
+			T v = 0;
+			for (size_t i = 0; i < sizeof(T); ++i)
+				v |= static_cast<T>(static_cast<T>(p[i]) << (8 * i));
+			return v;
+		}
+
+		template<typename T>
+		T readBE(const uint8_t* p) {
+			T v = 0;
+			for (size_t i = 0; i < sizeof(T); ++i)
+				v = static_cast<T>((v << 8) | p[i]);
+			return v;
+		}
+
+		// Decoding data of one side to move and leading pawn file, pointing into the mapping
+		struct PairsData {
+			uint8_t flags = 0;
+			size_t blockSize = 0;            // Bytes per block of Huffman symbols
+			size_t span = 0;                 // Values between two sparse index entries
+			size_t numBlocks = 0;
+			size_t blockLengthSize = 0;      // Entries of blockLength, padded beyond numBlocks
+			size_t sparseIndexSize = 0;
+			int maxSymLen = 0;
+			int minSymLen = 0;               // The value itself for single value tables
+			const uint8_t* lowestSym = nullptr;   // Lowest 16-bit symbol of each code length
+			const uint8_t* btree = nullptr;       // Pairs of 12-bit symbols each symbol expands to
+			const uint8_t* blockLength = nullptr; // Values per block minus one, 16 bits each
+			const uint8_t* sparseIndex = nullptr; // 32-bit block and 16-bit offset of every span-th value
+			const uint8_t* data = nullptr;        // Start of the blocks
+			std::vector<uint64_t> base64;    // Lowest code of each length, left aligned in 64 bits
+			std::vector<uint8_t> symLen;     // Values a symbol expands to, minus one
+			std::array<Piece, MAX_PIECES> pieces{};          // Order the pieces are encoded in
+			std::array<uint64_t, MAX_PIECES + 1> groupIdx{}; // Index multiplier of each group
+			std::array<int, MAX_PIECES + 1> groupLen{};      // Pieces per group, zero terminated
+			std::array<uint16_t, 4> mapIdx{};                // DTZ value maps by WDL result
+
+			[[nodiscard]] int left(const int sym) const { return ((btree[3 * sym + 1] & 0xF) << 8) | btree[3 * sym]; }
+			[[nodiscard]] int right(const int sym) const { return (btree[3 * sym + 2] << 4) | (btree[3 * sym + 1] >> 4); }
+		};
+
+		struct Table {
+			Table(const std::string& code, const bool isDtz) : name(code), dtz(isDtz) {
+				std::string pieces = code;
+				pieces.erase(pieces.find('v'), 1);
+				key = endgames::materialKey(pieces, WHITE);
+				key2 = endgames::materialKey(pieces, BLACK);
+				pieceCount = static_cast<int>(pieces.size());
+
+				// The pieces up to the 'v' are white's in the table
+				std::array<std::array<int, PIECE_TYPE_NB>, COLOR_NB> counts{};
+				Color c = WHITE;
+				for (const char ch : code) {
+					if (ch == 'v')
+						c = BLACK;
+					else
+						++counts[c][std::string(" PNBRQK").find(ch)];
+				}
+				hasPawns = counts[WHITE][PAWN] || counts[BLACK][PAWN];
+				for (const Color side : { WHITE, BLACK })
+					for (PieceType pt = PAWN; pt < KING; ++pt)
+						hasUniquePieces |= counts[side][pt] == 1;
+
+				// Pawns of the side with fewer of them lead, which compresses better
+				const bool whiteLeads = !counts[BLACK][PAWN] || (counts[WHITE][PAWN] && counts[BLACK][PAWN] >= counts[WHITE][PAWN]);
+				pawnCount[0] = static_cast<uint8_t>(counts[whiteLeads ? WHITE : BLACK][PAWN]);
+				pawnCount[1] = static_cast<uint8_t>(counts[whiteLeads ? BLACK : WHITE][PAWN]);
+			}
+
+			[[nodiscard]] int sides() const { return dtz ? 1 : 2; }
+			PairsData& get(const int stm, const int file) { return items[stm % sides()][hasPawns ? file : 0]; }
+
+			std::string name;                // Like "KRPvKR", white's pieces first
+			bool dtz;
+			std::atomic<bool> ready{ false };  // Mapping was attempted
+			MappedFile file;
+			bool valid = false;              // Mapped and parsed
+			const uint8_t* dtzMap = nullptr;
+			HashKey key = 0;                 // Material key with the first pieces white
+			HashKey key2 = 0;                // And with them black
+			int pieceCount = 0;
+			bool hasPawns = false;
+			bool hasUniquePieces = false;
+			std::array<uint8_t, 2> pawnCount{};  // Leading color first
+			std::array<std::array<PairsData, 4>, 2> items;  // By side to move and leading pawn file
+		};
+
+		// Tables by material key of either color assignment, open addressing on the low key bits
+		struct TableEntry {
+			HashKey key = 0;
+			Table* wdl = nullptr;
+			Table* dtz = nullptr;
+		};
+		constexpr size_t HASH_SIZE = 1 << 13;
+		std::array<TableEntry, HASH_SIZE> g_tableHash{};
+
+		std::deque<Table> g_wdlTables;
+		std::deque<Table> g_dtzTables;
+		std::vector<std::string> g_paths;
+		int g_maxCardinality = 0;
+		std::mutex g_mapMutex;
+
+		std::atomic<uint64_t> g_wdlProbes{ 0 };
+		std::atomic<uint64_t> g_dtzProbes{ 0 };
+		std::atomic<uint64_t> g_failures{ 0 };
+		std::atomic<uint64_t> g_nanoseconds{ 0 };
+
+		void insert(const HashKey key, Table* wdl, Table* dtz) {
+			for (size_t i = key & (HASH_SIZE - 1); ; i = (i + 1) & (HASH_SIZE - 1))
+				if (!g_tableHash[i].wdl || g_tableHash[i].key == key) {
+					g_tableHash[i] = { key, wdl, dtz };
+					return;
+				}
+		}
+
+		const TableEntry* lookup(const HashKey key) {
+			for (size_t i = key & (HASH_SIZE - 1); ; i = (i + 1) & (HASH_SIZE - 1))
+				if (!g_tableHash[i].wdl || g_tableHash[i].key == key)
+					return g_tableHash[i].wdl ? &g_tableHash[i] : nullptr;
+		}
+
+		std::string findFile(const std::string& name) {
+			for (const std::string& dir : g_paths) {
+				const std::filesystem::path path = std::filesystem::path(dir) / name;
+				std::error_code ec;
+				if (std::filesystem::is_regular_file(path, ec))
+					return path.string();
+			}
+			return {};
+		}
+
+		void addTable(const std::vector<PieceType>& pieces) {
+			std::string code;
+			for (const PieceType pt : pieces) {
+				if (pt == KING && !code.empty())
+					code += 'v';
+				code += " PNBRQK"[pt];
+			}
+			if (findFile(code + ".rtbw").empty())
+				return;
+
+			g_maxCardinality = std::max(g_maxCardinality, static_cast<int>(pieces.size()));
+			Table& wdl = g_wdlTables.emplace_back(code, false);
+			Table& dtz = g_dtzTables.emplace_back(code, true);
+			insert(wdl.key, &wdl, &dtz);
+			insert(wdl.key2, &wdl, &dtz);
+		}
+
+		void initEncoding() {
+			// Squares below the a1-h8 diagonal to 0..27
+			int code = 0;
+			for (Square sq = A1; sq <= H8; ++sq)
+				if (offA1H8(sq) < 0)
+					g_mapB1H1H7[sq] = code++;
+
+			// The a1-d1-d4 triangle to 0..9, the diagonal squares last
+			std::vector<Square> diagonal;
+			code = 0;
+			for (Square sq = A1; sq <= D4; ++sq)
+				if (offA1H8(sq) < 0 && fileOf(sq) <= FILE_D)
+					g_mapA1D1D4[sq] = code++;
+				else if (!offA1H8(sq) && fileOf(sq) <= FILE_D)
+					diagonal.push_back(sq);
+			for (const Square sq : diagonal)
+				g_mapA1D1D4[sq] = code++;
+
+			// The 462 legal placements of two kings with the first in the triangle. With the first on
+			// the diagonal the second is not above it; placements with both on the diagonal come last
+			std::vector<std::pair<int, Square>> bothOnDiagonal;
+			code = 0;
+			for (int idx = 0; idx < 10; ++idx)
+				for (Square s1 = A1; s1 <= D4; ++s1)
+					if (g_mapA1D1D4[s1] == idx && (idx || s1 == B1)) {
+						for (Square s2 = A1; s2 <= H8; ++s2) {
+							if (g_squareDistance[s1][s2] <= 1)
+								continue;
+							if (!offA1H8(s1) && offA1H8(s2) > 0)
+								continue;
+							if (!offA1H8(s1) && !offA1H8(s2))
+								bothOnDiagonal.emplace_back(idx, s2);
+							else
+								g_mapKK[idx][s2] = code++;
+						}
+					}
+			for (const auto& [idx, sq] : bothOnDiagonal)
+				g_mapKK[idx][sq] = code++;
+
+			// Binomial coefficients, g_binomial[k][n] ways to choose k of n squares
+			g_binomial[0][0] = 1;
+			for (int n = 1; n < SQUARE_NB; ++n)
+				for (int k = 0; k < 6 && k <= n; ++k)
+					g_binomial[k][n] = (k > 0 ? g_binomial[k - 1][n - 1] : 0) + (k < n ? g_binomial[k][n - 1] : 0);
+
+			// Pawn squares a2-h7 to 0..47, the leading pawn is the one with the highest value: nearest
+			// the edge and lowest on its file. Leading pawn indices restart on every file, as the table is
+			// split by the file of the leading pawn
+			int availableSquares = 47;
+			for (int leadPawns = 1; leadPawns <= 5; ++leadPawns)
+				for (File f = FILE_A; f <= FILE_D; ++f) {
+					uint64_t idx = 0;
+					for (Rank r = RANK_2; r <= RANK_7; ++r) {
+						const Square sq = makeSquare(f, r);
+						if (leadPawns == 1) {
+							g_mapPawns[sq] = availableSquares--;
+							g_mapPawns[flipFile(sq)] = availableSquares--;
+						}
+						g_leadPawnIdx[leadPawns][sq] = idx;
+						idx += g_binomial[leadPawns - 1][g_mapPawns[sq]];
+					}
+					g_leadPawnsSize[leadPawns][f] = idx;
+				}
+		}
+
+		bool pawnsBefore(const Square a, const Square b) { return g_mapPawns[a] < g_mapPawns[b]; }
+
+		// Group sizes and index multipliers from the piece order of the table. The first group holds the
+		// leading pawns, or the kings and a third unique piece if there is one; the order the groups are
+		// multiplied in comes from the file
+		void setGroups(const Table& t, PairsData& d, const std::array<int, 2>& order, const File f) {
+			int n = 0;
+			int firstLen = t.hasPawns ? 0 : t.hasUniquePieces ? 3 : 2;
+			d.groupLen[n] = 1;
+			for (int i = 1; i < t.pieceCount; ++i)
+				if (--firstLen > 0 || d.pieces[i] == d.pieces[i - 1])
+					d.groupLen[n]++;
+				else
+					d.groupLen[++n] = 1;
+			d.groupLen[++n] = 0;
+
+			const bool bothPawns = t.hasPawns && t.pawnCount[1];
+			int next = bothPawns ? 2 : 1;
+			int freeSquares = 64 - d.groupLen[0] - (bothPawns ? d.groupLen[1] : 0);
+			uint64_t idx = 1;
+			for (int k = 0; next < n || k == order[0] || k == order[1]; ++k)
+				if (k == order[0]) {
+					d.groupIdx[0] = idx;
+					idx *= t.hasPawns ? g_leadPawnsSize[d.groupLen[0]][f] : t.hasUniquePieces ? 31332 : 462;
+				}
+				else if (k == order[1]) {
+					d.groupIdx[1] = idx;
+					idx *= g_binomial[d.groupLen[1]][48 - d.groupLen[0]];
+				}
+				else {
+					d.groupIdx[next] = idx;
+					idx *= g_binomial[d.groupLen[next]][freeSquares];
+					freeSquares -= d.groupLen[next++];
+				}
+			d.groupIdx[n] = idx;
+		}
+
+		// Values a symbol expands to, the pair tree has no cycles
+		uint8_t symbolLength(PairsData& d, const int sym, std::vector<bool>& visited) {
+			visited[sym] = true;
+			const int sr = d.right(sym);
+			if (sr == 0xFFF)
+				return 0;
+			const int sl = d.left(sym);
+			if (!visited[sl])
+				d.symLen[sl] = symbolLength(d, sl, visited);
+			if (!visited[sr])
+				d.symLen[sr] = symbolLength(d, sr, visited);
+			return static_cast<uint8_t>(d.symLen[sl] + d.symLen[sr] + 1);
+		}
+
+		const uint8_t* setSizes(PairsData& d, const uint8_t* data) {
+			d.flags = *data++;
+			if (d.flags & FLAG_SINGLE_VALUE) {
+				d.minSymLen = *data++;
+				return data;
+			}
+
+			// The last group multiplier is the number of positions in the table
+			const uint64_t tableSize = d.groupIdx[std::find(d.groupLen.begin(), d.groupLen.end(), 0) - d.groupLen.begin()];
+			d.blockSize = size_t{ 1 } << *data++;
+			d.span = size_t{ 1 } << *data++;
+			d.sparseIndexSize = static_cast<size_t>((tableSize + d.span - 1) / d.span);
+			const uint8_t padding = *data++;
+			d.numBlocks = readLE<uint32_t>(data);
+			data += sizeof(uint32_t);
+			d.blockLengthSize = d.numBlocks + padding;
+			d.maxSymLen = *data++;
+			d.minSymLen = *data++;
+			d.lowestSym = data;
+
+			// Canonical Huffman code: longer codes have lower values, so the lowest code of each length
+			// padded to 64 bits decreases with the length and bounds the codes of that length from below
+			const auto lowest = [&d](const size_t i) { return readLE<uint16_t>(d.lowestSym + 2 * i); };
+			d.base64.assign(static_cast<size_t>(d.maxSymLen - d.minSymLen + 1), 0);
+			for (int i = static_cast<int>(d.base64.size()) - 2; i >= 0; --i)
+				d.base64[i] = (d.base64[i + 1] + lowest(i) - lowest(i + 1)) / 2;
+			for (size_t i = 0; i < d.base64.size(); ++i)
+				d.base64[i] <<= 64 - i - d.minSymLen;
+			data += d.base64.size() * sizeof(uint16_t);
+
+			d.symLen.assign(readLE<uint16_t>(data), 0);
+			data += sizeof(uint16_t);
+			d.btree = data;
+			std::vector<bool> visited(d.symLen.size());
+			for (size_t sym = 0; sym < d.symLen.size(); ++sym)
+				if (!visited[sym])
+					d.symLen[sym] = symbolLength(d, static_cast<int>(sym), visited);
+			return data + 3 * d.symLen.size() + (d.symLen.size() & 1);
+		}
+
+		// Maps from stored DTZ values to distances, one per WDL result, stored after the sizes
+		const uint8_t* setDtzMap(Table& t, const uint8_t* data, const File maxFile) {
+			t.dtzMap = data;
+			for (File f = FILE_A; f <= maxFile; ++f) {
+				PairsData& d = t.get(0, f);
+				if (!(d.flags & FLAG_MAPPED))
+					continue;
+				if (d.flags & FLAG_WIDE) {
+					data += reinterpret_cast<uintptr_t>(data) & 1;
+					for (int i = 0; i < 4; ++i) {
+						d.mapIdx[i] = static_cast<uint16_t>((data - t.dtzMap) / 2 + 1);
+						data += 2 * static_cast<size_t>(readLE<uint16_t>(data)) + 2;
+					}
+				}
+				else
+					for (int i = 0; i < 4; ++i) {
+						d.mapIdx[i] = static_cast<uint16_t>(data - t.dtzMap + 1);
+						data += *data + 1;
+					}
+			}
+			return data + (reinterpret_cast<uintptr_t>(data) & 1);
+		}
+
+		// Parses the layout of a mapped file behind its magic, false if it does not match the table
+		bool parse(Table& t, const uint8_t* data, const uint8_t* end) {
+			if (t.hasPawns != static_cast<bool>(*data & HEADER_HAS_PAWNS) || (t.key != t.key2) != static_cast<bool>(*data & HEADER_SPLIT))
+				return false;
+			++data;
+
+			const int sides = t.sides() == 2 && t.key != t.key2 ? 2 : 1;
+			const File maxFile = t.hasPawns ? FILE_D : FILE_A;
+			const bool bothPawns = t.hasPawns && t.pawnCount[1];
+
+			for (File f = FILE_A; f <= maxFile; ++f) {
+				for (int i = 0; i < sides; ++i)
+					t.get(i, f) = PairsData{};
+				const std::array<std::array<int, 2>, 2> order = { {
+					{ *data & 0xF, bothPawns ? *(data + 1) & 0xF : 0xF },
+					{ *data >> 4, bothPawns ? *(data + 1) >> 4 : 0xF } } };
+				data += 1 + bothPawns;
+				for (int k = 0; k < t.pieceCount; ++k, ++data)
+					for (int i = 0; i < sides; ++i)
+						t.get(i, f).pieces[k] = static_cast<Piece>(i ? *data >> 4 : *data & 0xF);
+				for (int i = 0; i < sides; ++i)
+					setGroups(t, t.get(i, f), order[i], f);
+			}
+			data += reinterpret_cast<uintptr_t>(data) & 1;
+
+			for (File f = FILE_A; f <= maxFile; ++f)
+				for (int i = 0; i < sides; ++i)
+					data = setSizes(t.get(i, f), data);
+			if (t.dtz)
+				data = setDtzMap(t, data, maxFile);
+
+			for (File f = FILE_A; f <= maxFile; ++f)
+				for (int i = 0; i < sides; ++i) {
+					t.get(i, f).sparseIndex = data;
+					data += t.get(i, f).sparseIndexSize * 6;
+				}
+			for (File f = FILE_A; f <= maxFile; ++f)
+				for (int i = 0; i < sides; ++i) {
+					t.get(i, f).blockLength = data;
+					data += t.get(i, f).blockLengthSize * sizeof(uint16_t);
+				}
+			for (File f = FILE_A; f <= maxFile; ++f)
+				for (int i = 0; i < sides; ++i) {
+					data = reinterpret_cast<const uint8_t*>((reinterpret_cast<uintptr_t>(data) + 0x3F) & ~uintptr_t{ 0x3F });
+					t.get(i, f).data = data;
+					data += t.get(i, f).numBlocks * t.get(i, f).blockSize;
+				}
+			return data <= end;
+		}
+
+		// Maps the table file on its first probe, by any thread
+		bool mapped(Table& t) {
+			if (t.ready.load(std::memory_order_acquire))
+				return t.valid;
+
+			std::scoped_lock lock(g_mapMutex);
+			if (t.ready.load(std::memory_order_relaxed))
+				return t.valid;
+
+			// Files are a multiple of 64 bytes plus the magic and 12 bytes of padding
+			const std::string path = findFile(t.name + (t.dtz ? ".rtbz" : ".rtbw"));
+			if (!path.empty() && t.file.open(path)) {
+				const uint8_t* data = t.file.data();
+				const auto& magic = t.dtz ? DTZ_MAGIC : WDL_MAGIC;
+				t.valid = t.file.size() % 64 == 16 && std::memcmp(data, magic.data(), magic.size()) == 0
+					&& parse(t, data + magic.size(), data + t.file.size());
+				if (!t.valid)
+					t.file.close();
+			}
+			t.ready.store(true, std::memory_order_release);
+			return t.valid;
+		}
+
+		// Value at idx: the block holding it is found from the sparse index, then its symbols are
+		// decoded up to the one covering idx and that symbol is expanded down the pair tree
+		int decompressPairs(const PairsData& d, const uint64_t idx) {
+			if (d.flags & FLAG_SINGLE_VALUE)
+				return d.minSymLen;
+
+			// Sparse entry k points at value k * span + span / 2
+			const size_t k = static_cast<size_t>(idx / d.span);
+			uint32_t block = readLE<uint32_t>(d.sparseIndex + 6 * k);
+			int offset = readLE<uint16_t>(d.sparseIndex + 6 * k + 4);
+			offset += static_cast<int>(idx % d.span) - static_cast<int>(d.span / 2);
+
+			const auto blockLength = [&d](const uint32_t b) { return static_cast<int>(readLE<uint16_t>(d.blockLength + 2 * static_cast<size_t>(b))); };
+			while (offset < 0)
+				offset += blockLength(--block) + 1;
+			while (offset > blockLength(block))
+				offset -= blockLength(block++) + 1;
+
+			const uint8_t* ptr = d.data + static_cast<size_t>(block) * d.blockSize;
+			uint64_t buf64 = readBE<uint64_t>(ptr);
+			ptr += 8;
+			int buf64Size = 64;
+			int sym;
+			while (true) {
+				// Code length from the left aligned bounds, then the symbol from the lowest one of that length
+				int len = 0;
+				while (buf64 < d.base64[len])
+					++len;
+				sym = static_cast<int>((buf64 - d.base64[len]) >> (64 - len - d.minSymLen));
+				sym += readLE<uint16_t>(d.lowestSym + 2 * static_cast<size_t>(len));
+
+				if (offset < d.symLen[sym] + 1)
+					break;
+				offset -= d.symLen[sym] + 1;
+				len += d.minSymLen;
+				buf64 <<= len;
+				buf64Size -= len;
+				if (buf64Size <= 32) {
+					buf64Size += 32;
+					buf64 |= static_cast<uint64_t>(readBE<uint32_t>(ptr)) << (64 - buf64Size);
+					ptr += 4;
+				}
+			}
+
+			// Pairs are adjacent in the expansion, so offset tells which side holds the value
+			while (d.symLen[sym]) {
+				const int left = d.left(sym);
+				if (offset < d.symLen[left] + 1)
+					sym = left;
+				else {
+					offset -= d.symLen[left] + 1;
+					sym = d.right(sym);
+				}
+			}
+			return d.left(sym);
+		}
+
+		// DTZ values to plies: stored in moves unless flagged, the maps undo the value remapping
+		int mapDtz(Table& t, const File f, int value, const WDLScore wdl) {
+			constexpr std::array<int, 5> WDL_MAP = { 1, 3, 0, 2, 0 };
+			const PairsData& d = t.get(0, f);
+			if (d.flags & FLAG_MAPPED) {
+				const size_t at = static_cast<size_t>(d.mapIdx[WDL_MAP[wdl + 2]]) + static_cast<size_t>(value);
+				value = d.flags & FLAG_WIDE ? readLE<uint16_t>(t.dtzMap + 2 * at) : t.dtzMap[at];
+			}
+			if ((wdl == WDL_WIN && !(d.flags & FLAG_WIN_PLIES)) || (wdl == WDL_LOSS && !(d.flags & FLAG_LOSS_PLIES))
+				|| wdl == WDL_CURSED_WIN || wdl == WDL_BLESSED_LOSS)
+				value *= 2;
+			return value + 1;
+		}
+
+		// Index of the position in the table and the stored value. Tables are generated with white as
+		// the side named first, so positions with the colors the other way round are flipped
+		int probeTable(const Position& pos, Table& t, const WDLScore wdl, ProbeState& state) {
+			std::array<Square, MAX_PIECES> squares{};
+			std::array<Piece, MAX_PIECES> pieces{};
+			int size = 0;
+			int leadPawnsCount = 0;
+			Bitboard leadPawns = 0;
+			File tbFile = FILE_A;
+
+			// Symmetric tables only store white to move
+			const bool symmetricBlackToMove = t.key == t.key2 && pos.sideToMove() == BLACK;
+			const bool blackStronger = pos.materialKey() != t.key;
+			const bool flip = symmetricBlackToMove || blackStronger;
+			const int flipColor = flip * 8;
+			const int flipSquares = flip * 56;
+			const int stm = flip ^ (pos.sideToMove() == BLACK);
+
+			// Pawn tables are split by the file of the leading pawn, mirrored to files a-d
+			if (t.hasPawns) {
+				const Piece pc = static_cast<Piece>(t.get(0, 0).pieces[0] ^ flipColor);
+				assert(typeOf(pc) == PAWN);
+				Bitboard b = leadPawns = pos.pieces(colorOf(pc), PAWN);
+				while (b)
+					squares[size++] = static_cast<Square>(popLsb(b) ^ flipSquares);
+				leadPawnsCount = size;
+				std::swap(squares[0], *std::max_element(squares.begin(), squares.begin() + leadPawnsCount, pawnsBefore));
+				tbFile = static_cast<File>(std::min<int>(fileOf(squares[0]), FILE_H - fileOf(squares[0])));
+			}
+
+			if (t.dtz) {
+				const uint8_t flags = t.get(stm, tbFile).flags;
+				if ((flags & FLAG_STM) != stm && !(t.key == t.key2 && !t.hasPawns)) {
+					state = PROBE_CHANGE_STM;
+					return 0;
+				}
+			}
+
+			Bitboard b = pos.pieces() ^ leadPawns;
+			while (b) {
+				const Square sq = popLsb(b);
+				squares[size] = static_cast<Square>(sq ^ flipSquares);
+				pieces[size++] = static_cast<Piece>(pos.pieceOn(sq) ^ flipColor);
+			}
+			assert(size >= 2);
+
+			// Reorder the pieces into the sequence of the table
+			PairsData& d = t.get(stm, tbFile);
+			for (int i = leadPawnsCount; i < size - 1; ++i)
+				for (int j = i + 1; j < size; ++j)
+					if (d.pieces[i] == pieces[j]) {
+						std::swap(pieces[i], pieces[j]);
+						std::swap(squares[i], squares[j]);
+						break;
+					}
+
+			// The leading piece goes to files a-d
+			if (fileOf(squares[0]) > FILE_D)
+				for (int i = 0; i < size; ++i)
+					squares[i] = flipFile(squares[i]);
+
+			uint64_t idx;
+			if (t.hasPawns) {
+				idx = g_leadPawnIdx[leadPawnsCount][squares[0]];
+				std::stable_sort(squares.begin() + 1, squares.begin() + leadPawnsCount, pawnsBefore);
+				for (int i = 1; i < leadPawnsCount; ++i)
+					idx += g_binomial[i][g_mapPawns[squares[i]]];
+			}
+			else {
+				// Without pawns the board is also mirrored to ranks 1-4 and below the a1-h8 diagonal
+				if (rankOf(squares[0]) > RANK_4)
+					for (int i = 0; i < size; ++i)
+						squares[i] = flipRank(squares[i]);
+				for (int i = 0; i < d.groupLen[0]; ++i) {
+					if (!offA1H8(squares[i]))
+						continue;
+					if (offA1H8(squares[i]) > 0)
+						for (int j = i; j < size; ++j)
+							squares[j] = static_cast<Square>(((squares[j] >> 3) | (squares[j] << 3)) & 63);
+					break;
+				}
+
+				if (t.hasUniquePieces) {
+					// Three unique pieces, the first in the a1-d1-d4 triangle, are encoded together
+					const int adjust1 = squares[1] > squares[0];
+					const int adjust2 = (squares[2] > squares[0]) + (squares[2] > squares[1]);
+					if (offA1H8(squares[0]))
+						idx = (g_mapA1D1D4[squares[0]] * 63 + (squares[1] - adjust1)) * 62 + squares[2] - adjust2;
+					else if (offA1H8(squares[1]))
+						idx = (6 * 63 + rankOf(squares[0]) * 28 + g_mapB1H1H7[squares[1]]) * 62 + squares[2] - adjust2;
+					else if (offA1H8(squares[2]))
+						idx = 6 * 63 * 62 + 4 * 28 * 62 + rankOf(squares[0]) * 7 * 28
+							+ (rankOf(squares[1]) - adjust1) * 28 + g_mapB1H1H7[squares[2]];
+					else
+						idx = 6 * 63 * 62 + 4 * 28 * 62 + 4 * 7 * 28 + rankOf(squares[0]) * 7 * 6
+							+ (rankOf(squares[1]) - adjust1) * 6 + (rankOf(squares[2]) - adjust2);
+				}
+				else
+					idx = g_mapKK[g_mapA1D1D4[squares[0]]][squares[1]];
+			}
+
+			// Remaining groups by ascending squares, skipping the squares taken by earlier groups
+			idx *= d.groupIdx[0];
+			Square* groupSq = squares.data() + d.groupLen[0];
+			bool remainingPawns = t.hasPawns && t.pawnCount[1];
+			for (int next = 1; d.groupLen[next]; ++next) {
+				std::stable_sort(groupSq, groupSq + d.groupLen[next]);
+				uint64_t n = 0;
+				for (int i = 0; i < d.groupLen[next]; ++i) {
+					const auto adjust = std::count_if(squares.data(), groupSq, [&](const Square sq) { return groupSq[i] > sq; });
+					n += g_binomial[i + 1][groupSq[i] - adjust - 8 * remainingPawns];
+				}
+				remainingPawns = false;
+				idx += n * d.groupIdx[next];
+				groupSq += d.groupLen[next];
+			}
+
+			const int value = decompressPairs(d, idx);
+			return t.dtz ? mapDtz(t, tbFile, value, wdl) : value - 2;
+		}
+
+		int probeTable(const Position& pos, const bool dtz, ProbeState& state, const WDLScore wdl = WDL_DRAW) {
+			if (popCount(pos.pieces()) == 2)
+				return WDL_DRAW;
+			const TableEntry* entry = lookup(pos.materialKey());
+			Table* t = entry ? (dtz ? entry->dtz : entry->wdl) : nullptr;
+			if (!t || !mapped(*t)) {
+				state = PROBE_FAIL;
+				return 0;
+			}
+			return probeTable(pos, *t, wdl, state);
+		}
+
+		int signOf(const int v) { return (v > 0) - (v < 0); }
+
+		int dtzBeforeZeroing(const WDLScore wdl) {
+			return wdl == WDL_WIN ? 1 : wdl == WDL_CURSED_WIN ? 101 : wdl == WDL_BLESSED_LOSS ? -101 : wdl == WDL_LOSS ? -1 : 0;
+		}
+
+		// Tables do not store positions with en passant rights and their values are wrong when a capture
+		// is best, so captures (and pawn moves for DTZ) are searched first and the table is consulted after
+		template<bool CheckZeroingMoves>
+		WDLScore search(Position& pos, ProbeState& state) {
+			WDLScore bestValue = WDL_LOSS;
+			MoveList moves;
+			generate<LEGAL>(pos, moves);
+			int moveCount = 0;
+
+			StateInfo st;
+			for (const ScoredMove& sm : moves) {
+				const Move m = sm.move();
+				if (!pos.capture(m) && (!CheckZeroingMoves || typeOf(pos.movedPiece(m)) != PAWN))
+					continue;
+				++moveCount;
+				pos.doMove(m, st);
+				const WDLScore value = static_cast<WDLScore>(-search<false>(pos, state));
+				pos.undoMove(m);
+				if (state == PROBE_FAIL)
+					return WDL_DRAW;
+				if (value > bestValue) {
+					bestValue = value;
+					if (value >= WDL_WIN) {
+						state = PROBE_ZEROING_BEST_MOVE;
+						return value;
+					}
+				}
+			}
+
+			// With every legal move searched the table is not needed, and would be wrong with en passant
+			const bool noMoreMoves = moveCount && moveCount == moves.size();
+			WDLScore value;
+			if (noMoreMoves)
+				value = bestValue;
+			else {
+				value = static_cast<WDLScore>(probeTable(pos, false, state));
+				if (state == PROBE_FAIL)
+					return WDL_DRAW;
+			}
+
+			if (bestValue >= value) {
+				state = bestValue > WDL_DRAW || noMoreMoves ? PROBE_ZEROING_BEST_MOVE : PROBE_OK;
+				return bestValue;
+			}
+			state = PROBE_OK;
+			return value;
+		}
+
+		int probeDtzUntimed(Position& pos, ProbeState& state) {
+			state = PROBE_OK;
+			const WDLScore wdl = search<true>(pos, state);
+			if (state == PROBE_FAIL || wdl == WDL_DRAW)
+				return 0;
+			if (state == PROBE_ZEROING_BEST_MOVE)
+				return dtzBeforeZeroing(wdl);
+
+			int dtz = probeTable(pos, true, state, wdl);
+			if (state == PROBE_FAIL)
+				return 0;
+			if (state != PROBE_CHANGE_STM)
+				return (dtz + 100 * (wdl == WDL_BLESSED_LOSS || wdl == WDL_CURSED_WIN)) * signOf(wdl);
+
+			// The table holds the other side to move: one ply of search for the best winning move
+			int minDtz = 0xFFFF;
+			MoveList moves;
+			generate<LEGAL>(pos, moves);
+			StateInfo st;
+			for (const ScoredMove& sm : moves) {
+				const Move m = sm.move();
+				const bool zeroing = pos.capture(m) || typeOf(pos.movedPiece(m)) == PAWN;
+				pos.doMove(m, st);
+
+				// A zeroing move gives the distance before it, of the sign of the position after it
+				dtz = zeroing ? -dtzBeforeZeroing(search<false>(pos, state)) : -probeDtzUntimed(pos, state);
+				if (dtz == 1 && pos.checkers()) {
+					MoveList replies;
+					generate<LEGAL>(pos, replies);
+					if (replies.empty())
+						minDtz = 1;
+				}
+				if (!zeroing)
+					dtz += signOf(dtz);
+				if (dtz < minDtz && signOf(dtz) == signOf(wdl))
+					minDtz = dtz;
+				pos.undoMove(m);
+				if (state == PROBE_FAIL)
+					return 0;
+			}
+			return minDtz == 0xFFFF ? -1 : minDtz;
+		}
+
+		// Has a position repeated since the last capture or pawn move
+		bool repeatedSinceZeroing(const Position& pos) {
+			const StateInfo* st = pos.state();
+			for (int end = std::min(st->halfmoveClock, st->pliesFromNull); end >= 4 && st; --end, st = st->previous)
+				if (st->repetition)
+					return true;
+			return false;
+		}
+
+		// Keeps the moves of the best rank, moves are left alone when nothing could be probed
+		bool keepBestRanked(std::vector<Move>& moves, const std::vector<int>& ranks) {
+			const int best = *std::max_element(ranks.begin(), ranks.end());
+			std::vector<Move> kept;
+			for (size_t i = 0; i < moves.size(); ++i)
+				if (ranks[i] == best)
+					kept.push_back(moves[i]);
+			moves = std::move(kept);
+			return true;
+		}
+
+		class ProbeTimer {
+		public:
+			explicit ProbeTimer(std::atomic<uint64_t>& counter) : m_start(std::chrono::steady_clock::now()) {
+				counter.fetch_add(1, std::memory_order_relaxed);
+			}
+			~ProbeTimer() {
+				const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+				g_nanoseconds.fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+			}
+			ProbeTimer(const ProbeTimer&) = delete;
+			ProbeTimer& operator=(const ProbeTimer&) = delete;
+
+		private:
+			std::chrono::steady_clock::time_point m_start;
+		};
+	}
+
+	void init(const std::string& paths) {
+		static bool encodingReady = false;
+		if (!encodingReady) {
+			initEncoding();
+			encodingReady = true;
+		}
+
+		g_tableHash.fill(TableEntry{});
+		g_wdlTables.clear();
+		g_dtzTables.clear();
+		g_paths.clear();
+		g_maxCardinality = 0;
+
+#ifdef _WIN32
+		constexpr char SEPARATOR = ';';
+#else
+		constexpr char SEPARATOR = ':';
+#endif
+		size_t start = 0;
+		while (start <= paths.size()) {
+			const size_t end = std::min(paths.find(SEPARATOR, start), paths.size());
+			if (end > start)
+				g_paths.push_back(paths.substr(start, end - start));
+			start = end + 1;
+		}
+		if (g_paths.empty())
+			return;
+
+		// Every material configuration up to MAX_PIECES, each side's pieces strongest first
+		for (PieceType p1 = PAWN; p1 < KING; ++p1) {
+			addTable({ KING, p1, KING });
+			for (PieceType p2 = PAWN; p2 <= p1; ++p2) {
+				addTable({ KING, p1, p2, KING });
+				addTable({ KING, p1, KING, p2 });
+				for (PieceType p3 = PAWN; p3 < KING; ++p3)
+					addTable({ KING, p1, p2, KING, p3 });
+				for (PieceType p3 = PAWN; p3 <= p2; ++p3) {
+					addTable({ KING, p1, p2, p3, KING });
+					for (PieceType p4 = PAWN; p4 <= p3; ++p4) {
+						addTable({ KING, p1, p2, p3, p4, KING });
+						for (PieceType p5 = PAWN; p5 <= p4; ++p5)
+							addTable({ KING, p1, p2, p3, p4, p5, KING });
+						for (PieceType p5 = PAWN; p5 < KING; ++p5)
+							addTable({ KING, p1, p2, p3, p4, KING, p5 });
+					}
+					for (PieceType p4 = PAWN; p4 < KING; ++p4) {
+						addTable({ KING, p1, p2, p3, KING, p4 });
+						for (PieceType p5 = PAWN; p5 <= p4; ++p5)
+							addTable({ KING, p1, p2, p3, KING, p4, p5 });
+					}
+				}
+				for (PieceType p3 = PAWN; p3 <= p1; ++p3)
+					for (PieceType p4 = PAWN; p4 <= (p1 == p3 ? p2 : p3); ++p4)
+						addTable({ KING, p1, p2, KING, p3, p4 });
+			}
+		}
+	}
+
+	int maxCardinality() {
+		return g_maxCardinality;
+	}
+
+	WDLScore probeWdl(Position& pos, ProbeState& state) {
+		const ProbeTimer timer(g_wdlProbes);
+		state = PROBE_OK;
+		const WDLScore wdl = search<false>(pos, state);
+		if (state == PROBE_FAIL)
+			g_failures.fetch_add(1, std::memory_order_relaxed);
+		return wdl;
+	}
+
+	int probeDtz(Position& pos, ProbeState& state) {
+		const ProbeTimer timer(g_dtzProbes);
+		const int dtz = probeDtzUntimed(pos, state);
+		if (state == PROBE_FAIL)
+			g_failures.fetch_add(1, std::memory_order_relaxed);
+		return dtz;
+	}
+
+	bool filterRootMoves(Position& pos, std::vector<Move>& moves) {
+		if (moves.empty())
+			return false;
+
+		// Wins within the 50-move rule are ranked equally, unless a repetition shows no progress is
+		// being made; losses that reach the 50-move rule are better than quick ones
+		const int rule50 = pos.rule50Count();
+		const bool repeated = repeatedSinceZeroing(pos);
+		std::vector<int> ranks;
+		StateInfo st;
+		for (const Move m : moves) {
+			ProbeState state;
+			pos.doMove(m, st);
+			int dtz;
+			if (pos.rule50Count() == 0)
+				dtz = dtzBeforeZeroing(static_cast<WDLScore>(-probeWdl(pos, state)));
+			else if (pos.isDraw(1))
+				dtz = 0;
+			else {
+				dtz = -probeDtz(pos, state);
+				dtz = dtz > 0 ? dtz + 1 : dtz < 0 ? dtz - 1 : dtz;
+			}
+
+			// A mating move always has distance 1
+			if (pos.checkers() && dtz == 2) {
+				MoveList replies;
+				generate<LEGAL>(pos, replies);
+				if (replies.empty())
+					dtz = 1;
+			}
+			pos.undoMove(m);
+			if (state == PROBE_FAIL)
+				return false;
+
+			ranks.push_back(dtz > 0 ? (dtz + rule50 <= 99 && !repeated ? 1000 : 1000 - (dtz + rule50))
+				: dtz < 0 ? (-dtz * 2 + rule50 < 100 ? -1000 : -1000 + (-dtz + rule50))
+				: 0);
+		}
+		return keepBestRanked(moves, ranks);
+	}
+
+	bool filterRootMovesWdl(Position& pos, std::vector<Move>& moves) {
+		if (moves.empty())
+			return false;
+
+		constexpr std::array<int, 5> WDL_RANK = { -1000, -899, 0, 899, 1000 };
+		std::vector<int> ranks;
+		StateInfo st;
+		for (const Move m : moves) {
+			ProbeState state;
+			pos.doMove(m, st);
+			const WDLScore wdl = static_cast<WDLScore>(-probeWdl(pos, state));
+			pos.undoMove(m);
+			if (state == PROBE_FAIL)
+				return false;
+			ranks.push_back(WDL_RANK[wdl + 2]);
+		}
+		return keepBestRanked(moves, ranks);
+	}
+
+	ProbeStats stats() {
+		ProbeStats s;
+		s.wdlProbes = g_wdlProbes.load(std::memory_order_relaxed);
+		s.dtzProbes = g_dtzProbes.load(std::memory_order_relaxed);
+		s.failures = g_failures.load(std::memory_order_relaxed);
+		s.nanoseconds = g_nanoseconds.load(std::memory_order_relaxed);
+		return s;
+	}
+
+	void clearStats() {
+		g_wdlProbes.store(0, std::memory_order_relaxed);
+		g_dtzProbes.store(0, std::memory_order_relaxed);
+		g_failures.store(0, std::memory_order_relaxed);
+		g_nanoseconds.store(0, std::memory_order_relaxed);
+	}
+}
+#pragma warning(pop)
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Move.h"
+#include "Position.h"
+#include "Types.h"
+
+// Tablebases.h - Syzygy WDL and DTZ tablebase probing from memory-mapped table files
+
+namespace chess::tablebases {
+
+	// Win/draw/loss from the side to move's point of view. Cursed wins and blessed losses
+	// are won or lost without the 50-move rule and drawn with it
+	enum WDLScore : int {
+		WDL_LOSS = -2,
+		WDL_BLESSED_LOSS = -1,
+		WDL_DRAW = 0,
+		WDL_CURSED_WIN = 1,
+		WDL_WIN = 2
+	};
+
+	enum ProbeState : int {
+		PROBE_CHANGE_STM = -1,     // DTZ table stores the other side to move, internal to the prober
+		PROBE_FAIL = 0,            // Table missing or corrupt
+		PROBE_OK = 1,
+		PROBE_ZEROING_BEST_MOVE = 2  // Best move resets the 50-move counter
+	};
+
+	// Largest number of pieces the prober handles
+	constexpr int MAX_PIECES = 7;
+
+	// Probe counts and time spent probing since the last clearStats, over all threads
+	struct ProbeStats {
+		uint64_t wdlProbes = 0;
+		uint64_t dtzProbes = 0;
+		uint64_t failures = 0;
+		uint64_t nanoseconds = 0;
+
+		[[nodiscard]] double averageMicroseconds() const {
+			const uint64_t probes = wdlProbes + dtzProbes;
+			return probes ? static_cast<double>(nanoseconds) / 1000.0 / static_cast<double>(probes) : 0.0;
+		}
+	};
+
+	// Finds the tables in the directories of paths (separated by ';' on Windows and ':' elsewhere),
+	// after Position::init. Files are only mapped when first probed. An empty path unloads everything.
+	// Must not be called while searching
+	void init(const std::string& paths);
+
+	// Most pieces of any table found, 0 without tables
+	[[nodiscard]] int maxCardinality();
+
+	// Win/draw/loss of the position, it must have no castling rights
+	[[nodiscard]] WDLScore probeWdl(Position& pos, ProbeState& state);
+
+	// Plies to the next capture or pawn move with best play, signed like the WDL result: 1 for a win
+	// by a zeroing move now, 101 for a cursed win by one, -1 when mated, 0 for a draw. Winning
+	// positions may return one ply more than the exact distance
+	[[nodiscard]] int probeDtz(Position& pos, ProbeState& state);
+
+	// Keeps only the root moves that preserve the best DTZ result, taking the 50-move rule and earlier
+	// repetitions into account. Returns false and leaves moves alone if a table is missing
+	bool filterRootMoves(Position& pos, std::vector<Move>& moves);
+
+	// As filterRootMoves with WDL tables only, used when DTZ tables are missing
+	bool filterRootMovesWdl(Position& pos, std::vector<Move>& moves);
+
+	[[nodiscard]] ProbeStats stats();
+	void clearStats();
+}
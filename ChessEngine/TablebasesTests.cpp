@@ -0,0 +1,694 @@
+#include "TablebasesTests.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "BitBoard.h"
+#include "Endgame.h"
+#include "MagicBB.h"
+#include "MoveGen.h"
+#include "Position.h"
+#include "Tablebases.h"
+#include "ThreadPool.h"
+#include "TranspositionTable.h"
+#include "Types.h"
+#include "Uci.h"
+
+// TablebasesTests.cpp - Tests for the Syzygy prober on generated KRvK table files, single valued and
+// Huffman compressed from a retrograde solution
+
+namespace chess::tests
+{
+	namespace {
+		std::filesystem::path sampleDirectory() {
+			return std::filesystem::temp_directory_path() / "chess_syzygy_test";
+		}
+
+		// Writes a table whose values are the same for every position of a side to move, padded to the
+		// 64n + 16 bytes of a real file. Pieces are in the file's encoding order: white king, rook, black king
+		void writeSampleTable(const std::string& name, const std::vector<uint8_t>& magic, const std::vector<uint8_t>& sizes) {
+			std::vector<uint8_t> bytes = magic;
+			const std::vector<uint8_t> layout = { 0x01, 0x00, 0x66, 0x44, 0xEE, 0x00 };
+			bytes.insert(bytes.end(), layout.begin(), layout.end());
+			bytes.insert(bytes.end(), sizes.begin(), sizes.end());
+			bytes.resize(80);
+			std::ofstream(sampleDirectory() / name, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		}
+
+		// KRvK tables claiming a win for the rook with white to move and a loss with black to move, which
+		// a single value per side can store. DTZ is 5 moves, stored for white to move. KQvK is corrupt
+		void writeSampleTables(const bool withDtz) {
+			std::filesystem::create_directories(sampleDirectory());
+			constexpr uint8_t SINGLE_VALUE = 0x80;
+			writeSampleTable("KRvK.rtbw", { 0x71, 0xE8, 0x23, 0x5D }, { SINGLE_VALUE, tablebases::WDL_WIN + 2, SINGLE_VALUE, tablebases::WDL_LOSS + 2 });
+			if (withDtz)
+				writeSampleTable("KRvK.rtbz", { 0xD7, 0x66, 0x0C, 0xA5 }, { SINGLE_VALUE, 5 });
+			writeSampleTable("KQvK.rtbw", { 'n', 'o', 'n', 'e' }, { SINGLE_VALUE, tablebases::WDL_WIN + 2, SINGLE_VALUE, tablebases::WDL_LOSS + 2 });
+			tablebases::init(sampleDirectory().string());
+		}
+
+		void removeSampleTables() {
+			tablebases::init("");
+			std::error_code ec;
+			std::filesystem::remove_all(sampleDirectory(), ec);
+		}
+
+		// KRvK solved backwards from the mates, by (white king * 64 + rook) * 64 + black king:
+		// plies to mate for the rook's side, KRK_DRAW or KRK_ILLEGAL
+		constexpr int8_t KRK_DRAW = -1;
+		constexpr int8_t KRK_ILLEGAL = -2;
+		constexpr int8_t KRK_UNKNOWN = -3;
+
+		struct KrkSolution {
+			std::vector<int8_t> whiteToMove;
+			std::vector<int8_t> blackToMove;
+		};
+
+		size_t krkIndex(const Square wk, const Square wr, const Square bk) {
+			return (static_cast<size_t>(wk) * SQUARE_NB + wr) * SQUARE_NB + bk;
+		}
+
+		KrkSolution solveKrk() {
+			constexpr size_t SIZE = static_cast<size_t>(SQUARE_NB) * SQUARE_NB * SQUARE_NB;
+			KrkSolution krk{ std::vector<int8_t>(SIZE, KRK_ILLEGAL), std::vector<int8_t>(SIZE, KRK_ILLEGAL) };
+			const auto& kingAttacks = g_pseudoAttacks[KING];
+
+			// Black king moves that are legal, the rook counts as a target only when it can be taken
+			const auto blackMoves = [&](const Square wk, const Square wr, const Square bk) {
+				return kingAttacks[bk] & ~kingAttacks[wk] & ~getRookAttacks(wr, squareToBB(wk)) & ~(kingAttacks[wk] & squareToBB(wr));
+			};
+
+			for (Square wk = A1; wk <= H8; ++wk)
+				for (Square wr = A1; wr <= H8; ++wr)
+					for (Square bk = A1; bk <= H8; ++bk) {
+						if (wk == wr || wr == bk || g_squareDistance[wk][bk] <= 1)
+							continue;
+						const size_t i = krkIndex(wk, wr, bk);
+						const bool check = getRookAttacks(wr, squareToBB(wk) | squareToBB(bk)) & squareToBB(bk);
+						krk.whiteToMove[i] = check ? KRK_ILLEGAL : KRK_UNKNOWN;
+						const Bitboard moves = blackMoves(wk, wr, bk);
+						krk.blackToMove[i] = moves & squareToBB(wr) ? KRK_DRAW : moves ? KRK_UNKNOWN : check ? 0 : KRK_DRAW;
+					}
+
+			// White wins in n plies with a move to a loss in n - 1, black loses in n when every move goes
+			// to a win and the longest takes n - 1. Stops after a white and a black pass found nothing
+			bool found = true;
+			for (int8_t n = 1; found || n % 2 == 0; ++n) {
+				if (n % 2)
+					found = false;
+				for (Square wk = A1; wk <= H8; ++wk)
+					for (Square wr = A1; wr <= H8; ++wr)
+						for (Square bk = A1; bk <= H8; ++bk) {
+							const size_t i = krkIndex(wk, wr, bk);
+							if (n % 2 && krk.whiteToMove[i] == KRK_UNKNOWN) {
+								bool mates = false;
+								Bitboard b = kingAttacks[wk] & ~kingAttacks[bk] & ~squareToBB(wr);
+								while (b && !mates)
+									mates = krk.blackToMove[krkIndex(popLsb(b), wr, bk)] == n - 1;
+								b = getRookAttacks(wr, squareToBB(wk) | squareToBB(bk)) & ~squareToBB(wk) & ~squareToBB(bk);
+								while (b && !mates)
+									mates = krk.blackToMove[krkIndex(wk, popLsb(b), bk)] == n - 1;
+								if (mates) {
+									krk.whiteToMove[i] = n;
+									found = true;
+								}
+							}
+							else if (n % 2 == 0 && krk.blackToMove[i] == KRK_UNKNOWN) {
+								int8_t longest = 0;
+								Bitboard b = blackMoves(wk, wr, bk);
+								while (b && longest >= 0) {
+									const int8_t v = krk.whiteToMove[krkIndex(wk, wr, popLsb(b))];
+									longest = v < 0 ? KRK_UNKNOWN : std::max(longest, v);
+								}
+								if (longest == n - 1) {
+									krk.blackToMove[i] = n;
+									found = true;
+								}
+							}
+						}
+			}
+			return krk;
+		}
+
+		// Table index of a KRvK position in the Syzygy encoding of three unique pieces, ordered white king,
+		// rook, black king. The board is mirrored so the white king is in the a1-d1-d4 triangle and the
+		// first piece off the a1-h8 diagonal is below it
+		uint64_t krkTableIndex(const Square wk, const Square wr, const Square bk) {
+			const auto diagonal = [](const Square sq) { return static_cast<int>(rankOf(sq)) - static_cast<int>(fileOf(sq)); };
+			std::array<Square, 3> sq = { wk, wr, bk };
+			if (fileOf(sq[0]) > FILE_D)
+				for (Square& s : sq)
+					s = flipFile(s);
+			if (rankOf(sq[0]) > RANK_4)
+				for (Square& s : sq)
+					s = flipRank(s);
+			for (size_t i = 0; i < sq.size(); ++i) {
+				if (!diagonal(sq[i]))
+					continue;
+				if (diagonal(sq[i]) > 0)
+					for (size_t j = i; j < sq.size(); ++j)
+						sq[j] = static_cast<Square>(((sq[j] >> 3) | (sq[j] << 3)) & 63);
+				break;
+			}
+
+			// Squares below the diagonal numbered upwards; in the triangle b1-d1-d3 first, then a1-d4
+			const auto below = [&](const Square s) {
+				int n = 0;
+				for (Square t = A1; t < s; ++t)
+					n += diagonal(t) < 0;
+				return n;
+			};
+			const auto triangle = [&](const Square s) {
+				constexpr std::array<Square, 6> BELOW = { B1, C1, D1, C2, D2, D3 };
+				return diagonal(s) ? static_cast<int>(std::find(BELOW.begin(), BELOW.end(), s) - BELOW.begin()) : 6 + static_cast<int>(fileOf(s));
+			};
+			const int adjust1 = sq[1] > sq[0];
+			const int adjust2 = (sq[2] > sq[0]) + (sq[2] > sq[1]);
+			if (diagonal(sq[0]))
+				return (triangle(sq[0]) * 63 + (sq[1] - adjust1)) * 62 + sq[2] - adjust2;
+			if (diagonal(sq[1]))
+				return (6 * 63 + rankOf(sq[0]) * 28 + below(sq[1])) * 62 + sq[2] - adjust2;
+			if (diagonal(sq[2]))
+				return 6 * 63 * 62 + 4 * 28 * 62 + rankOf(sq[0]) * 7 * 28 + (rankOf(sq[1]) - adjust1) * 28 + below(sq[2]);
+			return 6 * 63 * 62 + 4 * 28 * 62 + 4 * 7 * 28 + rankOf(sq[0]) * 7 * 6 + (rankOf(sq[1]) - adjust1) * 6 + (rankOf(sq[2]) - adjust2);
+		}
+
+		// The parts of a file describing one side to move, in the order the prober lays them out
+		struct PairsSide {
+			std::vector<uint8_t> sizes;
+			std::vector<uint8_t> sparseIndex;
+			std::vector<uint8_t> blockLengths;
+			std::vector<uint8_t> blocks;
+		};
+
+		template<typename T>
+		void appendLE(std::vector<uint8_t>& out, const T v) {
+			for (size_t i = 0; i < sizeof(T); ++i)
+				out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+		}
+
+		// Compresses values like the table generator: the most frequent adjacent symbols are paired into
+		// new symbols, which get canonical Huffman codes (longer codes lower) packed into 32-byte blocks,
+		// with a sparse index entry every 64 values
+		PairsSide compressPairs(const std::vector<uint8_t>& values, const uint8_t flags) {
+			constexpr int BLOCK_BITS = 5;
+			constexpr int SPAN_BITS = 6;
+			struct Symbol {
+				int left;    // Value of a leaf
+				int right;   // 0xFFF for a leaf
+				int length;  // Values it expands to
+			};
+			std::vector<Symbol> symbols;
+			std::array<int, 256> leafOf;
+			leafOf.fill(-1);
+			std::vector<int> seq;
+			for (const uint8_t v : values) {
+				if (leafOf[v] < 0) {
+					leafOf[v] = static_cast<int>(symbols.size());
+					symbols.push_back({ v, 0xFFF, 1 });
+				}
+				seq.push_back(leafOf[v]);
+			}
+
+			for (int round = 0; round < 64; ++round) {
+				std::map<std::pair<int, int>, int> counts;
+				for (size_t i = 0; i + 1 < seq.size(); ++i)
+					++counts[{ seq[i], seq[i + 1] }];
+				std::pair<int, int> best{ -1, -1 };
+				int bestCount = 8;
+				for (const auto& [pair, count] : counts)
+					if (count > bestCount && symbols[pair.first].length + symbols[pair.second].length <= 64) {
+						best = pair;
+						bestCount = count;
+					}
+				if (best.first < 0)
+					break;
+				const int sym = static_cast<int>(symbols.size());
+				symbols.push_back({ best.first, best.second, symbols[best.first].length + symbols[best.second].length });
+				std::vector<int> paired;
+				for (size_t i = 0; i < seq.size(); ++i)
+					if (i + 1 < seq.size() && seq[i] == best.first && seq[i + 1] == best.second) {
+						paired.push_back(sym);
+						++i;
+					}
+					else
+						paired.push_back(seq[i]);
+				seq = std::move(paired);
+			}
+
+			// Huffman code lengths of the symbols left in the sequence
+			std::vector<uint64_t> weight(symbols.size());
+			for (const int sym : seq)
+				++weight[sym];
+			std::vector<int> parent(symbols.size(), -1);
+			using Node = std::pair<uint64_t, int>;
+			std::priority_queue<Node, std::vector<Node>, std::greater<>> queue;
+			for (size_t sym = 0; sym < symbols.size(); ++sym)
+				if (weight[sym])
+					queue.emplace(weight[sym], static_cast<int>(sym));
+			while (queue.size() > 1) {
+				const Node a = queue.top();
+				queue.pop();
+				const Node b = queue.top();
+				queue.pop();
+				parent.push_back(-1);
+				parent[a.second] = parent[b.second] = static_cast<int>(parent.size()) - 1;
+				queue.emplace(a.first + b.first, static_cast<int>(parent.size()) - 1);
+			}
+			std::vector<int> codeLength(symbols.size());
+			for (size_t sym = 0; sym < symbols.size(); ++sym)
+				for (int node = parent[sym]; weight[sym] && node >= 0; node = parent[node])
+					++codeLength[sym];
+
+			// Symbols are renumbered longest code first, the unused ones last
+			std::vector<int> order(symbols.size());
+			for (size_t i = 0; i < order.size(); ++i)
+				order[i] = static_cast<int>(i);
+			std::stable_sort(order.begin(), order.end(), [&](const int a, const int b) {
+				return (codeLength[a] ? codeLength[a] : -1) > (codeLength[b] ? codeLength[b] : -1);
+				});
+			std::vector<int> id(symbols.size());
+			for (size_t i = 0; i < order.size(); ++i)
+				id[order[i]] = static_cast<int>(i);
+			const int maxLength = codeLength[order.front()];
+			int minLength = maxLength;
+			for (const int sym : order)
+				if (codeLength[sym])
+					minLength = std::min(minLength, codeLength[sym]);
+
+			std::vector<int> count(static_cast<size_t>(maxLength) + 1);
+			for (const int sym : order)
+				++count[codeLength[sym]];
+			std::vector<int> lowest(count.size());
+			std::vector<uint64_t> base(count.size());
+			for (int len = maxLength - 1; len >= minLength; --len) {
+				lowest[len] = lowest[len + 1] + count[len + 1];
+				base[len] = (base[len + 1] + count[len + 1]) / 2;
+			}
+
+			PairsSide side;
+			std::vector<uint8_t> block(size_t{ 1 } << BLOCK_BITS);
+			std::vector<uint64_t> blockStarts = { 0 };
+			size_t bit = 0;
+			uint64_t valuesSeen = 0;
+			const auto flush = [&]() {
+				side.blocks.insert(side.blocks.end(), block.begin(), block.end());
+				std::fill(block.begin(), block.end(), uint8_t{ 0 });
+				appendLE(side.blockLengths, static_cast<uint16_t>(valuesSeen - blockStarts.back() - 1));
+				blockStarts.push_back(valuesSeen);
+				bit = 0;
+			};
+			for (const int sym : seq) {
+				const int len = codeLength[sym];
+				if (bit + len > 8 * block.size())
+					flush();
+				const uint64_t code = base[len] + static_cast<uint64_t>(id[sym] - lowest[len]);
+				for (int b = len - 1; b >= 0; --b, ++bit)
+					block[bit / 8] |= static_cast<uint8_t>(((code >> b) & 1) << (7 - bit % 8));
+				valuesSeen += symbols[sym].length;
+			}
+			flush();
+			blockStarts.pop_back();
+
+			// Entry k locates value k * span + span / 2 as a block and an offset into it
+			constexpr uint64_t SPAN = uint64_t{ 1 } << SPAN_BITS;
+			for (uint64_t k = 0; k * SPAN < values.size(); ++k) {
+				const uint64_t target = k * SPAN + SPAN / 2;
+				const auto at = std::upper_bound(blockStarts.begin(), blockStarts.end(), target) - blockStarts.begin() - 1;
+				appendLE(side.sparseIndex, static_cast<uint32_t>(at));
+				appendLE(side.sparseIndex, static_cast<uint16_t>(target - blockStarts[at]));
+			}
+
+			side.sizes = { flags, BLOCK_BITS, SPAN_BITS, 0 };
+			appendLE(side.sizes, static_cast<uint32_t>(blockStarts.size()));
+			side.sizes.push_back(static_cast<uint8_t>(maxLength));
+			side.sizes.push_back(static_cast<uint8_t>(minLength));
+			for (int len = minLength; len <= maxLength; ++len)
+				appendLE(side.sizes, static_cast<uint16_t>(lowest[len]));
+			appendLE(side.sizes, static_cast<uint16_t>(symbols.size()));
+			for (const int sym : order) {
+				const int left = symbols[sym].right == 0xFFF ? symbols[sym].left : id[symbols[sym].left];
+				const int right = symbols[sym].right == 0xFFF ? 0xFFF : id[symbols[sym].right];
+				side.sizes.push_back(static_cast<uint8_t>(left));
+				side.sizes.push_back(static_cast<uint8_t>((left >> 8) | ((right & 0xF) << 4)));
+				side.sizes.push_back(static_cast<uint8_t>(right >> 4));
+			}
+			if (symbols.size() & 1)
+				side.sizes.push_back(0);
+			return side;
+		}
+
+		// Writes a KRvK file with the sides of a compressed table, aligned and padded as the prober expects
+		void writeCompressedTable(const std::string& name, const std::vector<uint8_t>& magic, const std::vector<PairsSide>& sides, const bool dtz) {
+			std::vector<uint8_t> bytes = magic;
+			const std::vector<uint8_t> layout = { 0x01, 0x00, 0x66, 0x44, 0xEE, 0x00 };
+			bytes.insert(bytes.end(), layout.begin(), layout.end());
+			for (const PairsSide& side : sides)
+				bytes.insert(bytes.end(), side.sizes.begin(), side.sizes.end());
+			if (dtz && bytes.size() % 2)
+				bytes.push_back(0);
+			for (const PairsSide& side : sides)
+				bytes.insert(bytes.end(), side.sparseIndex.begin(), side.sparseIndex.end());
+			for (const PairsSide& side : sides)
+				bytes.insert(bytes.end(), side.blockLengths.begin(), side.blockLengths.end());
+			for (const PairsSide& side : sides) {
+				bytes.resize((bytes.size() + 63) & ~size_t{ 63 });
+				bytes.insert(bytes.end(), side.blocks.begin(), side.blocks.end());
+			}
+			bytes.resize(bytes.size() + 8);
+			bytes.resize((bytes.size() + 47) / 64 * 64 + 16);
+			std::ofstream(sampleDirectory() / name, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		}
+
+		// KRvK tables from the solution: WDL white to move is a single win, black to move and DTZ white
+		// to move (in moves, as (plies - 1) / 2) are compressed. Unused indices repeat the value before
+		void writeCompressedTables(const KrkSolution& krk) {
+			std::filesystem::create_directories(sampleDirectory());
+			constexpr uint64_t TABLE_SIZE = 31332;
+			std::vector<int> wdl(TABLE_SIZE, -1);
+			std::vector<int> dtz(TABLE_SIZE, -1);
+			for (Square wk = A1; wk <= H8; ++wk)
+				for (Square wr = A1; wr <= H8; ++wr)
+					for (Square bk = A1; bk <= H8; ++bk) {
+						const size_t i = krkIndex(wk, wr, bk);
+						const uint64_t idx = krkTableIndex(wk, wr, bk);
+						if (krk.blackToMove[i] != KRK_ILLEGAL)
+							wdl[idx] = (krk.blackToMove[i] == KRK_DRAW ? tablebases::WDL_DRAW : tablebases::WDL_LOSS) + 2;
+						if (krk.whiteToMove[i] > 0)
+							dtz[idx] = (krk.whiteToMove[i] - 1) / 2;
+					}
+			std::vector<uint8_t> wdlValues, dtzValues;
+			for (uint64_t idx = 0; idx < TABLE_SIZE; ++idx) {
+				wdlValues.push_back(static_cast<uint8_t>(wdl[idx] >= 0 ? wdl[idx] : idx ? wdlValues.back() : tablebases::WDL_LOSS + 2));
+				dtzValues.push_back(static_cast<uint8_t>(dtz[idx] >= 0 ? dtz[idx] : idx ? dtzValues.back() : 0));
+			}
+
+			constexpr uint8_t SINGLE_VALUE = 0x80;
+			const PairsSide whiteWins = { { SINGLE_VALUE, tablebases::WDL_WIN + 2 }, {}, {}, {} };
+			writeCompressedTable("KRvK.rtbw", { 0x71, 0xE8, 0x23, 0x5D }, { whiteWins, compressPairs(wdlValues, 0) }, false);
+			writeCompressedTable("KRvK.rtbz", { 0xD7, 0x66, 0x0C, 0xA5 }, { compressPairs(dtzValues, 0) }, true);
+			tablebases::init(sampleDirectory().string());
+		}
+
+		using Placement = std::vector<std::pair<char, Square>>;
+
+		// Sets up the pieces, given by their FEN letters, with stm to move. False when two share a square
+		// or the side not to move is in check
+		bool setPlacement(Position& pos, const Placement& pieces, const Color stm) {
+			std::string fen;
+			for (int rank = RANK_8; rank >= RANK_1; --rank) {
+				int empty = 0;
+				for (int file = FILE_A; file <= FILE_H; ++file) {
+					const Square sq = makeSquare(static_cast<File>(file), static_cast<Rank>(rank));
+					const auto it = std::find_if(pieces.begin(), pieces.end(), [sq](const auto& p) { return p.second == sq; });
+					if (it == pieces.end())
+						++empty;
+					else {
+						if (empty)
+							fen += static_cast<char>('0' + empty);
+						fen += it->first;
+						empty = 0;
+					}
+				}
+				if (empty)
+					fen += static_cast<char>('0' + empty);
+				if (rank > RANK_1)
+					fen += '/';
+			}
+			for (size_t i = 0; i < pieces.size(); ++i)
+				for (size_t j = 0; j < i; ++j)
+					if (pieces[i].second == pieces[j].second)
+						return false;
+			pos.set(fen + (stm == WHITE ? " w - - 0 1" : " b - - 0 1"));
+			return !(pos.attackersTo(pos.kingSquare(~stm)) & pos.pieces(stm));
+		}
+
+		// Value of an environment variable, empty when it is not set
+		std::string environmentVariable(const char* name) {
+#ifdef _WIN32
+			char* value = nullptr;
+			size_t size = 0;
+			if (_dupenv_s(&value, &size, name) || !value)
+				return {};
+			const std::string result(value);
+			free(value);
+			return result;
+#else
+			const char* value = std::getenv(name);
+			return value ? value : "";
+#endif
+		}
+
+		bool rookIsAttacked(Position& pos, const Move m) {
+			StateInfo st;
+			pos.doMove(m, st);
+			MoveList replies;
+			generate<LEGAL>(pos, replies);
+			bool attacked = false;
+			for (const ScoredMove& sm : replies)
+				attacked |= pos.capture(sm.move());
+			pos.undoMove(m);
+			return attacked;
+		}
+	}
+
+	// Test WDL and DTZ values, including positions with the colors flipped and captures searched before the table
+	void testTablebaseProbes() {
+		bool success = true;
+		writeSampleTables(true);
+		success &= (tablebases::maxCardinality() == 3);
+		tablebases::clearStats();
+
+		Position pos;
+		tablebases::ProbeState state;
+		pos.set("8/8/8/8/4k3/8/8/R3K3 w - - 0 1");
+		success &= (tablebases::probeWdl(pos, state) == tablebases::WDL_WIN && state != tablebases::PROBE_FAIL);
+		success &= (tablebases::probeDtz(pos, state) == 11 && state != tablebases::PROBE_FAIL);
+
+		// The other side to move is not stored in the DTZ table, it is found one ply further
+		pos.set("8/8/8/8/4k3/8/8/R3K3 b - - 0 1");
+		success &= (tablebases::probeWdl(pos, state) == tablebases::WDL_LOSS && state != tablebases::PROBE_FAIL);
+		success &= (tablebases::probeDtz(pos, state) == -12 && state != tablebases::PROBE_FAIL);
+
+		// Black owning the rook reads the table with the colors swapped
+		pos.set("r3k3/8/8/8/8/4K3/8/8 b - - 0 1");
+		success &= (tablebases::probeWdl(pos, state) == tablebases::WDL_WIN && state != tablebases::PROBE_FAIL);
+		pos.set("r3k3/8/8/8/8/4K3/8/8 w - - 0 1");
+		success &= (tablebases::probeWdl(pos, state) == tablebases::WDL_LOSS && state != tablebases::PROBE_FAIL);
+
+		// Taking the hanging rook draws whatever the table says
+		pos.set("8/8/8/8/8/8/1k6/R6K b - - 0 1");
+		success &= (tablebases::probeWdl(pos, state) == tablebases::WDL_DRAW && state == tablebases::PROBE_OK);
+
+		// Bare kings need no table, a corrupt or missing table fails
+		pos.set("8/8/8/8/4k3/8/8/4K3 w - - 0 1");
+		success &= (tablebases::probeWdl(pos, state) == tablebases::WDL_DRAW && state != tablebases::PROBE_FAIL);
+		pos.set("8/8/8/8/4k3/8/8/Q3K3 w - - 0 1");
+		(void)tablebases::probeWdl(pos, state);
+		success &= (state == tablebases::PROBE_FAIL);
+		pos.set("8/8/8/8/4k3/8/8/N3K3 w - - 0 1");
+		(void)tablebases::probeWdl(pos, state);
+		success &= (state == tablebases::PROBE_FAIL);
+
+		const tablebases::ProbeStats stats = tablebases::stats();
+		success &= (stats.wdlProbes >= 8 && stats.dtzProbes == 2 && stats.failures == 2);
+
+		removeSampleTables();
+		report("Tablebase probes", success);
+	}
+
+	// Test WDL and DTZ values decoded from Huffman compressed tables against the retrograde solution,
+	// over a spread of positions reaching every block, and a few known KRvK results
+	void testTablebaseCompressed() {
+		const KrkSolution krk = solveKrk();
+		int8_t longestMate = 0;
+		for (const int8_t plies : krk.whiteToMove)
+			longestMate = std::max(longestMate, plies);
+		bool success = longestMate == 31;  // Mate in 16 moves
+
+		writeCompressedTables(krk);
+		Position pos;
+		tablebases::ProbeState state;
+		for (size_t i = 0; i < krk.whiteToMove.size(); i += 37) {
+			const Square wk = static_cast<Square>(i / (SQUARE_NB * SQUARE_NB));
+			const Square wr = static_cast<Square>(i / SQUARE_NB % SQUARE_NB);
+			const Square bk = static_cast<Square>(i % SQUARE_NB);
+			if (krk.whiteToMove[i] > 0) {
+				setPlacement(pos, { { 'K', wk }, { 'R', wr }, { 'k', bk } }, WHITE);
+				success &= tablebases::probeWdl(pos, state) == tablebases::WDL_WIN && state != tablebases::PROBE_FAIL;
+				success &= tablebases::probeDtz(pos, state) == krk.whiteToMove[i] && state != tablebases::PROBE_FAIL;
+			}
+			if (krk.blackToMove[i] != KRK_ILLEGAL) {
+				setPlacement(pos, { { 'K', wk }, { 'R', wr }, { 'k', bk } }, BLACK);
+				const bool draw = krk.blackToMove[i] == KRK_DRAW;
+				success &= tablebases::probeWdl(pos, state) == (draw ? tablebases::WDL_DRAW : tablebases::WDL_LOSS) && state != tablebases::PROBE_FAIL;
+				if (!draw)
+					success &= tablebases::probeDtz(pos, state) == -std::max<int>(krk.blackToMove[i], 1) && state != tablebases::PROBE_FAIL;
+			}
+		}
+
+		// Mate in one, stalemate and a loss in 2 moves for black
+		pos.set("k7/8/1K6/8/8/8/8/7R w - - 0 1");
+		success &= tablebases::probeDtz(pos, state) == 1 && state != tablebases::PROBE_FAIL;
+		pos.set("k7/1R6/2K5/8/8/8/8/8 b - - 0 1");
+		success &= tablebases::probeWdl(pos, state) == tablebases::WDL_DRAW && state == tablebases::PROBE_OK;
+		pos.set("1k6/8/1K6/8/8/8/8/7R b - - 0 1");
+		success &= tablebases::probeWdl(pos, state) == tablebases::WDL_LOSS && tablebases::probeDtz(pos, state) == -4;
+
+		removeSampleTables();
+		report("Tablebase compressed tables", success);
+	}
+
+	// Test real tables from the directory in SYZYGY_PATH, which must hold the 3-piece tables and KQvKR:
+	// KRvK against the retrograde solution, KPvK against the KPK bitbase, KBvK and KNvK drawn, and
+	// KQvKR agreeing with a one ply search into itself and the 3-piece tables. Skipped when unset
+	void testTablebaseRealFiles() {
+		const std::string path = environmentVariable("SYZYGY_PATH");
+		if (path.empty()) {
+			std::cout << "    Skipping real tables: SYZYGY_PATH is not set" << "\n";
+			return;
+		}
+		tablebases::init(path);
+		bool success = tablebases::maxCardinality() >= 4;
+		Position pos;
+		tablebases::ProbeState state;
+
+		// Exact WDL, the DTZ may be one ply longer than the distance to mate
+		const KrkSolution krk = solveKrk();
+		for (size_t i = 0; i < krk.whiteToMove.size(); i += 7) {
+			const Placement pieces = { { 'K', static_cast<Square>(i / (SQUARE_NB * SQUARE_NB)) },
+				{ 'R', static_cast<Square>(i / SQUARE_NB % SQUARE_NB) }, { 'k', static_cast<Square>(i % SQUARE_NB) } };
+			if (krk.whiteToMove[i] > 0 && setPlacement(pos, pieces, WHITE)) {
+				const int dtz = tablebases::probeDtz(pos, state);
+				success &= tablebases::probeWdl(pos, state) == tablebases::WDL_WIN && (dtz == krk.whiteToMove[i] || dtz == krk.whiteToMove[i] + 1);
+			}
+			if (krk.blackToMove[i] != KRK_ILLEGAL && setPlacement(pos, pieces, BLACK)) {
+				const bool draw = krk.blackToMove[i] == KRK_DRAW;
+				const int plies = std::max<int>(krk.blackToMove[i], 1);
+				const int dtz = tablebases::probeDtz(pos, state);
+				success &= tablebases::probeWdl(pos, state) == (draw ? tablebases::WDL_DRAW : tablebases::WDL_LOSS);
+				success &= draw ? dtz == 0 : dtz == -plies || dtz == -plies - 1;
+			}
+		}
+
+		for (Square wk = A1; wk <= H8; ++wk)
+			for (Square pawn = A2; pawn <= H7; ++pawn)
+				for (Square bk = A1; bk <= H8; ++bk)
+					for (const Color stm : { WHITE, BLACK }) {
+						if (fileOf(pawn) > FILE_D || !setPlacement(pos, { { 'K', wk }, { 'P', pawn }, { 'k', bk } }, stm))
+							continue;
+						const tablebases::WDLScore expected = !endgames::probeKPK(wk, pawn, bk, stm) ? tablebases::WDL_DRAW
+							: stm == WHITE ? tablebases::WDL_WIN : tablebases::WDL_LOSS;
+						success &= tablebases::probeWdl(pos, state) == expected;
+					}
+
+		std::mt19937 rng(1);
+		const auto randomSquare = [&rng]() { return static_cast<Square>(rng() % SQUARE_NB); };
+		for (int i = 0; i < 1000; ++i) {
+			const Color stm = static_cast<Color>(i & 1);
+			if (setPlacement(pos, { { 'K', randomSquare() }, { i & 2 ? 'B' : 'N', randomSquare() }, { 'k', randomSquare() } }, stm))
+				success &= tablebases::probeWdl(pos, state) == tablebases::WDL_DRAW;
+		}
+
+		// Compared by sign, the 50-move rule aside
+		const auto sign = [](const int v) { return (v > 0) - (v < 0); };
+		int wins = 0;
+		int draws = 0;
+		for (int i = 0; i < 1000; ++i) {
+			const Color stm = static_cast<Color>(i & 1);
+			if (!setPlacement(pos, { { 'K', randomSquare() }, { 'Q', randomSquare() }, { 'k', randomSquare() }, { 'r', randomSquare() } }, stm))
+				continue;
+			MoveList moves;
+			generate<LEGAL>(pos, moves);
+			if (moves.empty())
+				continue;
+			int best = -1;
+			for (const ScoredMove& sm : moves) {
+				StateInfo st;
+				pos.doMove(sm.move(), st);
+				best = std::max(best, -sign(tablebases::probeWdl(pos, state)));
+				success &= state != tablebases::PROBE_FAIL;
+				pos.undoMove(sm.move());
+			}
+			const int wdl = sign(tablebases::probeWdl(pos, state));
+			success &= wdl == best && state != tablebases::PROBE_FAIL;
+			wins += stm == WHITE && wdl > 0;
+			draws += stm == WHITE && wdl == 0;
+		}
+		success &= wins > draws;
+
+		tablebases::init("");
+		report("Tablebase real files", success);
+	}
+
+	// Test that root moves giving up the rook are dropped, by DTZ and with WDL tables only
+	void testTablebaseRootFilter() {
+		bool success = true;
+		Position pos;
+		pos.set("8/8/8/8/8/1k6/8/R3K3 w - - 3 1");
+		MoveList legalMoves;
+		generate<LEGAL>(pos, legalMoves);
+
+		for (const bool withDtz : { true, false }) {
+			writeSampleTables(withDtz);
+			std::vector<Move> moves;
+			for (const ScoredMove& sm : legalMoves)
+				moves.push_back(sm.move());
+			success &= (withDtz ? tablebases::filterRootMoves(pos, moves) : !tablebases::filterRootMoves(pos, moves) && tablebases::filterRootMovesWdl(pos, moves));
+			success &= (!moves.empty() && moves.size() < static_cast<size_t>(legalMoves.size()));
+			for (const ScoredMove& sm : legalMoves) {
+				const bool kept = std::find(moves.begin(), moves.end(), sm.move()) != moves.end();
+				success &= (kept != rookIsAttacked(pos, sm.move()));
+			}
+			removeSampleTables();
+		}
+		report("Tablebase root filter", success);
+	}
+
+	// Test that the search probes after a capture into the tables and filters the root in table positions
+	void testTablebaseSearch() {
+		bool success = true;
+		writeSampleTables(true);
+		TranspositionTable tt;
+		tt.resize(16);
+		search::ThreadPool pool(tt);
+		pool.setSilent(true);
+		search::Limits limits;
+		limits.depth = 5;
+
+		// Taking the knight leads to a table win
+		Position pos;
+		pos.set("8/8/8/3k4/8/8/8/R1n1K3 w - - 0 1");
+		search::Result result = pool.think(pos, limits);
+		success &= (result.bestMove == uci::parseMove(pos, "a1c1") && result.tbHits > 0 && result.score > VALUE_MATE_IN_MAX_PLY - MAX_GAME_LENGTH);
+
+		pos.set("8/8/8/8/8/1k6/8/R3K3 w - - 3 1");
+		tt.clear();
+		result = pool.think(pos, limits);
+		success &= (result.tbHits > 0 && !rookIsAttacked(pos, result.bestMove));
+		for (const search::RootMove& rm : pool.main().rootMoves())
+			success &= !rookIsAttacked(pos, rm.pv[0]);
+
+		removeSampleTables();
+		report("Tablebases in search", success);
+	}
+
+	void runAllTablebasesTests() {
+		std::cout << "Running Tablebases tests...\n" << "\n";
+
+		testTablebaseProbes();
+		testTablebaseCompressed();
+		testTablebaseRealFiles();
+		testTablebaseRootFilter();
+		testTablebaseSearch();
+
+		std::cout << "\nTablebases tests completed." << "\n";
+	}
+}
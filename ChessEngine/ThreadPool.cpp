@@ -0,0 +1,166 @@
+#include "ThreadPool.h"
+#include <cassert>
+#include <thread>
+#include "Nnue.h"
+
+// ThreadPool.cpp - Lazy SMP: several searchers on one shared transposition table
+
+namespace chess::search {
+
+	ThreadPool::~ThreadPool() {
+		stopHelpers();
+	}
+
+	void ThreadPool::setThreadCount(const int count) {
+		assert(count >= 1);
+		stopHelpers();
+		m_searchers.clear();
+		for (int id = 0; id < count; ++id) {
+			m_searchers.push_back(std::make_unique<Searcher>(m_tt, *this, id));
+			m_searchers.back()->setSilent(m_silent || id > 0);
+			m_searchers.back()->setOutput(m_output);
+			m_searchers.back()->setParams(m_params);
+			m_searchers.back()->setEvalCache(m_evalCache.size() ? &m_evalCache : nullptr);
+		}
+		m_results.assign(m_searchers.size(), Result{});
+		for (size_t id = 1; id < m_searchers.size(); ++id)
+			m_helpers.emplace_back(&ThreadPool::helperLoop, this, id, m_generation);
+	}
+
+	void ThreadPool::stopHelpers() {
+		{
+			const std::scoped_lock lock(m_mutex);
+			m_quit = true;
+		}
+		m_startSearch.notify_all();
+		for (std::thread& helper : m_helpers)
+			helper.join();
+		m_helpers.clear();
+		m_quit = false;
+	}
+
+	// Waits for each new generation and searches it until the searcher is stopped
+	void ThreadPool::helperLoop(const size_t id, uint64_t generation) {
+		while (true) {
+			{
+				std::unique_lock lock(m_mutex);
+				m_startSearch.wait(lock, [&] { return m_quit || m_generation != generation; });
+				if (m_quit)
+					return;
+				generation = m_generation;
+			}
+			m_results[id] = m_searchers[id]->think(*m_rootPos, *m_limits);
+			{
+				const std::scoped_lock lock(m_mutex);
+				if (--m_running == 0)
+					m_helpersDone.notify_one();
+			}
+		}
+	}
+
+	void ThreadPool::resizeEvalCache(const size_t mb) {
+		m_evalCache.resize(mb);
+		for (const auto& searcher : m_searchers)
+			searcher->setEvalCache(mb ? &m_evalCache : nullptr);
+	}
+
+	EvalCacheCounters ThreadPool::evalCacheCounters() const noexcept {
+		EvalCacheCounters total;
+		for (const auto& searcher : m_searchers)
+			total.merge(searcher->evalCaches().evalCacheCounters);
+		return total;
+	}
+
+	void ThreadPool::setSilent(const bool silent) noexcept {
+		m_silent = silent;
+		main().setSilent(silent);
+	}
+
+	void ThreadPool::setOutput(std::function<void(const std::string&)> output) {
+		m_output = std::move(output);
+		for (const auto& searcher : m_searchers)
+			searcher->setOutput(m_output);
+	}
+
+	void ThreadPool::clearHistory() noexcept {
+		for (const auto& searcher : m_searchers)
+			searcher->clearHistory();
+	}
+
+	void ThreadPool::setParams(const Params& params) {
+		m_params = params;
+		for (const auto& searcher : m_searchers)
+			searcher->setParams(params);
+	}
+
+	Result ThreadPool::think(const Position& pos, const Limits& limits) {
+		// Reset all threads before any starts, so an early stop() is never lost and
+		// node limits never see counts of the previous search
+		for (const auto& searcher : m_searchers)
+			searcher->reset();
+		m_pondering.store(limits.ponder, std::memory_order_relaxed);
+		m_tt.newSearch();
+
+		// Threads share the states before the root and only read their accumulators
+		if (nnue::isLoaded())
+			nnue::updateAccumulator(pos);
+
+		{
+			const std::scoped_lock lock(m_mutex);
+			m_rootPos = &pos;
+			m_limits = &limits;
+			m_running = m_helpers.size();
+			++m_generation;
+		}
+		m_startSearch.notify_all();
+
+		m_results[0] = main().think(pos, limits);
+
+		// Helpers run until the main thread is done
+		stop();
+		{
+			std::unique_lock lock(m_mutex);
+			m_helpersDone.wait(lock, [this] { return m_running == 0; });
+		}
+
+		// Prefer a helper that completed a deeper iteration with a better score. The MultiPV lines
+		// reported are the main thread's, so its move is kept
+		Result best = m_results[0];
+		for (size_t i = 1; i < m_results.size() && limits.multiPV <= 1; ++i) {
+			const Result& r = m_results[i];
+			if (r.bestMove && r.depth > best.depth && r.score > best.score)
+				best = r;
+		}
+		best.nodes = nodes();
+		best.tbHits = tbHits();
+		return best;
+	}
+
+	void ThreadPool::stop() noexcept {
+		for (const auto& searcher : m_searchers)
+			searcher->stop();
+	}
+
+#ifdef SEARCH_STATS
+	SearchStats ThreadPool::stats() const {
+		SearchStats merged = m_searchers.front()->stats();
+		for (size_t i = 1; i < m_searchers.size(); ++i)
+			merged.merge(m_searchers[i]->stats());
+		return merged;
+	}
+#endif
+
+	uint64_t ThreadPool::nodes() const noexcept {
+		uint64_t total = 0;
+		for (const auto& searcher : m_searchers)
+			total += searcher->nodes();
+		return total;
+	}
+
+	uint64_t ThreadPool::tbHits() const noexcept {
+		uint64_t total = 0;
+		for (const auto& searcher : m_searchers)
+			total += searcher->tbHits();
+		return total;
+	}
+}
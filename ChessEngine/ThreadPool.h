@@ -0,0 +1,109 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "EvalCache.h"
+#include "Position.h"
+#include "Search.h"
+#include "TranspositionTable.h"
+
+// ThreadPool.h - Lazy SMP: several searchers on one shared transposition table
+
+namespace chess::search {
+
+	// Runs the same search on every thread. Threads only communicate through the shared
+	// transposition table; each owns its position copy, state stack, history and depth offsets.
+	// The helper threads live as long as their searchers and wait for the next search in between
+	class ThreadPool {
+	public:
+		explicit ThreadPool(TranspositionTable& tt) : m_tt(tt) {
+			m_evalCache.resize(DEFAULT_EVAL_CACHE_MB);
+			setThreadCount(1);
+		}
+		~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		// Recreates the searchers and their threads, must not be called while searching
+		void setThreadCount(int count);
+		[[nodiscard]] int threadCount() const noexcept { return static_cast<int>(m_searchers.size()); }
+
+		// Searches pos on all threads until the main thread finishes, returns the best thread's result
+		Result think(const Position& pos, const Limits& limits);
+
+		// Stops all threads (callable from any thread)
+		void stop() noexcept;
+
+		// Ends pondering: the time limit of the running search applies from now on (callable from any thread)
+		void ponderhit() noexcept { m_pondering.store(false, std::memory_order_relaxed); }
+		[[nodiscard]] bool pondering() const noexcept { return m_pondering.load(std::memory_order_relaxed); }
+
+		// Suppresses the main thread's "info" lines
+		void setSilent(bool silent) noexcept;
+
+		// Receives the main thread's "info" lines one whole line at a time; std::cout when empty.
+		// Must not be called while searching
+		void setOutput(std::function<void(const std::string&)> output);
+
+		// Forgets the move ordering history of all threads (e.g. for a new game)
+		void clearHistory() noexcept;
+
+		// Sets the selective search parameters of all threads
+		void setParams(const Params& params);
+
+		// Resizes and clears the static evaluation cache shared by the threads, zero disables it.
+		// Must not be called while searching
+		void resizeEvalCache(size_t mb);
+
+		// Forgets the cached evaluations, needed when the evaluation function changes
+		void clearEvalCache() noexcept { m_evalCache.clear(); }
+
+		// Evaluation cache probes and hits summed over all threads
+		[[nodiscard]] EvalCacheCounters evalCacheCounters() const noexcept;
+
+		// Nodes searched by all threads
+		[[nodiscard]] uint64_t nodes() const noexcept;
+
+		// Successful tablebase probes of all threads
+		[[nodiscard]] uint64_t tbHits() const noexcept;
+
+#ifdef SEARCH_STATS
+		// Counters of the last search merged over all threads, iterations are those of the main thread
+		[[nodiscard]] SearchStats stats() const;
+#endif
+
+		[[nodiscard]] Searcher& main() noexcept { return *m_searchers.front(); }
+
+		static constexpr size_t DEFAULT_EVAL_CACHE_MB = 4;
+
+	private:
+		void helperLoop(size_t id, uint64_t generation);
+		void stopHelpers();
+
+		TranspositionTable& m_tt;
+		EvalCache m_evalCache;
+		std::vector<std::unique_ptr<Searcher>> m_searchers;
+		bool m_silent = false;
+		std::function<void(const std::string&)> m_output;
+		Params m_params;
+		std::atomic<bool> m_pondering{ false };
+
+		// Helper i runs searcher i when the generation changes, the last to finish wakes think()
+		std::vector<std::thread> m_helpers;
+		std::mutex m_mutex;
+		std::condition_variable m_startSearch;
+		std::condition_variable m_helpersDone;
+		uint64_t m_generation = 0;
+		size_t m_running = 0;
+		bool m_quit = false;
+		const Position* m_rootPos = nullptr;
+		const Limits* m_limits = nullptr;
+		std::vector<Result> m_results;
+	};
+}
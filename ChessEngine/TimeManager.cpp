@@ -0,0 +1,76 @@
+#include "TimeManager.h"
+#include <algorithm>
+#include <cmath>
+#include "Search.h"
+
+// TimeManager.cpp - Time allocation for one move from the clock, adjusted as the search goes
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// The clock is indexed by the side to move
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+
+namespace chess::search {
+
+	namespace {
+		// Moves the remaining time is planned for when the clock does not say
+		constexpr int MOVE_HORIZON = 50;
+	}
+
+	void TimeManager::init(const Limits& limits, const Color us, const int gamePly) {
+		m_fromClock = false;
+		m_optimum = m_maximum = 0;
+		if (limits.moveTime) {
+			m_optimum = m_maximum = limits.moveTime;
+			return;
+		}
+		const int64_t time = limits.time[us];
+		if (time <= 0)
+			return;
+
+		// Time left for the planned moves, counting their increments and overheads. Early in the game a
+		// smaller share is used when the number of moves is unknown, the maximum grows with the game
+		const int64_t increment = limits.increment[us];
+		const int movesToGo = limits.movesToGo ? std::min(limits.movesToGo, MOVE_HORIZON) : MOVE_HORIZON;
+		const double timeLeft = static_cast<double>(std::max<int64_t>(1,
+			time + increment * (movesToGo - 1) - MOVE_OVERHEAD * (2 + movesToGo)));
+		const double ply = gamePly;
+
+		double optimumScale;
+		double maximumScale;
+		if (!limits.movesToGo) {
+			optimumScale = std::min(0.0084 + std::sqrt(ply + 3.0) * 0.0042, 0.2 * static_cast<double>(time) / timeLeft);
+			maximumScale = std::min(7.0, 4.0 + ply / 12.0);
+		}
+		else {
+			optimumScale = std::min((0.88 + ply / 116.4) / movesToGo, 0.88 * static_cast<double>(time) / timeLeft);
+			maximumScale = std::min(6.3, 1.5 + 0.11 * movesToGo);
+		}
+
+		m_fromClock = true;
+		m_optimum = std::max<int64_t>(1, static_cast<int64_t>(optimumScale * timeLeft));
+		m_maximum = std::max<int64_t>(1, static_cast<int64_t>(std::min(0.8 * static_cast<double>(time) - MOVE_OVERHEAD,
+			maximumScale * static_cast<double>(m_optimum))));
+		m_optimum = std::min(m_optimum, m_maximum);
+	}
+
+	double TimeManager::scale(const double bestMoveChanges, const double bestMoveNodes,
+		const Value previousMoveScore, const Value earlierIterationScore, const Value score) {
+		// More time while the best move keeps changing
+		const double instability = 1.0 + 1.7 * bestMoveChanges;
+
+		// More time when the score falls, against the last move and against a few iterations ago.
+		// Unknown scores count as unchanged
+		const Value previous = previousMoveScore != VALUE_NONE ? previousMoveScore : score;
+		const Value earlier = earlierIterationScore != VALUE_NONE ? earlierIterationScore : score;
+		const double fallingEval = std::clamp(1.0 + (2.0 * (previous - score) + (earlier - score)) / (4.0 * PawnValue), 0.75, 1.5);
+
+		// Less time when the best move takes nearly all the effort, as other moves are refuted quickly
+		const double effort = std::clamp(1.6 - std::clamp(bestMoveNodes, 0.0, 1.0), 0.6, 1.4);
+
+		return instability * fallingEval * effort;
+	}
+}
+#pragma warning(pop)
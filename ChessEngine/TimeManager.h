@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include "Types.h"
+
+// TimeManager.h - Time allocation for one move from the clock, adjusted as the search goes
+
+namespace chess::search {
+
+	struct Limits;
+
+	// The optimum time is what the move should take when the search is as stable as usual, the
+	// maximum is a hard limit. Between iterations the optimum is scaled by how stable the search
+	// looks; within them only the maximum is checked, every few thousand nodes
+	class TimeManager {
+	public:
+		// Budget for the side to move: a fixed move time, or an optimum and maximum from the clock.
+		// Without either the search is not timed
+		void init(const Limits& limits, Color us, int gamePly);
+
+		[[nodiscard]] bool timed() const noexcept { return m_maximum > 0; }
+
+		// Set from the clock rather than a fixed move time, so the optimum may be scaled
+		[[nodiscard]] bool fromClock() const noexcept { return m_fromClock; }
+
+		[[nodiscard]] int64_t optimum() const noexcept { return m_optimum; }
+		[[nodiscard]] int64_t maximum() const noexcept { return m_maximum; }
+
+		// Factor on the optimum after an iteration. bestMoveChanges decays by half every iteration,
+		// bestMoveNodes is the share of the nodes searched below the best move and the scores are
+		// those of the last move played, of a few iterations ago and of this iteration
+		[[nodiscard]] static double scale(double bestMoveChanges, double bestMoveNodes,
+			Value previousMoveScore, Value earlierIterationScore, Value score);
+
+		// Should the search stop after an iteration, with elapsed milliseconds since its start
+		[[nodiscard]] bool stopAfterIteration(const int64_t elapsed, const double factor) const {
+			return m_fromClock && static_cast<double>(elapsed) > static_cast<double>(m_optimum) * factor;
+		}
+
+		// Milliseconds kept back on every move for the communication with the GUI
+		static constexpr int64_t MOVE_OVERHEAD = 30;
+
+	private:
+		int64_t m_optimum = 0;
+		int64_t m_maximum = 0;
+		bool m_fromClock = false;
+	};
+}
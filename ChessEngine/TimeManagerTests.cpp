@@ -0,0 +1,92 @@
+#include "TimeManagerTests.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "Position.h"
+#include "Search.h"
+#include "TimeManager.h"
+#include "TranspositionTable.h"
+#include "Types.h"
+
+// TimeManagerTests.cpp - Tests for the time allocation from the clock and its scaling
+
+namespace chess::tests
+{
+	// Test the optimum and maximum times from the clock of the side to move
+	void testAllocation() {
+		search::TimeManager tm;
+		search::Limits limits;
+
+		tm.init(limits, WHITE, 0);
+		bool success = !tm.timed() && !tm.fromClock();
+
+		limits.moveTime = 500;
+		tm.init(limits, WHITE, 0);
+		success &= tm.timed() && !tm.fromClock() && tm.optimum() == 500 && tm.maximum() == 500;
+
+		// Sudden death: a small share of the time, the maximum well below the remaining time
+		limits.moveTime = 0;
+		limits.time = { 60000, 1000 };
+		tm.init(limits, WHITE, 20);
+		success &= tm.fromClock() && tm.optimum() > 0 && tm.optimum() < tm.maximum() && tm.maximum() < 60000 * 8 / 10;
+		const int64_t suddenDeath = tm.optimum();
+
+		// The clock of the side to move counts, with little time left the maximum stays inside it
+		tm.init(limits, BLACK, 21);
+		success &= tm.maximum() < 1000 - search::TimeManager::MOVE_OVERHEAD;
+
+		// An increment adds time, as do few moves to the time control
+		limits.increment = { 2000, 2000 };
+		tm.init(limits, WHITE, 20);
+		success &= tm.optimum() > suddenDeath;
+		limits.increment = {};
+		limits.movesToGo = 2;
+		tm.init(limits, WHITE, 20);
+		success &= tm.optimum() > suddenDeath && tm.maximum() < 60000;
+		report("Time allocation", success);
+	}
+
+	// Test that the optimum is scaled up by instability and falling scores and down by a clear best move
+	void testScaling() {
+		const double stable = search::TimeManager::scale(0.0, 0.5, 100, 100, 100);
+		bool success = search::TimeManager::scale(2.0, 0.5, 100, 100, 100) > stable;
+		success &= search::TimeManager::scale(0.0, 0.5, 300, 200, 100) > stable;
+		success &= search::TimeManager::scale(0.0, 0.5, 100, 100, 300) < stable;
+		success &= search::TimeManager::scale(0.0, 0.95, 100, 100, 100) < stable;
+		success &= search::TimeManager::scale(0.0, 0.5, VALUE_NONE, VALUE_NONE, 100) == stable;
+		report("Time scaling", success);
+	}
+
+	// Test that a search on the clock uses some of its time and never more than the maximum
+	void testClockSearch() {
+		Position pos;
+		pos.set(START_FEN);
+		TranspositionTable tt;
+		tt.resize(1);
+		const auto searcher = std::make_unique<search::Searcher>(tt);
+		searcher->setSilent(true);
+
+		search::Limits limits;
+		limits.time = { 3000, 3000 };
+		search::TimeManager tm;
+		tm.init(limits, WHITE, 0);
+
+		const auto start = std::chrono::steady_clock::now();
+		const search::Result result = searcher->think(pos, limits);
+		const int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+		report("Clock search within maximum", result.bestMove && result.depth > 1 && elapsed <= tm.maximum() + 50);
+	}
+
+	// Run all time manager tests
+	void runAllTimeManagerTests() {
+		std::cout << "Running time manager tests...\n" << "\n";
+
+		testAllocation();
+		testScaling();
+		testClockSearch();
+
+		std::cout << "\nTime manager tests completed." << "\n";
+	}
+}
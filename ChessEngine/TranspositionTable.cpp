@@ -0,0 +1,142 @@
+#include "TranspositionTable.h"
+#include <algorithm>
+#include <bit>
+#include <climits>
+
+// TranspositionTable.cpp - Lock-free clustered hash table of search results
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// Entry indices are below TTBucket::ENTRIES and bucket indices
+// are masked by the power of two table size
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+#pragma warning(disable: 26482)
+
+namespace chess {
+
+	namespace {
+		// Payload layout: move (bits 0-15), value (16-31), eval (32-47), depth (48-55), generation and bound (56-63)
+		constexpr uint64_t pack(const Move move, const Value value, const Value eval, const int depth8, const uint8_t genBound) {
+			return static_cast<uint64_t>(move.raw())
+				| static_cast<uint64_t>(static_cast<uint16_t>(value)) << 16
+				| static_cast<uint64_t>(static_cast<uint16_t>(eval)) << 32
+				| static_cast<uint64_t>(depth8) << 48
+				| static_cast<uint64_t>(genBound) << 56;
+		}
+
+		constexpr Move moveOf(const uint64_t data) { return Move(static_cast<uint16_t>(data)); }
+		constexpr Value valueOf(const uint64_t data) { return static_cast<int16_t>(data >> 16); }
+		constexpr Value evalOf(const uint64_t data) { return static_cast<int16_t>(data >> 32); }
+		constexpr int depth8Of(const uint64_t data) { return static_cast<uint8_t>(data >> 48); }
+		constexpr uint8_t genBoundOf(const uint64_t data) { return static_cast<uint8_t>(data >> 56); }
+
+		// Folds the payload into 16 bits for validating the key fragment
+		constexpr uint16_t fold(const uint64_t data) {
+			return static_cast<uint16_t>(data ^ (data >> 16) ^ (data >> 32) ^ (data >> 48));
+		}
+
+		// Upper key bits, the lower ones select the bucket
+		constexpr uint16_t keyFragment(const HashKey key) { return static_cast<uint16_t>(key >> 48); }
+
+		// Depth is stored with an offset so that zero marks an empty entry
+		constexpr int toDepth8(const int depth) { return depth - TranspositionTable::DEPTH_MIN + 1; }
+	}
+
+	void TranspositionTable::resize(const size_t mb) {
+		const size_t buckets = std::max<size_t>(mb * 1024 * 1024 / sizeof(TTBucket), 1);
+		m_bucketCount = std::bit_floor(buckets);
+		m_table = std::make_unique<TTBucket[]>(m_bucketCount);
+		clear();
+	}
+
+	void TranspositionTable::clear() noexcept {
+		for (size_t i = 0; i < m_bucketCount; ++i) {
+			for (int j = 0; j < TTBucket::ENTRIES; ++j) {
+				m_table[i].data[j].store(0, std::memory_order_relaxed);
+				m_table[i].key[j].store(0, std::memory_order_relaxed);
+			}
+		}
+		m_generation = 0;
+	}
+
+	bool TranspositionTable::probe(const HashKey key, TTData& data) const noexcept {
+		const TTBucket* b = bucket(key);
+		const uint16_t fragment = keyFragment(key);
+
+		for (int i = 0; i < TTBucket::ENTRIES; ++i) {
+			const uint64_t d = b->data[i].load(std::memory_order_relaxed);
+			const uint16_t k = b->key[i].load(std::memory_order_relaxed);
+			if (depth8Of(d) && (k ^ fold(d)) == fragment) {
+				data.move = moveOf(d);
+				data.value = valueOf(d);
+				data.eval = evalOf(d);
+				data.depth = depth8Of(d) + DEPTH_MIN - 1;
+				data.bound = static_cast<Bound>(genBoundOf(d) & ~GENERATION_MASK);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void TranspositionTable::store(const HashKey key, const Value value, const Bound bound, const int depth,
+		Move move, const Value eval) noexcept {
+		assert(depth >= DEPTH_MIN && toDepth8(depth) <= UINT8_MAX);
+		assert(std::abs(value) <= VALUE_NONE && std::abs(eval) <= VALUE_NONE);
+
+		TTBucket* b = bucket(key);
+		const uint16_t fragment = keyFragment(key);
+
+		// Take the entry of the same position or an empty one, else the shallowest and oldest
+		int replace = 0;
+		int worst = INT_MAX;
+		uint64_t old = 0;
+		bool samePosition = false;
+		for (int i = 0; i < TTBucket::ENTRIES; ++i) {
+			const uint64_t d = b->data[i].load(std::memory_order_relaxed);
+			const uint16_t k = b->key[i].load(std::memory_order_relaxed);
+			if (!depth8Of(d) || (k ^ fold(d)) == fragment) {
+				replace = i;
+				old = d;
+				samePosition = depth8Of(d) != 0;
+				break;
+			}
+
+			// Age in searches since the entry was written, each one weighs as much as eight plies of depth
+			const int age = static_cast<uint8_t>(m_generation - (genBoundOf(d) & GENERATION_MASK)) / GENERATION_DELTA;
+			const int worth = depth8Of(d) - 8 * age;
+			if (worth < worst) {
+				worst = worth;
+				replace = i;
+				old = d;
+			}
+		}
+
+		if (samePosition) {
+			// Keep the known best move and deeper results of this search unless the new value is exact
+			if (!move)
+				move = moveOf(old);
+			const bool sameSearch = (genBoundOf(old) & GENERATION_MASK) == m_generation;
+			if (bound != BOUND_EXACT && sameSearch && toDepth8(depth) + 4 <= depth8Of(old) && move == moveOf(old))
+				return;
+		}
+
+		const uint64_t d = pack(move, value, eval, toDepth8(depth), static_cast<uint8_t>(m_generation | bound));
+		b->data[replace].store(d, std::memory_order_relaxed);
+		b->key[replace].store(static_cast<uint16_t>(fragment ^ fold(d)), std::memory_order_relaxed);
+	}
+
+	int TranspositionTable::hashfull() const noexcept {
+		const size_t sample = std::min<size_t>(m_bucketCount, 1000);
+		int used = 0;
+		for (size_t i = 0; i < sample; ++i) {
+			for (int j = 0; j < TTBucket::ENTRIES; ++j) {
+				const uint64_t d = m_table[i].data[j].load(std::memory_order_relaxed);
+				used += depth8Of(d) && (genBoundOf(d) & GENERATION_MASK) == m_generation;
+			}
+		}
+		return sample ? static_cast<int>(used * 1000 / (sample * TTBucket::ENTRIES)) : 0;
+	}
+}
+#pragma warning(pop)
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "Move.h"
+#include "Types.h"
+
+#if defined(_M_X64) || defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+// TranspositionTable.h - Lock-free clustered hash table of search results
+
+namespace chess {
+
+	// Search result read from the table
+	struct TTData {
+		Move move = Move::none();
+		Value value = VALUE_NONE;
+		Value eval = VALUE_NONE;
+		int depth = 0;
+		Bound bound = BOUND_NONE;
+	};
+
+	// A bucket holds three entries and fills half a cache line. The 64-bit payload of an entry
+	// (move, value, eval, depth, bound and generation) and its 16-bit key fragment are written
+	// separately without locks; the stored key is XORed with a fold of the payload, so a payload
+	// and key from two racing writes fail validation instead of returning another position's data
+	struct alignas(32) TTBucket {
+		static constexpr int ENTRIES = 3;
+
+		std::atomic<uint64_t> data[ENTRIES];
+		std::atomic<uint16_t> key[ENTRIES];
+		uint16_t padding;
+	};
+	static_assert(sizeof(TTBucket) == 32);
+
+	class TranspositionTable {
+	public:
+		TranspositionTable() = default;
+		TranspositionTable(const TranspositionTable&) = delete;
+		TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+		// Allocates about mb megabytes, rounded down to a power of two number of buckets, and clears the table
+		void resize(size_t mb);
+		void clear() noexcept;
+
+		// Ages all entries, call once at the start of every search
+		void newSearch() noexcept { m_generation = static_cast<uint8_t>(m_generation + GENERATION_DELTA); }
+
+		// Looks up key, returns true and fills data on a hit
+		bool probe(HashKey key, TTData& data) const noexcept;
+
+		// Stores a search result, replacing the same position or the least valuable entry of the bucket
+		void store(HashKey key, Value value, Bound bound, int depth, Move move, Value eval) noexcept;
+
+		// Starts loading the bucket of key into the cache
+		void prefetch(const HashKey key) const noexcept {
+#if defined(_M_X64) || defined(__SSE__)
+			_mm_prefetch(reinterpret_cast<const char*>(bucket(key)), _MM_HINT_T0);
+#else
+			(void)key;
+#endif
+		}
+
+		// Permille of sampled entries written in the current search
+		[[nodiscard]] int hashfull() const noexcept;
+
+		[[nodiscard]] size_t bucketCount() const noexcept { return m_bucketCount; }
+
+		// Depths down to DEPTH_MIN can be stored
+		static constexpr int DEPTH_MIN = -6;
+
+	private:
+		// Low 2 bits of the generation byte hold the bound, the age counts in the upper 6 bits
+		static constexpr uint8_t GENERATION_DELTA = 1 << 2;
+		static constexpr uint8_t GENERATION_MASK = 0xFC;
+
+		[[nodiscard]] TTBucket* bucket(const HashKey key) const noexcept {
+			assert(m_bucketCount);
+			return &m_table[key & (m_bucketCount - 1)];
+		}
+
+		std::unique_ptr<TTBucket[]> m_table;
+		size_t m_bucketCount = 0;
+		uint8_t m_generation = 0;
+	};
+}
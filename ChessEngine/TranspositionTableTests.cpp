@@ -0,0 +1,152 @@
+#include "TranspositionTableTests.h"
+#include <atomic>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "BitBoard.h"
+#include "MoveGen.h"
+#include "Position.h"
+#include "TranspositionTable.h"
+#include "Types.h"
+
+// TranspositionTableTests.cpp - Tests for the transposition table
+
+namespace chess::tests
+{
+	// Test that stored data is read back unchanged
+	void testStoreProbe() {
+		TranspositionTable tt;
+		tt.resize(1);
+		const HashKey key = 0x123456789ABCDEF0ULL;
+		TTData data;
+		bool success = !tt.probe(key, data);
+
+		tt.store(key, -VALUE_MATE + 5, BOUND_LOWER, 7, Move(E2, E4), -321);
+		success &= tt.probe(key, data);
+		success &= data.move == Move(E2, E4) && data.value == -VALUE_MATE + 5 && data.eval == -321
+			&& data.depth == 7 && data.bound == BOUND_LOWER;
+
+		// Lowest storable depth and no move
+		tt.store(key + 1, VALUE_NONE, BOUND_UPPER, TranspositionTable::DEPTH_MIN, Move::none(), VALUE_NONE);
+		success &= tt.probe(key + 1, data) && data.depth == TranspositionTable::DEPTH_MIN && !data.move
+			&& data.value == VALUE_NONE && data.eval == VALUE_NONE;
+
+		// Same bucket, different key fragment
+		success &= !tt.probe(key ^ (1ULL << 60), data);
+
+		tt.clear();
+		success &= !tt.probe(key, data);
+		report("TT store and probe", success);
+	}
+
+	// Test the replacement policy within one bucket
+	void testReplacement() {
+		TranspositionTable tt;
+		tt.resize(1);
+		const auto sameBucket = [](const int i) { return 0x42ULL | (static_cast<HashKey>(i + 1) << 48); };
+		TTData data;
+
+		// A shallow store of the same position keeps the deeper result and its move
+		tt.store(sameBucket(0), 100, BOUND_LOWER, 10, Move(G1, F3), 0);
+		tt.store(sameBucket(0), 50, BOUND_UPPER, 2, Move::none(), 0);
+		bool success = tt.probe(sameBucket(0), data) && data.depth == 10 && data.value == 100;
+
+		// An exact result always replaces, keeping the move when none is given
+		tt.store(sameBucket(0), 60, BOUND_EXACT, 2, Move::none(), 0);
+		success &= tt.probe(sameBucket(0), data) && data.bound == BOUND_EXACT && data.move == Move(G1, F3);
+
+		// A full bucket drops its shallowest entry, now the depth 2 one
+		tt.store(sameBucket(1), 0, BOUND_EXACT, 5, Move::none(), 0);
+		tt.store(sameBucket(2), 0, BOUND_EXACT, 8, Move::none(), 0);
+		tt.store(sameBucket(3), 0, BOUND_EXACT, 9, Move::none(), 0);
+		success &= tt.probe(sameBucket(1), data) && tt.probe(sameBucket(2), data) && tt.probe(sameBucket(3), data);
+		success &= !tt.probe(sameBucket(0), data);
+
+		// Entries of older searches are replaced before deeper ones of this search
+		for (int i = 0; i < 3; ++i)
+			tt.newSearch();
+		tt.store(sameBucket(4), 0, BOUND_EXACT, 1, Move::none(), 0);
+		tt.store(sameBucket(5), 0, BOUND_EXACT, 1, Move::none(), 0);
+		success &= tt.probe(sameBucket(4), data) && tt.probe(sameBucket(5), data);
+		report("TT replacement", success);
+	}
+
+	// Test that racing writers never produce data of another position
+	void testConcurrentWrites() {
+		TranspositionTable tt;
+		tt.resize(1);
+
+		// Every field is derived from the key, so a torn entry is detectable
+		const auto valueFor = [](const HashKey key) { return static_cast<Value>(key % 20000) - 10000; };
+		const auto depthFor = [](const HashKey key) { return static_cast<int>((key >> 20) % 60); };
+
+		std::atomic<int> mismatches{ 0 };
+		std::atomic<int> hits{ 0 };
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; ++t) {
+			threads.emplace_back([&, t] {
+				std::mt19937_64 rng(t);
+				for (int i = 0; i < 200000; ++i) {
+					// Few keys over 64 buckets to force collisions between the threads, key fragments are unique
+					const HashKey r = rng() % 4096;
+					const HashKey key = (r << 48) | (r & 63);
+					TTData data;
+					if (tt.probe(key, data)) {
+						hits.fetch_add(1, std::memory_order_relaxed);
+						if (data.value != valueFor(key) || data.eval != -valueFor(key) || data.depth != depthFor(key))
+							mismatches.fetch_add(1, std::memory_order_relaxed);
+					}
+					tt.store(key, valueFor(key), BOUND_EXACT, depthFor(key), Move::none(), -valueFor(key));
+				}
+			});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+		report("TT concurrent writes", hits > 0 && mismatches == 0);
+	}
+
+	// Test the approximate key after a move and the fill rate
+	void testKeyAfterAndHashfull() {
+		Position pos;
+		pos.set("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w - - 0 1");
+		MoveList moves;
+		generate<LEGAL>(pos, moves);
+		bool success = true;
+		for (const ScoredMove& sm : moves) {
+			const Move m = sm.move();
+			// Special moves and new en passant squares are not predicted
+			if (m.moveType() != NORMAL || (typeOf(pos.movedPiece(m)) == PAWN && distance<Rank>(m.fromSq(), m.toSq()) == 2))
+				continue;
+			StateInfo st;
+			const HashKey predicted = pos.keyAfter(m);
+			pos.doMove(m, st);
+			success &= predicted == pos.key();
+			pos.undoMove(m);
+		}
+
+		TranspositionTable tt;
+		tt.resize(1);
+		success &= tt.hashfull() == 0;
+		for (HashKey i = 0; i < tt.bucketCount() * 3; ++i)
+			tt.store(i * 0x9E3779B97F4A7C15ULL, 0, BOUND_EXACT, 1, Move::none(), 0);
+		success &= tt.hashfull() > 500;
+		tt.newSearch();
+		success &= tt.hashfull() == 0;
+		report("TT key after move and hashfull", success);
+	}
+
+	// Run all transposition table tests
+	void runAllTranspositionTableTests() {
+		std::cout << "Running transposition table tests...\n" << "\n";
+
+		testStoreProbe();
+		testReplacement();
+		testConcurrentWrites();
+		testKeyAfterAndHashfull();
+
+		std::cout << "\nTransposition table tests completed." << "\n";
+	}
+}
@@ -2,6 +2,9 @@
 #include <iostream>
 #include <cstdint>
 #include <cassert>
+#include <array>
+#include <filesystem>
+#include <string>
 
 // Types.h - Core types and constants for the chess engine
 
@@ -128,6 +131,14 @@ namespace chess {
 		CASTLING_RIGHT_NB = 16
 	};
 
+	// Kind of bound a stored search value represents
+	enum Bound : uint8_t {
+		BOUND_NONE,
+		BOUND_UPPER,                              // Value fails low, the true value is at most this
+		BOUND_LOWER,                              // Value fails high, the true value is at least this
+		BOUND_EXACT = BOUND_UPPER | BOUND_LOWER   // Exact value from a PV node
+	};
+
 	// Constants
 	constexpr int MAX_MOVES = 256;         // Maximum number of moves in a position
 	constexpr int MAX_GAME_LENGTH = 246;  // Maximum number of half-moves in a game
@@ -142,6 +153,11 @@ namespace chess {
 	constexpr Value QueenValue = 2538;
 	// We don't need a specific value for the king in material counting
 
+	// Material values indexed by piece type
+	constexpr std::array<Value, PIECE_TYPE_NB> PieceValues = {
+		0, PawnValue, KnightValue, BishopValue, RookValue, QueenValue, 0, 0
+	};
+
 	// Special evaluation values
 	constexpr Value VALUE_ZERO = 0;
 	constexpr Value VALUE_DRAW = 0;
@@ -151,6 +167,36 @@ namespace chess {
 	constexpr Value VALUE_MATE_IN_MAX_PLY = VALUE_MATE - MAX_GAME_LENGTH;
 	constexpr Value VALUE_MATED_IN_MAX_PLY = -VALUE_MATE_IN_MAX_PLY;
 
+	// Mate scores relative to the search root
+	constexpr Value mateIn(const int ply) { return VALUE_MATE - ply; }
+	constexpr Value matedIn(const int ply) { return -VALUE_MATE + ply; }
+
+	// Game phase, from all pieces on the board down to pawns and kings only
+	constexpr int PHASE_ENDGAME = 0;
+	constexpr int PHASE_MIDGAME = 128;
+
+	// Midgame and endgame values packed into one integer, the endgame value in the upper 16 bits
+	enum Score : int { SCORE_ZERO };
+
+	constexpr Score makeScore(const int mg, const int eg) {
+		return static_cast<Score>(static_cast<int>(static_cast<unsigned int>(eg) << 16) + mg);
+	}
+
+	// A negative midgame value borrows one from the endgame half, rounding before the shift gives it back
+	constexpr Value egValue(const Score s) {
+		return static_cast<int16_t>(static_cast<uint16_t>(static_cast<unsigned int>(s + 0x8000) >> 16));
+	}
+	constexpr Value mgValue(const Score s) {
+		return static_cast<int16_t>(static_cast<uint16_t>(static_cast<unsigned int>(s)));
+	}
+
+	constexpr Score operator+(const Score a, const Score b) { return static_cast<Score>(static_cast<int>(a) + static_cast<int>(b)); }
+	constexpr Score operator-(const Score a, const Score b) { return static_cast<Score>(static_cast<int>(a) - static_cast<int>(b)); }
+	constexpr Score operator-(const Score s) { return static_cast<Score>(-static_cast<int>(s)); }
+	constexpr Score operator*(const Score s, const int i) { return static_cast<Score>(static_cast<int>(s) * i); }
+	constexpr Score& operator+=(Score& a, const Score b) { return a = a + b; }
+	constexpr Score& operator-=(Score& a, const Score b) { return a = a - b; }
+
 	// Utility functions
 	constexpr bool isSquare(const Square s) { return s >= SQUARE_ZERO && s < NO_SQUARE;}
 	constexpr File fileOf(const Square sq) { assert(isSquare(sq)); return static_cast<File>(sq & 7); }
@@ -159,11 +205,22 @@ namespace chess {
 	constexpr PieceType typeOf(const Piece piece) {return static_cast<PieceType>(piece & 7);}
 	constexpr Color colorOf(const Piece piece) {assert(piece != NO_PIECE); return static_cast<Color>(piece >> 3);
 	}
+	constexpr Piece makePiece(const Color c, const PieceType pt) { return static_cast<Piece>((c << 3) | pt); }
+	constexpr Color operator~(const Color c) { return static_cast<Color>(c ^ BLACK); }
+	constexpr Rank relativeRank(const Color c, const Rank r) { return static_cast<Rank>(r ^ (c * 7)); }
+	constexpr Rank relativeRank(const Color c, const Square sq) { return relativeRank(c, rankOf(sq)); }
+	constexpr Square relativeSquare(const Color c, const Square sq) { return static_cast<Square>(sq ^ (c * 56)); }
+	constexpr Square flipRank(const Square sq) { return static_cast<Square>(sq ^ A8); }
+	constexpr Square flipFile(const Square sq) { return static_cast<Square>(sq ^ H1); }
+	constexpr Direction pawnPush(const Color c) { return c == WHITE ? NORTH : SOUTH; }
 
 	// Operator overload
 	inline Square operator+(const Square sq,const Direction dir) noexcept{
 		return static_cast<Square>(static_cast<int>(sq) + static_cast<int>(dir));
 	}
+	inline Square operator-(const Square sq, const Direction dir) noexcept {
+		return static_cast<Square>(static_cast<int>(sq) - static_cast<int>(dir));
+	}
 
 	// Operator overloads for enum types
 	template<typename T>
@@ -189,4 +246,9 @@ namespace chess {
 	inline void report(const std::string& testName, bool success) {
 		std::cout << (success ? "PASS: " : "FAIL: ") << testName << "\n";
 	}
+
+	// Path of a scratch file for tests in the system's temporary directory
+	inline std::string tempPath(const std::string& name) {
+		return (std::filesystem::temp_directory_path() / name).string();
+	}
 }
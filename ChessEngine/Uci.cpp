@@ -0,0 +1,101 @@
+#include "Uci.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include "MoveGen.h"
+
+// Uci.cpp - Universal Chess Interface protocol support
+
+//---------------------------------------------------------------
+// Performance: Disable array bounds checking warnings (26446)
+// The move index is addressed with 12-bit from-to keys, which
+// always fit the 4096 entry tables
+//---------------------------------------------------------------
+#pragma warning(push)
+#pragma warning(disable: 26446)
+#pragma warning(disable: 26482)
+
+namespace chess::uci {
+
+	void LegalMoveIndex::build(const Position& pos) {
+		// On wrap-around old stamps could match again, so start over from a clean table
+		if (++m_generation == 0) {
+			m_stamps.fill(0);
+			m_generation = 1;
+		}
+
+		MoveList moves;
+		generate<LEGAL>(pos, moves);
+		for (const ScoredMove& sm : moves) {
+			const Move m = sm.move();
+			m_moves[m.fromToSq()] = m.raw();
+			m_stamps[m.fromToSq()] = m_generation;
+		}
+	}
+
+	Move LegalMoveIndex::find(const Square from, const Square to, const PieceType promotion) const {
+		const int key = Move(from, to).fromToSq();
+		if (m_stamps[key] != m_generation)
+			return Move::none();
+
+		const Move m(m_moves[key]);
+		if (m.moveType() == PROMOTION) {
+			// All four promotions share the key, rebuild the requested one
+			return promotion >= KNIGHT && promotion <= QUEEN ? Move(from, to, PROMOTION, promotion) : Move::none();
+		}
+		return promotion == NO_PIECE_TYPE ? m : Move::none();
+	}
+
+	char* formatScore(const Value v, char* buffer) noexcept {
+		constexpr std::string_view cp = "cp ";
+		constexpr std::string_view mate = "mate ";
+		char* out = buffer;
+
+		// Mate scores are reported in moves, negative when we are getting mated
+		if (std::abs(v) >= VALUE_MATE_IN_MAX_PLY) {
+			out = std::copy(mate.begin(), mate.end(), out);
+			const int moves = v > 0 ? (VALUE_MATE - v + 1) / 2 : -(VALUE_MATE + v) / 2;
+			out = std::to_chars(out, out + 8, moves).ptr;
+		}
+		else {
+			out = std::copy(cp.begin(), cp.end(), out);
+			out = std::to_chars(out, out + 8, toCentipawns(v)).ptr;
+		}
+		*out = '\0';
+		return out;
+	}
+
+	Move parseMove(const Position& pos, const std::string_view str) {
+		if (str.size() != 4 && str.size() != 5)
+			return Move::none();
+
+		// Decode squares without building strings
+		const auto squareAt = [str](const size_t i) {
+			const int file = str[i] - 'a';
+			const int rank = str[i + 1] - '1';
+			return file >= 0 && file < 8 && rank >= 0 && rank < 8
+				? makeSquare(static_cast<File>(file), static_cast<Rank>(rank)) : NO_SQUARE;
+			};
+		const Square from = squareAt(0);
+		const Square to = squareAt(2);
+		if (from == NO_SQUARE || to == NO_SQUARE)
+			return Move::none();
+
+		PieceType promotion = NO_PIECE_TYPE;
+		if (str.size() == 5) {
+			switch (str[4]) {
+			case 'n': case 'N': promotion = KNIGHT; break;
+			case 'b': case 'B': promotion = BISHOP; break;
+			case 'r': case 'R': promotion = ROOK; break;
+			case 'q': case 'Q': promotion = QUEEN; break;
+			default: return Move::none();
+			}
+		}
+
+		// One index per thread, reused across calls so parsing long move lists never allocates
+		thread_local LegalMoveIndex index;
+		index.build(pos);
+		return index.find(from, to, promotion);
+	}
+}
+#pragma warning(pop)
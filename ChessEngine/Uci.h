@@ -0,0 +1,39 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include "Move.h"
+#include "Position.h"
+
+// Uci.h - Universal Chess Interface protocol support
+
+namespace chess::uci {
+
+	// Direct-address table of a position's legal moves keyed by Move::fromToSq().
+	// The 12-bit from-to key is a perfect hash: only promotions share a key and they differ by the piece.
+	// Generation stamps make rebuilding for the next position O(moves) instead of clearing the table
+	class LegalMoveIndex {
+	public:
+		// Index the legal moves of pos, invalidating the previous position's entries
+		void build(const Position& pos);
+
+		// Returns the legal move from-to with the given promotion piece (NO_PIECE_TYPE for none),
+		// or Move::none() if there is no such legal move
+		[[nodiscard]] Move find(Square from, Square to, PieceType promotion) const;
+
+	private:
+		std::array<uint16_t, 64 * 64> m_moves{};
+		std::array<uint16_t, 64 * 64> m_stamps{};
+		uint16_t m_generation = 0;
+	};
+
+	// Converts an internal score to centipawns (a pawn is worth PawnValue internally)
+	constexpr int toCentipawns(const Value v) { return v * 100 / PawnValue; }
+
+	// Writes a score as "cp <x>" or "mate <moves>" into buffer (at least 16 chars), returns the terminator
+	char* formatScore(Value v, char* buffer) noexcept;
+
+	// Parses a move in UCI notation ("e2e4", "e7e8q", "e1g1") against the legal moves of pos.
+	// Returns Move::none() for malformed or illegal moves, never allocates
+	Move parseMove(const Position& pos, std::string_view str);
+}
@@ -0,0 +1,283 @@
+#include "UciEngine.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include "Nnue.h"
+#include "Tablebases.h"
+#include "Uci.h"
+
+// UciEngine.cpp - UCI command loop, searching on its own thread while input is read
+
+namespace chess::uci {
+
+	namespace {
+		// Monotonic clock in microseconds, 0 stands for no time
+		int64_t nowMicroseconds() {
+			return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() + 1;
+		}
+
+		std::string formatMove(const Move m) {
+			char buffer[Move::MAX_STRING_LENGTH];
+			m.format(buffer);
+			return buffer;
+		}
+	}
+
+	Engine::Engine(std::ostream& out) : m_out(out), m_pool(m_tt) {
+		m_tt.resize(DEFAULT_HASH_MB);
+		m_pos.set(START_FEN);
+		m_pool.setOutput([this](const std::string& line) { write(line); });
+	}
+
+	Engine::~Engine() {
+		stop();
+		waitForSearch();
+	}
+
+	void Engine::loop(std::istream& in) {
+		std::string line;
+		while (std::getline(in, line))
+			if (!command(line))
+				break;
+		stop();
+		waitForSearch();
+	}
+
+	bool Engine::command(const std::string& line) {
+		std::istringstream args(line);
+		std::string token;
+		args >> token;
+
+		// Answered at once, whether a search is running or not
+		if (token == "stop")
+			stop();
+		else if (token == "ponderhit")
+			ponderhit();
+		else if (token == "isready")
+			write("readyok");
+		else if (token == "quit")
+			return false;
+		else if (token == "uci")
+			uci();
+
+		// The rest changes what the search works on, so the running search ends first
+		else if (token == "ucinewgame") {
+			stop();
+			waitForSearch();
+			m_tt.clear();
+			m_pool.clearHistory();
+		}
+		else if (token == "setoption") {
+			stop();
+			waitForSearch();
+			setOption(args);
+		}
+		else if (token == "position") {
+			stop();
+			waitForSearch();
+			setPosition(args);
+		}
+		else if (token == "go") {
+			stop();
+			waitForSearch();
+			go(args);
+		}
+		else if (token == "d")
+			write(m_pos.fen());
+		else if (!token.empty())
+			write("info string unknown command " + token);
+		return true;
+	}
+
+	void Engine::uci() {
+		write("id name ChessEngine\nid author Adve1s\n"
+			"option name Threads type spin default 1 min 1 max " + std::to_string(MAX_THREADS) + "\n"
+			"option name Hash type spin default " + std::to_string(DEFAULT_HASH_MB) + " min 1 max " + std::to_string(MAX_HASH_MB) + "\n"
+			"option name Ponder type check default false\n"
+			"option name MultiPV type spin default 1 min 1 max " + std::to_string(MAX_MULTI_PV) + "\n"
+			"option name SyzygyPath type string default <empty>\n"
+			"option name EvalFile type string default <empty>\n"
+			"uciok");
+	}
+
+	// "setoption name <id> [value <x>]", names may contain spaces
+	void Engine::setOption(std::istream& args) {
+		std::string token;
+		std::string name;
+		std::string value;
+		args >> token;
+		while (args >> token && token != "value")
+			name += (name.empty() ? "" : " ") + token;
+		while (args >> token)
+			value += (value.empty() ? "" : " ") + token;
+		std::transform(name.begin(), name.end(), name.begin(), [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+		try {
+			if (name == "threads")
+				m_pool.setThreadCount(std::clamp(std::stoi(value), 1, MAX_THREADS));
+			else if (name == "hash")
+				m_tt.resize(std::clamp<size_t>(std::stoull(value), 1, MAX_HASH_MB));
+			else if (name == "multipv")
+				m_multiPV = std::clamp(std::stoi(value), 1, MAX_MULTI_PV);
+			else if (name == "syzygypath") {
+				tablebases::init(value == "<empty>" ? "" : value);
+				write("info string found tablebases up to " + std::to_string(tablebases::maxCardinality()) + " pieces");
+			}
+			else if (name == "evalfile")
+				setEvalFile(value);
+			else if (name != "ponder")
+				write("info string unknown option " + name);
+		}
+		catch (const std::exception&) {
+			write("info string invalid value " + value + " for option " + name);
+		}
+	}
+
+	// Loads the network weights of path, or returns to the hand-crafted evaluation for "<empty>". A file
+	// that does not load keeps the current evaluation. Cached evaluations of the old one are dropped
+	void Engine::setEvalFile(const std::string& path) {
+		if (path == "<empty>" || path.empty()) {
+			nnue::unload();
+			write("info string using the hand-crafted evaluation");
+		}
+		else if (nnue::load(path))
+			write("info string loaded network " + path);
+		else {
+			write("info string cannot load network " + path);
+			return;
+		}
+		m_tt.clear();
+		m_pool.clearEvalCache();
+	}
+
+	// "position startpos|fen <fen> [moves <move>...]", an illegal move ends the list
+	void Engine::setPosition(std::istream& args) {
+		std::string token;
+		std::string fen;
+		args >> token;
+		if (token == "startpos") {
+			fen = START_FEN;
+			args >> token;
+		}
+		else if (token == "fen")
+			while (args >> token && token != "moves")
+				fen += token + " ";
+		else
+			return;
+
+		m_states.clear();
+		m_pos.set(fen);
+		while (args >> token) {
+			const Move m = parseMove(m_pos, token);
+			if (!m) {
+				write("info string illegal move " + token);
+				break;
+			}
+			m_pos.doMove(m, m_states.emplace_back());
+		}
+	}
+
+	void Engine::go(std::istream& args) {
+		search::Limits limits;
+		limits.multiPV = m_multiPV;
+		bool infinite = false;
+		std::string token;
+		while (args >> token) {
+			if (token == "wtime") args >> limits.time[WHITE];
+			else if (token == "btime") args >> limits.time[BLACK];
+			else if (token == "winc") args >> limits.increment[WHITE];
+			else if (token == "binc") args >> limits.increment[BLACK];
+			else if (token == "movestogo") args >> limits.movesToGo;
+			else if (token == "depth") args >> limits.depth;
+			else if (token == "nodes") args >> limits.nodes;
+			else if (token == "movetime") args >> limits.moveTime;
+			else if (token == "infinite") infinite = true;
+			else if (token == "ponder") limits.ponder = true;
+		}
+
+		// The search's time manager allocates the time from the clock, an infinite search ignores it
+		if (infinite) {
+			limits.moveTime = 0;
+			limits.time = {};
+		}
+
+		{
+			const std::scoped_lock lock(m_mutex);
+			m_infinite = infinite;
+			m_holdBestMove = infinite || limits.ponder;
+		}
+		m_stopReceived.store(0, std::memory_order_relaxed);
+		m_searching.store(true, std::memory_order_relaxed);
+		m_searchThread = std::thread(&Engine::searchThread, this, limits);
+	}
+
+	void Engine::searchThread(const search::Limits limits) {
+		const search::Result result = m_pool.think(m_pos, limits);
+		m_searching.store(false, std::memory_order_relaxed);
+
+		// A search that ends on its own while pondering or in infinite mode waits for the GUI
+		{
+			std::unique_lock lock(m_mutex);
+			m_bestMoveAllowed.wait(lock, [this] { return !m_holdBestMove; });
+		}
+
+		std::string line;
+		const int64_t stopReceived = m_stopReceived.load(std::memory_order_relaxed);
+		if (stopReceived) {
+			const int64_t latency = nowMicroseconds() - stopReceived;
+			{
+				const std::scoped_lock lock(m_mutex);
+				++m_stopLatency.count;
+				m_stopLatency.totalMicroseconds += latency;
+				m_stopLatency.maxMicroseconds = std::max(m_stopLatency.maxMicroseconds, latency);
+			}
+			line = "info string stop latency " + std::to_string(latency) + " us\n";
+		}
+		line += "bestmove " + formatMove(result.bestMove);
+		if (result.ponderMove)
+			line += " ponder " + formatMove(result.ponderMove);
+		write(line);
+	}
+
+	void Engine::stop() {
+		if (!m_searchThread.joinable())
+			return;
+
+		// Only a search that is still running measures the latency
+		int64_t expected = 0;
+		if (m_searching.load(std::memory_order_relaxed))
+			m_stopReceived.compare_exchange_strong(expected, nowMicroseconds(), std::memory_order_relaxed);
+		m_pool.stop();
+		{
+			const std::scoped_lock lock(m_mutex);
+			m_holdBestMove = false;
+		}
+		m_bestMoveAllowed.notify_one();
+	}
+
+	// The search goes on under its normal limits; one that already finished may report now
+	void Engine::ponderhit() {
+		m_pool.ponderhit();
+		{
+			const std::scoped_lock lock(m_mutex);
+			m_holdBestMove = m_infinite;
+		}
+		m_bestMoveAllowed.notify_one();
+	}
+
+	void Engine::waitForSearch() {
+		if (m_searchThread.joinable())
+			m_searchThread.join();
+	}
+
+	StopLatency Engine::stopLatency() const {
+		const std::scoped_lock lock(m_mutex);
+		return m_stopLatency;
+	}
+
+	// Whole lines in one write, so lines of the two threads never mix
+	void Engine::write(const std::string& line) {
+		const std::scoped_lock lock(m_outMutex);
+		m_out << line << std::endl;
+	}
+}
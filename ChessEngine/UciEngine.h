@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Position.h"
+#include "Search.h"
+#include "ThreadPool.h"
+#include "TranspositionTable.h"
+
+// UciEngine.h - UCI command loop, searching on its own thread while input is read
+
+namespace chess::uci {
+
+	// Time from receiving "stop" to writing "bestmove", over all stopped searches
+	struct StopLatency {
+		uint64_t count = 0;
+		int64_t totalMicroseconds = 0;
+		int64_t maxMicroseconds = 0;
+
+		[[nodiscard]] double averageMicroseconds() const {
+			return count ? static_cast<double>(totalMicroseconds) / static_cast<double>(count) : 0.0;
+		}
+	};
+
+	// The thread calling loop() only reads commands, so "stop", "ponderhit" and "isready" are answered
+	// while a search runs on the search thread. Commands that change the position or the options
+	// stop the running search and wait for its "bestmove" first
+	class Engine {
+	public:
+		explicit Engine(std::ostream& out = std::cout);
+		~Engine();
+		Engine(const Engine&) = delete;
+		Engine& operator=(const Engine&) = delete;
+
+		// Executes commands until "quit" or the end of the input
+		void loop(std::istream& in);
+
+		// Executes one command line, returns false for "quit"
+		bool command(const std::string& line);
+
+		// Blocks until the running search, if any, has written its "bestmove"
+		void waitForSearch();
+
+		[[nodiscard]] search::ThreadPool& pool() noexcept { return m_pool; }
+		[[nodiscard]] const Position& position() const noexcept { return m_pos; }
+		[[nodiscard]] StopLatency stopLatency() const;
+
+		static constexpr size_t DEFAULT_HASH_MB = 16;
+		static constexpr int MAX_THREADS = 1024;
+		static constexpr size_t MAX_HASH_MB = 1 << 20;
+		static constexpr int MAX_MULTI_PV = 256;
+
+	private:
+		void uci();
+		void setOption(std::istream& args);
+		void setEvalFile(const std::string& path);
+		void setPosition(std::istream& args);
+		void go(std::istream& args);
+		void stop();
+		void ponderhit();
+		void searchThread(search::Limits limits);
+		void write(const std::string& line);
+
+		std::ostream& m_out;
+		std::mutex m_outMutex;
+
+		TranspositionTable m_tt;
+		search::ThreadPool m_pool;
+		Position m_pos;
+		std::deque<StateInfo> m_states;  // States of the moves after the position's FEN
+		int m_multiPV = 1;
+
+		// "bestmove" is held back while pondering or in infinite mode until "stop" or "ponderhit"
+		std::thread m_searchThread;
+		mutable std::mutex m_mutex;
+		std::condition_variable m_bestMoveAllowed;
+		bool m_holdBestMove = false;
+		bool m_infinite = false;
+
+		// Time "stop" was received, read by the search thread when it writes "bestmove"
+		std::atomic<bool> m_searching{ false };
+		std::atomic<int64_t> m_stopReceived{ 0 };
+		StopLatency m_stopLatency;
+	};
+}
@@ -0,0 +1,194 @@
+#include "UciTests.h"
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "MoveGen.h"
+#include "Nnue.h"
+#include "Position.h"
+#include "Types.h"
+#include "Uci.h"
+#include "UciEngine.h"
+
+// UciTests.cpp - Tests for UCI move formatting and parsing and the command loop
+
+namespace chess::tests
+{
+	// Test that every legal move survives a format/parse round trip
+	void testMoveRoundTrip() {
+		bool success = true;
+		for (const std::string& fen : { std::string(START_FEN),
+			std::string("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+			std::string("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"),
+			std::string("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3") }) {
+			Position pos;
+			pos.set(fen);
+			MoveList moves;
+			generate<LEGAL>(pos, moves);
+			for (const ScoredMove& sm : moves) {
+				char buffer[Move::MAX_STRING_LENGTH];
+				sm.move().format(buffer);
+				success &= uci::parseMove(pos, buffer) == sm.move();
+			}
+		}
+		report("UCI move round trip", success);
+	}
+
+	// Test UCI specific formatting
+	void testMoveFormatting() {
+		char buffer[Move::MAX_STRING_LENGTH];
+		bool success = std::string(buffer, Move(E1, G1, CASTLING).format(buffer)) == "e1g1";
+		success &= std::string(buffer, Move(E8, C8, CASTLING).format(buffer)) == "e8c8";
+		success &= std::string(buffer, Move(B2, A1, PROMOTION, KNIGHT).format(buffer)) == "b2a1n";
+		success &= std::string(buffer, Move::null().format(buffer)) == "0000";
+		report("UCI move formatting", success);
+	}
+
+	// Test that malformed and illegal moves are rejected
+	void testParseRejects() {
+		Position pos;
+		pos.set("4k3/1P6/8/8/8/8/8/4K3 w - - 0 1");
+		bool success = !uci::parseMove(pos, "e2e4");   // No piece there
+		success &= !uci::parseMove(pos, "b7b8");       // Promotion without piece
+		success &= !uci::parseMove(pos, "b7b8k");      // Invalid promotion piece
+		success &= !uci::parseMove(pos, "e1e2q");      // Promotion piece on a normal move
+		success &= !uci::parseMove(pos, "e1e3");       // Not a legal king move
+		success &= !uci::parseMove(pos, "i1a1");       // Off the board
+		success &= !uci::parseMove(pos, "");
+		success &= uci::parseMove(pos, "b7b8Q") == Move(B7, B8, PROMOTION, QUEEN);
+		success &= uci::parseMove(pos, "e1e2") == Move(E1, E2);
+
+		// In check only evasions are accepted
+		pos.set("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+		success &= uci::parseMove(pos, "c4c5") == Move(C4, C5) && !uci::parseMove(pos, "a4b3");
+		report("UCI move parsing rejects invalid moves", success);
+	}
+
+	// Test replaying a move history as sent by "position startpos moves ..."
+	void testMoveHistory() {
+		Position pos;
+		pos.set(START_FEN);
+		std::deque<StateInfo> states;
+		std::istringstream moves("e2e4 e7e5 g1f3 b8c6 f1c4 g8f6 e1g1 f8c5 c2c3 e8g8 d2d4 e5d4 c3d4 c5b4");
+		std::string token;
+		bool success = true;
+		while (moves >> token) {
+			const Move m = uci::parseMove(pos, token);
+			success &= static_cast<bool>(m);
+			if (!m)
+				break;
+			pos.doMove(m, states.emplace_back());
+		}
+		success &= pos.fen() == "r1bq1rk1/pppp1ppp/2n2n2/8/1bBPP3/5N2/PP3PPP/RNBQ1RK1 w - - 1 8";
+		report("UCI move history replay", success);
+	}
+
+	// Test position setup, options and a search to a fixed depth through commands
+	void testEngineCommands() {
+		bool success = true;
+		std::istringstream in(
+			"uci\n"
+			"setoption name Threads value 2\n"
+			"setoption name Hash value 8\n"
+			"position startpos moves e2e4 e7e5 g1f3\n"
+			"isready\n"
+			"go depth 4\n"
+			"quit\n"
+			"go depth 4\n");
+		std::ostringstream out;
+		uci::Engine engine(out);
+		engine.loop(in);
+
+		const std::string output = out.str();
+		success &= output.find("uciok") != std::string::npos && output.find("readyok") != std::string::npos;
+
+		// The search's "info" lines go to the engine's output as whole lines
+		std::istringstream lines(output);
+		for (std::string line; std::getline(lines, line);) {
+			const auto startsWith = [&line](const std::string& prefix) { return line.rfind(prefix, 0) == 0; };
+			success &= startsWith("id ") || startsWith("option ") || line == "uciok" || line == "readyok"
+				|| startsWith("info ") || startsWith("bestmove ");
+		}
+		success &= engine.pool().threadCount() == 2;
+		success &= engine.position().fen() == "rnbqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 2";
+
+		// The search started before "quit" finishes, the one after it never starts
+		const size_t first = output.find("bestmove ");
+		success &= first != std::string::npos && output.find("bestmove ", first + 1) == std::string::npos;
+
+		// A search left to finish reports its last iteration
+		out.str("");
+		engine.command("go depth 3");
+		engine.waitForSearch();
+		success &= out.str().find("info depth 3 ") != std::string::npos;
+		report("UCI commands", success);
+	}
+
+	// Test that infinite and ponder searches hold their result back and answer "isready" while searching
+	void testEngineStopAndPonder() {
+		bool success = true;
+		std::ostringstream out;
+		uci::Engine engine(out);
+		engine.pool().setSilent(true);
+
+		engine.command("position fen r1bq1rk1/ppp1nppp/4n3/3p3Q/3P4/1BP1B3/PP1N2PP/R4RK1 w - - 1 16");
+		engine.command("go infinite");
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		engine.command("isready");
+		success &= out.str() == "readyok\n";
+		engine.command("stop");
+		engine.waitForSearch();
+		success &= out.str().find("bestmove ") != std::string::npos;
+		const uci::StopLatency latency = engine.stopLatency();
+		success &= latency.count == 1 && latency.maxMicroseconds < 1000000;
+
+		// A ponder search keeps going past its time until "ponderhit", then stops at its time
+		out.str("");
+		engine.command("go ponder movetime 20");
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		success &= out.str().empty();
+		engine.command("ponderhit");
+		engine.waitForSearch();
+		success &= out.str().find("bestmove ") != std::string::npos;
+		report("UCI stop and ponderhit", success);
+	}
+
+	// Test that the EvalFile option loads a network, keeps it when a file does not load and drops it for <empty>
+	void testEngineEvalFile() {
+		const std::string path = tempPath("chess_uci_test.nnue");
+		nnue::randomize(1);
+		bool success = nnue::save(path);
+		nnue::unload();
+
+		std::ostringstream out;
+		uci::Engine engine(out);
+		engine.command("setoption name EvalFile value " + path);
+		success &= nnue::isLoaded() && out.str() == "info string loaded network " + path + "\n";
+		out.str("");
+		engine.command("setoption name EvalFile value " + tempPath("chess_uci_missing.nnue"));
+		success &= nnue::isLoaded() && out.str().rfind("info string cannot load network ", 0) == 0;
+		engine.command("setoption name EvalFile value <empty>");
+		success &= !nnue::isLoaded();
+
+		std::remove(path.c_str());
+		report("UCI EvalFile option", success);
+	}
+
+	// Run all UCI tests
+	void runAllUciTests() {
+		std::cout << "Running UCI tests...\n" << "\n";
+
+		testMoveRoundTrip();
+		testMoveFormatting();
+		testParseRejects();
+		testMoveHistory();
+		testEngineCommands();
+		testEngineStopAndPonder();
+		testEngineEvalFile();
+
+		std::cout << "\nUCI tests completed." << "\n";
+	}
+}